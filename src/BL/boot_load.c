@@ -0,0 +1,253 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * boot_load.c — Linus Neural Project
+ *
+ * Carga de imagem com descompressão LZ4 incremental (boot_load.h).
+ *
+ * No caminho paralelo cada bloco LZ4 vira um item da fila de boot_smp;
+ * o núcleo de boot enfileira à frente, ajuda a decodificar e soma o
+ * checksum de conteúdo bloco a bloco, na ordem, à medida que ficam
+ * prontos, de modo que o XXH32 (serial) se sobrepõe à descompressão.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include <string.h>
+
+#include "boot_load.h"
+#include "boot_smp.h"
+#include "lz4_boot.h"
+
+/* Buffer de transferência da fonte; a imagem em si nunca passa por ele inteira */
+static uint8_t boot_chunk[BOOT_LOAD_CHUNK] __attribute__((aligned(64)));
+
+/* Um bloco em decodificação; done é publicado por quem o executou */
+struct lz4_job {
+    const struct lz4b_frame *frame;
+    const uint8_t *blk;
+    size_t blk_len;
+    uint8_t *out;
+    size_t cap;
+    size_t out_size;
+    int ret;
+    uint32_t done;
+};
+
+static struct lz4_job lz4_jobs[BOOT_WORK_MAX];
+
+/* Bloco menor que blk_max antes do último: a saída não está onde deveria */
+#define LZ4_SHORT_BLOCK 1
+
+struct mem_source {
+    const uint8_t *p, *end;
+};
+
+/* Lê até encher len ou acabar a fonte */
+static long boot_read_full(const struct boot_source *src, uint8_t *buf, size_t len)
+{
+    size_t got = 0;
+
+    while (got < len) {
+        long n = src->read(src->ctx, buf + got, len - got);
+
+        if (n < 0)
+            return BOOT_LOAD_ERR_READ;
+        if (!n)
+            break;
+        got += n;
+    }
+    return got;
+}
+
+static int boot_load_lz4(const struct boot_source *src, uint8_t *dst, size_t max,
+                         size_t have, unsigned flags, struct boot_image *img)
+{
+    struct lz4b_stream s;
+    long n = have;
+    int ret;
+
+    lz4b_init(&s, dst, max);
+    for (;;) {
+        ret = lz4b_feed(&s, boot_chunk, n, NULL);
+        if (ret != LZ4B_MORE)
+            break;
+        n = boot_read_full(src, boot_chunk, sizeof(boot_chunk));
+        if (n < 0)
+            return n;
+        if (!n)
+            return LZ4B_ERR_CORRUPT;    /* fonte acabou no meio do quadro */
+        img->stored += n;
+    }
+    if (ret != LZ4B_DONE)
+        return ret;
+
+    img->size = lz4b_output_size(&s);
+    img->compressed = 1;
+    img->verified = lz4b_has_content_checksum(&s);
+    if ((flags & BOOT_LOAD_VERIFY) && !img->verified)
+        return BOOT_LOAD_ERR_UNVERIFIED;
+    return 0;
+}
+
+int boot_load_image(const struct boot_source *src, void *load_addr, size_t max,
+                    unsigned flags, struct boot_image *img)
+{
+    uint8_t *dst = load_addr;
+    long n;
+
+    memset(img, 0, sizeof(*img));
+    n = boot_read_full(src, boot_chunk, sizeof(boot_chunk));
+    if (n < 0)
+        return n;
+    if (!n)
+        return BOOT_LOAD_ERR_EMPTY;
+    img->stored = n;
+
+    if (flags & BOOT_LOAD_LZ4) {
+        if (n < 4 || (boot_chunk[0] | boot_chunk[1] << 8 | boot_chunk[2] << 16 |
+                      (uint32_t)boot_chunk[3] << 24) != LZ4B_MAGIC)
+            return LZ4B_ERR_MAGIC;
+        return boot_load_lz4(src, dst, max, n, flags, img);
+    }
+
+    /* imagem crua: o resto é lido direto no destino */
+    if ((size_t)n > max)
+        return LZ4B_ERR_OVERFLOW;
+    memcpy(dst, boot_chunk, n);
+    img->size = n;
+    for (;;) {
+        if (img->size == max) {
+            uint8_t probe;
+
+            n = boot_read_full(src, &probe, 1);
+            if (n < 0)
+                return n;
+            if (n)
+                return LZ4B_ERR_OVERFLOW;
+            break;
+        }
+        n = boot_read_full(src, dst + img->size, max - img->size);
+        if (n < 0)
+            return n;
+        if (!n)
+            break;
+        img->size += n;
+        img->stored += n;
+    }
+    return 0;
+}
+
+static long mem_source_read(void *ctx, void *buf, size_t len)
+{
+    struct mem_source *m = ctx;
+    size_t n = (size_t)(m->end - m->p) < len ? (size_t)(m->end - m->p) : len;
+
+    memcpy(buf, m->p, n);
+    m->p += n;
+    return n;
+}
+
+static void lz4_job_run(void *arg)
+{
+    struct lz4_job *j = arg;
+
+    j->ret = lz4b_decode_block(j->frame, j->blk, j->blk_len, j->out, j->cap, &j->out_size);
+    __atomic_store_n(&j->done, 1, __ATOMIC_RELEASE);
+}
+
+static int boot_load_lz4_parallel(const struct lz4b_frame *f, struct boot_image *img)
+{
+    const uint8_t *blk = f->first;
+    uint32_t queued = 0, finished = 0;
+    struct lz4b_xxh32 hash;
+    int ret = 0;
+
+    lz4b_xxh32_reset(&hash, 0);
+    while (finished < queued || (blk && !ret)) {
+        struct lz4_job *j;
+
+        /* enfileira à frente enquanto há job livre; em erro só drena */
+        while (blk && !ret && queued - finished < BOOT_WORK_MAX) {
+            size_t off = (size_t)queued * f->blk_max;
+
+            j = &lz4_jobs[queued % BOOT_WORK_MAX];
+            j->frame = f;
+            j->blk = blk;
+            blk = lz4b_frame_next(f, blk, &j->blk_len);
+            j->out = f->dst + (off < f->dst_size ? off : f->dst_size);
+            j->cap = off < f->dst_size ? f->dst_size - off : 0;
+            if (j->cap > f->blk_max)
+                j->cap = f->blk_max;
+            j->done = 0;
+            boot_work_queue(lz4_job_run, j);
+            queued++;
+        }
+
+        /* o próximo na ordem: confere e soma ao checksum de conteúdo */
+        j = &lz4_jobs[finished % BOOT_WORK_MAX];
+        if (!__atomic_load_n(&j->done, __ATOMIC_ACQUIRE)) {
+            boot_work_poll();
+            continue;
+        }
+        if (!ret) {
+            if (j->ret)
+                ret = j->ret;
+            else if (j->out_size != f->blk_max && finished + 1 < f->nblocks)
+                ret = LZ4_SHORT_BLOCK;
+            else if (lz4b_frame_has_content_checksum(f))
+                lz4b_xxh32_update(&hash, j->out, j->out_size);
+            img->size += j->out_size;
+        }
+        finished++;
+    }
+    if (ret)
+        return ret;
+
+    if (f->content_size && f->content_size != img->size)
+        return LZ4B_ERR_CORRUPT;
+    if (lz4b_frame_has_content_checksum(f) && lz4b_xxh32_digest(&hash) != f->content_csum)
+        return LZ4B_ERR_CHECKSUM;
+    img->verified = lz4b_frame_has_content_checksum(f);
+    return 0;
+}
+
+int boot_load_image_mem(const void *data, size_t len, void *load_addr, size_t max,
+                        unsigned flags, struct boot_image *img)
+{
+    struct mem_source mem = { data, (const uint8_t *)data + len };
+    struct boot_source src = { mem_source_read, &mem };
+    struct lz4b_frame f;
+    int ret;
+
+    if ((flags & BOOT_LOAD_LZ4) && boot_smp_cpus() > 1 &&
+        lz4b_frame_open(&f, data, len, load_addr, max) == 0 &&
+        lz4b_frame_independent(&f) && f.nblocks > 1) {
+        memset(img, 0, sizeof(*img));
+        if ((flags & BOOT_LOAD_VERIFY) && !lz4b_frame_has_content_checksum(&f))
+            return BOOT_LOAD_ERR_UNVERIFIED;
+        img->stored = f.end - (const uint8_t *)data;
+        img->compressed = 1;
+        ret = boot_load_lz4_parallel(&f, img);
+        if (ret != LZ4_SHORT_BLOCK)
+            return ret;
+        /* compressor que não enche os blocos: refaz em série */
+    }
+    return boot_load_image(&src, load_addr, max, flags, img);
+}
+
+const char *boot_load_strerror(int err)
+{
+    switch (err) {
+    case 0:                     return "ok";
+    case LZ4B_ERR_MAGIC:        return "assinatura LZ4 inválida";
+    case LZ4B_ERR_HEADER:       return "cabeçalho LZ4 inválido";
+    case LZ4B_ERR_UNSUPPORTED:  return "dicionário LZ4 não suportado";
+    case LZ4B_ERR_CORRUPT:      return "imagem corrompida ou truncada";
+    case LZ4B_ERR_OVERFLOW:     return "imagem maior que a área de carga";
+    case LZ4B_ERR_CHECKSUM:     return "checksum não confere";
+    case BOOT_LOAD_ERR_READ:    return "erro de leitura";
+    case BOOT_LOAD_ERR_EMPTY:   return "fonte vazia";
+    case BOOT_LOAD_ERR_UNVERIFIED: return "LZ4 sem checksum de conteúdo";
+    default:                    return "erro desconhecido";
+    }
+}
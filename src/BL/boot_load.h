@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * boot_load.h — Linus Neural Project
+ *
+ * Carga da imagem do kernel a partir de uma fonte sequencial (flash, SD,
+ * imagem embutida). Quem chama diz o formato: com BOOT_LOAD_LZ4 a fonte
+ * tem de ser um LZ4-frame, descomprimido enquanto chega, direto no
+ * endereço de carga (lz4_boot.h); sem ele a imagem é copiada crua. O
+ * formato nunca é adivinhado pelos primeiros bytes: um bit trocado na
+ * assinatura daria um kernel cru sem verificação.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef BOOT_LOAD_H
+#define BOOT_LOAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Tamanho de cada leitura da fonte: um setor grande / uma transferência DMA */
+#define BOOT_LOAD_CHUNK 4096
+
+struct boot_source {
+    /* Lê até len bytes; retorna quantos leu, 0 no fim ou < 0 em erro */
+    long (*read)(void *ctx, void *buf, size_t len);
+    void *ctx;
+};
+
+struct boot_image {
+    size_t size;            /* bytes escritos no endereço de carga */
+    size_t stored;          /* bytes lidos da fonte */
+    int compressed;
+    int verified;           /* checksum de conteúdo conferido */
+};
+
+/* flags */
+#define BOOT_LOAD_LZ4       0x1     /* LZ4-frame; outra assinatura é LZ4B_ERR_MAGIC */
+#define BOOT_LOAD_VERIFY    0x2     /* com BOOT_LOAD_LZ4: exige checksum de conteúdo */
+
+/* 0 ou um LZ4B_ERR_* (lz4_boot.h); -7 erro de leitura, -8 fonte vazia, -9 sem checksum */
+#define BOOT_LOAD_ERR_READ       -7
+#define BOOT_LOAD_ERR_EMPTY      -8
+#define BOOT_LOAD_ERR_UNVERIFIED -9
+
+int boot_load_image(const struct boot_source *src, void *load_addr, size_t max,
+                    unsigned flags, struct boot_image *img);
+/*
+ * Imagem já inteira em memória (embutida, ou lida antes). LZ4-frame com
+ * blocos independentes é descomprimido em paralelo na fila de
+ * boot_smp.h; os demais casos vão por boot_load_image.
+ */
+int boot_load_image_mem(const void *data, size_t len, void *load_addr, size_t max,
+                        unsigned flags, struct boot_image *img);
+const char *boot_load_strerror(int err);
+
+#endif /* BOOT_LOAD_H */
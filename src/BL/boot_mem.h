@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * boot_mem.h — Linus Neural Project
+ *
+ * Zeragem e cópia rápidas do bootloader (boot_mem.S). Seguras com a MMU
+ * desligada, mas só usam DC ZVA e cópia por linha de cache com ela ligada.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef BOOT_MEM_H
+#define BOOT_MEM_H
+
+#include <stddef.h>
+
+void *bl_memzero(void *dst, size_t len);
+void *bl_memcpy(void *dst, const void *src, size_t len);
+
+#endif /* BOOT_MEM_H */
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * boot_mmu.h — Linus Neural Project
+ *
+ * Mapa identidade e caches do bootloader (boot_mmu.S). _start liga a MMU
+ * antes de zerar a .bss e de entrar no C, com a RAM de BOOT_RAM_BASE em
+ * blocos de 2 MB Normal write-back e o resto dos primeiros 4 GiB como
+ * Device-nGnRnE sem execução (MMIO). Incluído também por bootloader.S.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef BOOT_MMU_H
+#define BOOT_MMU_H
+
+/* RAM da máquina virt do QEMU; vão para boot_info.memory_base/memory_size */
+#define BOOT_RAM_BASE       0x40000000
+#define BOOT_RAM_SIZE       (512 * 1024 * 1024)
+
+/* Uma tabela de nível 2 por GiB de RAM mapeado */
+#define BOOT_MMU_L2_TABLES  4
+
+#ifndef __ASSEMBLER__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Nada faz se a MMU já está ligada (firmware que entrega com o mapa dele) */
+void bl_mmu_enable(uint64_t ram_base, uint64_t ram_size);
+/* Liga a MMU com as tabelas que bl_mmu_enable já montou (núcleos secundários) */
+void bl_mmu_on(void);
+/* Limpa [addr, addr+len) até o PoC e invalida a I-cache: código recém-escrito */
+void bl_cache_sync(const void *addr, size_t len);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* BOOT_MMU_H */
@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * boot_smp.c — Linus Neural Project
+ *
+ * Partida dos núcleos secundários e fila de trabalho (boot_smp.h).
+ *
+ * A fila é um anel de BOOT_WORK_MAX entradas com três contadores que só
+ * crescem: tail (escrito pelo produtor), head (próximo a pegar, avançado
+ * por CAS) e done (itens terminados). Quem pega copia a entrada antes do
+ * CAS; o produtor só reescreve uma entrada quando tail - head < BOOT_WORK_MAX,
+ * então uma cópia validada pelo CAS nunca é de uma entrada reescrita.
+ * Fora do ARM64 (harness no host) os secundários são threads que chamam
+ * boot_smp_secondary_main.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include <string.h>
+
+#include "boot_mem.h"
+#include "boot_smp.h"
+#include "boot_trace.h"
+
+#define PSCI_CPU_OFF            0x84000002U
+#define PSCI_CPU_ON             0xC4000003U
+#define PSCI_AFFINITY_INFO      0xC4000004U
+#define PSCI_RET_INVALID_PARAMS (-2)
+#define PSCI_AFF_OFF            1
+#define MPIDR_AFF_MASK          0xff00ffffffUL
+#define SMP_CHECKIN_US          100000  /* tempo para os secundários aparecerem */
+#define ZERO_MIN_CHUNK          (256 * 1024)
+
+struct boot_work {
+    boot_work_fn fn;
+    void *arg;
+};
+
+struct zero_range {
+    uint8_t *dst;
+    size_t len;
+};
+
+static struct boot_work work_ring[BOOT_WORK_MAX];
+static uint32_t work_head, work_tail, work_done;
+static uint32_t smp_online = 1, smp_stop;
+static struct zero_range zero_ranges[BOOT_WORK_MAX];
+
+#if defined(__aarch64__)
+static uint64_t smp_mpidr[BOOT_SMP_MAX_CPUS];     /* índice lógico -> MPIDR */
+static unsigned smp_started = 1;                  /* núcleos aceitos por CPU_ON, com o de boot */
+
+extern char _secondary_start[];
+long boot_psci_call(uint64_t fn, uint64_t a1, uint64_t a2, uint64_t a3);
+#endif
+
+static inline void cpu_wait(void)
+{
+#if defined(__aarch64__)
+    __asm__ volatile("wfe" : : : "memory");
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static inline void cpu_wake(void)
+{
+#if defined(__aarch64__)
+    /* a escrita precisa estar visível antes do evento */
+    __asm__ volatile("dsb ish; sev" : : : "memory");
+#endif
+}
+
+/* Pega e executa um item; 0 se a fila estava vazia */
+static int work_run_one(void)
+{
+    uint32_t head = __atomic_load_n(&work_head, __ATOMIC_ACQUIRE);
+
+    for (;;) {
+        uint32_t tail = __atomic_load_n(&work_tail, __ATOMIC_ACQUIRE);
+        struct boot_work w;
+
+        if (head == tail)
+            return 0;
+        w = work_ring[head % BOOT_WORK_MAX];
+        if (__atomic_compare_exchange_n(&work_head, &head, head + 1, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            w.fn(w.arg);
+            __atomic_fetch_add(&work_done, 1, __ATOMIC_RELEASE);
+            cpu_wake();
+            return 1;
+        }
+    }
+}
+
+int boot_work_queue(boot_work_fn fn, void *arg)
+{
+    uint32_t tail = work_tail;
+
+    if (tail - __atomic_load_n(&work_head, __ATOMIC_ACQUIRE) >= BOOT_WORK_MAX)
+        return -1;
+    work_ring[tail % BOOT_WORK_MAX].fn = fn;
+    work_ring[tail % BOOT_WORK_MAX].arg = arg;
+    __atomic_store_n(&work_tail, tail + 1, __ATOMIC_RELEASE);
+    cpu_wake();
+    return 0;
+}
+
+void boot_work_poll(void)
+{
+    if (!work_run_one())
+        cpu_wait();
+}
+
+void boot_work_wait(void)
+{
+    while (__atomic_load_n(&work_done, __ATOMIC_ACQUIRE) != work_tail)
+        boot_work_poll();
+}
+
+void boot_smp_secondary_main(unsigned cpu)
+{
+    (void)cpu;
+    __atomic_fetch_add(&smp_online, 1, __ATOMIC_RELEASE);
+    cpu_wake();
+    while (!__atomic_load_n(&smp_stop, __ATOMIC_ACQUIRE))
+        boot_work_poll();
+    __atomic_fetch_sub(&smp_online, 1, __ATOMIC_RELEASE);
+#if defined(__aarch64__)
+    boot_psci_call(PSCI_CPU_OFF, 0, 0, 0);
+#endif
+}
+
+unsigned boot_smp_cpus(void)
+{
+    return __atomic_load_n(&smp_online, __ATOMIC_ACQUIRE);
+}
+
+unsigned boot_smp_init(void)
+{
+#if defined(__aarch64__)
+    uint64_t self, freq, t0;
+    unsigned aff0, idx = 1;
+
+    __asm__ volatile("mrs %0, mpidr_el1" : "=r"(self));
+    self &= MPIDR_AFF_MASK;
+
+    /* QEMU virt e a maioria dos SoCs: os núcleos do cluster em Aff0 = 0, 1, 2... */
+    for (aff0 = 0; aff0 < 256 && idx < BOOT_SMP_MAX_CPUS; aff0++) {
+        uint64_t mpidr = (self & ~0xffUL) | aff0;
+        long ret;
+
+        if (mpidr == self)
+            continue;
+        ret = boot_psci_call(PSCI_CPU_ON, mpidr, (uint64_t)_secondary_start, idx);
+        if (ret == PSCI_RET_INVALID_PARAMS)
+            break;                      /* não existe: acabou o cluster */
+        if (!ret)
+            smp_mpidr[idx++] = mpidr;
+    }
+    smp_started = idx;
+
+    /* sem WFE aqui: um núcleo que não sobe nunca mandaria o SEV */
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+    t0 = boot_ticks();
+    while (boot_smp_cpus() < idx && boot_ticks() - t0 < freq / 1000000 * SMP_CHECKIN_US)
+        ;
+#endif
+    return boot_smp_cpus();
+}
+
+void boot_smp_shutdown(void)
+{
+    boot_work_wait();
+    __atomic_store_n(&smp_stop, 1, __ATOMIC_RELEASE);
+    cpu_wake();
+#if defined(__aarch64__)
+    {
+        uint64_t freq, t0;
+        unsigned i;
+
+        /* CPU_ON do kernel falha com ALREADY_ON enquanto o núcleo não está OFF */
+        __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+        t0 = boot_ticks();
+        /* pela contagem: MPIDR 0 é um secundário válido quando o de boot não tem Aff0 = 0 */
+        for (i = 1; i < smp_started; i++)
+            while (boot_psci_call(PSCI_AFFINITY_INFO, smp_mpidr[i], 0, 0) != PSCI_AFF_OFF &&
+                   boot_ticks() - t0 < freq / 1000000 * SMP_CHECKIN_US)
+                ;
+    }
+#endif
+}
+
+static void zero_range_run(void *arg)
+{
+    struct zero_range *r = arg;
+
+#if defined(__aarch64__)
+    bl_memzero(r->dst, r->len);
+#else
+    memset(r->dst, 0, r->len);     /* harness no host: boot_mem.S é só ARM64 */
+#endif
+}
+
+void boot_smp_memzero(void *dst, size_t len)
+{
+    unsigned cpus = boot_smp_cpus(), n, i;
+    size_t chunk, off = 0;
+
+    /* algumas fatias por núcleo para equilibrar; múltiplos de 64 bytes (DC ZVA) */
+    n = cpus > 1 ? cpus * 4 : 1;
+    if (n > BOOT_WORK_MAX)
+        n = BOOT_WORK_MAX;
+    chunk = ((len + n - 1) / n + 63) & ~(size_t)63;
+    if (chunk < ZERO_MIN_CHUNK)
+        chunk = ZERO_MIN_CHUNK;
+
+    boot_work_wait();
+    for (i = 0; off < len; i++) {
+        zero_ranges[i].dst = (uint8_t *)dst + off;
+        zero_ranges[i].len = len - off < chunk ? len - off : chunk;
+        off += zero_ranges[i].len;
+        boot_work_queue(zero_range_run, &zero_ranges[i]);
+    }
+    boot_work_wait();
+}
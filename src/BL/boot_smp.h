@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * boot_smp.h — Linus Neural Project
+ *
+ * Núcleos secundários no bootloader. boot_smp_init liga os outros núcleos
+ * via PSCI CPU_ON; cada um entra por _secondary_start (boot_smp.S) com
+ * pilha própria, liga a MMU com as tabelas do núcleo de boot e fica num
+ * laço consumindo uma fila de trabalho pequena.
+ *
+ * A fila tem um único produtor, o núcleo de boot, que também executa
+ * itens enquanto espera (boot_work_poll, boot_work_wait). Sem PSCI, ou
+ * com um núcleo só, tudo roda no núcleo de boot pelo mesmo caminho.
+ * Em boot_smp_init o PSCI é chamado por HVC (QEMU virt sem firmware);
+ * compile com -DBOOT_PSCI_SMC quando um firmware em EL3 atende por SMC.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef BOOT_SMP_H
+#define BOOT_SMP_H
+
+#define BOOT_SMP_MAX_CPUS   8           /* arm64_cpu_info.cores */
+#define BOOT_SMP_STACK_SIZE 16384
+#define BOOT_WORK_MAX       64
+
+#ifndef __ASSEMBLER__
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef void (*boot_work_fn)(void *arg);
+
+/* Liga os secundários e espera que entrem no laço; retorna os núcleos ativos */
+unsigned boot_smp_init(void);
+unsigned boot_smp_cpus(void);
+/* Laço dos secundários, chamado de _secondary_start; sai só por boot_smp_shutdown */
+void boot_smp_secondary_main(unsigned cpu);
+/*
+ * Antes de entregar ao kernel: termina a fila e desliga os secundários
+ * (PSCI CPU_OFF), para que o kernel possa ligá-los de novo com CPU_ON
+ */
+void boot_smp_shutdown(void);
+
+/* 0, ou -1 com a fila cheia (BOOT_WORK_MAX itens não iniciados) */
+int boot_work_queue(boot_work_fn fn, void *arg);
+/* Executa um item pendente, ou espera um evento se não há nenhum */
+void boot_work_poll(void);
+/* Executa itens até que todos os enfileirados tenham terminado */
+void boot_work_wait(void);
+
+/* Zera len bytes em dst repartido entre os núcleos, bl_memzero em cada fatia */
+void boot_smp_memzero(void *dst, size_t len);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* BOOT_SMP_H */
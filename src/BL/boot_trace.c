@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * boot_trace.c — Linus Neural Project
+ *
+ * Marcas de estágio do boot e relatório de durações (boot_trace.h).
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include "boot_trace.h"
+
+#define PROJECT_TAG "Linus Neural Project"
+
+static uint64_t boot_ticks_freq(void)
+{
+#if defined(__aarch64__)
+    uint64_t f;
+
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(f));
+    return f;
+#elif defined(__x86_64__) || defined(__i386__)
+    unsigned int den, num, crystal, unused;
+
+    /* folha 0x15: TSC = cristal * num / den; nem toda CPU (ou VM) informa o cristal */
+    if (__get_cpuid_max(0, NULL) < 0x15)
+        return 0;
+    __cpuid(0x15, den, num, crystal, unused);
+    (void)unused;
+    if (!den || !num || !crystal)
+        return 0;
+    return (uint64_t)crystal * num / den;
+#else
+    return 0;
+#endif
+}
+
+/* start_ticks vem de _start (bootloader.S); 0 usa o instante atual */
+void boot_trace_init(struct boot_trace *t, uint64_t start_ticks)
+{
+    memset(t, 0, sizeof(*t));
+    t->freq_hz = boot_ticks_freq();
+    t->stage[0].name = "_start";
+    t->stage[0].ticks = start_ticks ? start_ticks : boot_ticks();
+    t->count = 1;
+}
+
+void boot_trace_mark(struct boot_trace *t, const char *name)
+{
+    uint64_t now = boot_ticks();
+
+    if (t->count >= BOOT_TRACE_MAX) {
+        t->dropped++;
+        return;
+    }
+    t->stage[t->count].name = name;
+    t->stage[t->count].ticks = now;
+    t->count++;
+}
+
+static void boot_trace_print(const char *name, uint64_t ticks, uint64_t freq)
+{
+    if (freq)
+        printf("[%s]   %-16s %10llu ciclos %10llu us\n", PROJECT_TAG, name,
+               (unsigned long long)ticks, (unsigned long long)(ticks * 1000000 / freq));
+    else
+        printf("[%s]   %-16s %10llu ciclos\n", PROJECT_TAG, name, (unsigned long long)ticks);
+}
+
+/* Cada estágio dura até a marca seguinte; o último, até esta chamada */
+void boot_trace_report(const struct boot_trace *t)
+{
+    uint64_t now = boot_ticks();
+    uint32_t i;
+
+    printf("[%s] Estágios do boot (contador a %llu Hz):\n", PROJECT_TAG,
+           (unsigned long long)t->freq_hz);
+    for (i = 0; i < t->count; i++) {
+        uint64_t end = i + 1 < t->count ? t->stage[i + 1].ticks : now;
+
+        boot_trace_print(t->stage[i].name, end - t->stage[i].ticks, t->freq_hz);
+    }
+    boot_trace_print("total", now - t->stage[0].ticks, t->freq_hz);
+    if (t->dropped)
+        printf("[%s]   %u marcas descartadas (BOOT_TRACE_MAX=%d)\n", PROJECT_TAG,
+               t->dropped, BOOT_TRACE_MAX);
+}
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * boot_trace.h — Linus Neural Project
+ *
+ * Rastreador de estágios do boot: cada marca guarda o contador de ciclos
+ * da arquitetura (CNTVCT_EL0 no ARM64, TSC no x86) numa tabela fixa, sem
+ * alocação nem printf no caminho. A tabela vai para o kernel dentro de
+ * struct boot_info, que imprime a duração de cada estágio.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+#include <stdint.h>
+
+#define BOOT_TRACE_MAX 32
+
+struct boot_stage {
+    const char *name;       /* início do estágio; termina na marca seguinte */
+    uint64_t ticks;
+};
+
+struct boot_trace {
+    uint64_t freq_hz;       /* 0 se a frequência do contador é desconhecida */
+    uint32_t count;
+    uint32_t dropped;       /* marcas além de BOOT_TRACE_MAX */
+    struct boot_stage stage[BOOT_TRACE_MAX];
+};
+
+static inline uint64_t boot_ticks(void)
+{
+#if defined(__aarch64__)
+    uint64_t t;
+
+    /* isb: sem ele a leitura pode ser antecipada para antes do código anterior */
+    __asm__ volatile("isb; mrs %0, cntvct_el0" : "=r"(t) : : "memory");
+    return t;
+#elif defined(__x86_64__) || defined(__i386__)
+    uint32_t lo, hi;
+
+    __asm__ volatile("lfence; rdtsc" : "=a"(lo), "=d"(hi) : : "memory");
+    return ((uint64_t)hi << 32) | lo;
+#else
+    return 0;
+#endif
+}
+
+void boot_trace_init(struct boot_trace *t, uint64_t start_ticks);
+void boot_trace_mark(struct boot_trace *t, const char *name);
+void boot_trace_report(const struct boot_trace *t);
+
+#endif /* BOOT_TRACE_H */
@@ -3,6 +3,13 @@
  * bootloader.c — Linus Neural Project
  *
  * Etapa C do bootloader: exibe mensagens, configura memória e chama o kernel neural.
+ * Cada estágio é marcado em boot_trace (boot_trace.h), entregue ao kernel
+ * em boot_info, que imprime quanto tempo cada um levou.
+ * Se o build embutir uma imagem do kernel (kernel_payload), ela é
+ * carregada em KERNEL_LOAD_ADDR por boot_load_image_mem, com os núcleos
+ * secundários (boot_smp.h) dividindo a descompressão e a zeragem da .bss
+ * do kernel. A imagem é LZ4-frame com checksum de conteúdo, obrigatório;
+ * um build com -DKERNEL_PAYLOAD_RAW embute o Image cru.
  *
  * Copyright (c) 2025 Linus Neural Project
  */
@@ -11,8 +18,22 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "boot_load.h"
+#include "boot_mmu.h"
+#include "boot_smp.h"
+#include "boot_trace.h"
+
 #define PROJECT_TAG "Linus Neural Project"
 #define KERNEL_ENTRY 0x80000
+#define KERNEL_LOAD_ADDR 0x40200000UL          /* alinhado a 2 MB, acima do bootloader */
+#define KERNEL_LOAD_MAX  (64UL * 1024 * 1024)
+#define ARM64_IMAGE_MAGIC 0x644d5241U           /* "ARM\x64" no header do Image */
+
+#ifdef KERNEL_PAYLOAD_RAW
+#define KERNEL_PAYLOAD_FLAGS 0
+#else
+#define KERNEL_PAYLOAD_FLAGS (BOOT_LOAD_LZ4 | BOOT_LOAD_VERIFY)
+#endif
 
 // Simulação de estruturas de boot
 struct boot_info {
@@ -20,8 +41,67 @@ struct boot_info {
     uint64_t memory_base;
     uint64_t memory_size;
     const char *next_stage;
+    unsigned cpus;              /* núcleos ativos no bootloader */
+    struct boot_trace *trace;   /* marcas de estágio desde _start */
+    void *kernel_image;         /* NULL se nenhuma imagem foi carregada */
+    uint64_t kernel_size;
 };
 
+static struct boot_trace boot_trace;
+
+/* Imagem embutida pelo build (.incbin); sem ela, o kernel é o kernel_main ligado aqui */
+extern const uint8_t kernel_payload[] __attribute__((weak));
+extern const uint8_t kernel_payload_end[] __attribute__((weak));
+
+/*
+ * Image do Linux arm64: image_size (offset 16) inclui a .bss, que segue a
+ * parte carregada; zerá-la aqui adianta o trabalho do kernel. 0 se a
+ * imagem não tem esse header.
+ */
+static uint64_t kernel_effective_size(const uint8_t *image, uint64_t size)
+{
+    uint64_t effective;
+    uint32_t magic;
+
+    if (size < 64)
+        return 0;
+    memcpy(&magic, image + 56, sizeof(magic));
+    memcpy(&effective, image + 16, sizeof(effective));
+    if (magic != ARM64_IMAGE_MAGIC || effective <= size || effective > KERNEL_LOAD_MAX)
+        return 0;
+    return effective;
+}
+
+static int load_kernel(struct boot_info *info)
+{
+    uint8_t *image = (uint8_t *)KERNEL_LOAD_ADDR;
+    struct boot_image img;
+    uint64_t effective;
+    int ret;
+
+    ret = boot_load_image_mem(kernel_payload, kernel_payload_end - kernel_payload,
+                              image, KERNEL_LOAD_MAX, KERNEL_PAYLOAD_FLAGS, &img);
+    if (ret) {
+        printf("[%s] Falha ao carregar o kernel: %s\n", PROJECT_TAG, boot_load_strerror(ret));
+        return ret;
+    }
+    effective = kernel_effective_size(image, img.size);
+    if (effective) {
+        boot_trace_mark(&boot_trace, "kernel_bss");
+        boot_smp_memzero(image + img.size, effective - img.size);
+    } else {
+        effective = img.size;
+    }
+    /* Escrita pela D-cache: limpa até o PoC e invalida a I-cache antes de executar */
+    bl_cache_sync(image, effective);
+    printf("[%s] Kernel carregado em 0x%lx: %zu bytes de %zu armazenados (%s)\n",
+           PROJECT_TAG, KERNEL_LOAD_ADDR, img.size, img.stored,
+           img.compressed ? "LZ4, checksum ok" : "cru");
+    info->kernel_image = (void *)KERNEL_LOAD_ADDR;
+    info->kernel_size = img.size;
+    return 0;
+}
+
 // Protótipo da função do kernel
 extern void kernel_main(struct boot_info *info);
 
@@ -31,30 +111,44 @@ void print_banner(void) {
     printf("==============================\n\n");
 }
 
-void boot_delay() {
-    for (volatile int i = 0; i < 100000000; i++);
-}
-
-void boot_main(void)
+/* start_ticks: contador lido na primeira instrução de _start */
+void boot_main(uint64_t start_ticks)
 {
+    boot_trace_init(&boot_trace, start_ticks);
+    boot_trace_mark(&boot_trace, "boot_main");
+
     print_banner();
+    boot_trace_mark(&boot_trace, "boot_info");
 
     struct boot_info info;
     memset(&info, 0, sizeof(info));
 
     info.arch = "ARM64";
-    info.memory_base = 0x40000000;
-    info.memory_size = 512 * 1024 * 1024; // 512 MB
+    info.memory_base = BOOT_RAM_BASE;   // o mesmo mapeado por _start
+    info.memory_size = BOOT_RAM_SIZE;
     info.next_stage = "neural_kernel";
+    info.trace = &boot_trace;
 
     printf("[%s] Arquitetura detectada: %s\n", PROJECT_TAG, info.arch);
     printf("[%s] Memória base: 0x%lx\n", PROJECT_TAG, info.memory_base);
     printf("[%s] Memória total: %lu MB\n", PROJECT_TAG, info.memory_size / (1024 * 1024));
 
-    boot_delay();
+    boot_trace_mark(&boot_trace, "smp");
+    info.cpus = boot_smp_init();
+    printf("[%s] Núcleos ativos: %u\n", PROJECT_TAG, info.cpus);
 
+    if (kernel_payload) {
+        boot_trace_mark(&boot_trace, "kernel_load");
+        if (load_kernel(&info)) {
+            /* os secundários ainda esperam trabalho em boot_work_poll */
+            boot_smp_shutdown();
+            return;
+        }
+    }
+
+    boot_smp_shutdown();
     printf("[%s] Chamando kernel neural em 0x%lx...\n\n", PROJECT_TAG, (uint64_t)&kernel_main);
-    boot_delay();
+    boot_trace_mark(&boot_trace, "kernel_main");
 
     // Chama o kernel principal (simulado)
     kernel_main(&info);
@@ -65,4 +159,7 @@ void kernel_main(struct boot_info *info)
     printf("[%s] Kernel neural iniciado.\n", PROJECT_TAG);
     printf("[%s] Memória carregada com sucesso.\n", PROJECT_TAG);
     printf("[%s] Sistema operacional consciente pronto.\n", PROJECT_TAG);
+
+    if (info->trace)
+        boot_trace_report(info->trace);
 }
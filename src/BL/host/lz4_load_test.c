@@ -0,0 +1,506 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lz4_load_test.c — Linus Neural Project
+ *
+ * Harness no host para boot_load_image/lz4_boot.c, compilados sem
+ * alterações. Comprime imagens com a liblz4 em várias configurações de
+ * quadro e confere:
+ *   - saída idêntica com a fonte entregando pedaços de 1 byte, tamanhos
+ *     aleatórios e BOOT_LOAD_CHUNK;
+ *   - erro (nunca saída errada nem escrita fora da área) com bytes
+ *     trocados, quadro truncado e área de carga pequena;
+ *   - com BOOT_LOAD_LZ4 a assinatura trocada é LZ4B_ERR_MAGIC, nunca
+ *     carga crua, e BOOT_LOAD_VERIFY recusa quadro sem checksum.
+ *
+ *   - o mesmo para boot_load_image_mem, que com blocos independentes
+ *     descomprime em paralelo na fila de boot_smp.c; aqui os núcleos
+ *     secundários são -t threads chamando boot_smp_secondary_main.
+ *
+ * Depois mede o tempo de carga crua x LZ4 para alguns perfis de
+ * armazenamento: transferência modelada por banda (bytes / MB/s) mais o
+ * tempo de CPU medido para copiar ou descomprimir, e a descompressão
+ * paralela (bl.lz4.decode_smp, "threads" = núcleos). Saída em NDJSON no
+ * formato do lnp_bench:
+ *   ./lz4_load_test [-i vmlinux.bin] [-n REPS] [-t SECONDARIES] > load.ndjson
+ *   for t in 0 1 3 7; do ./lz4_load_test -t $t; done    # escala com núcleos
+ * As threads giram sem dormir, como os núcleos em WFE não podem: use -t
+ * menor que o número de CPUs livres, ou os tempos seriais também caem.
+ * Sem -i usa uma imagem sintética de 16 MB com a compressibilidade de um
+ * kernel (código repetitivo, tabelas de texto, páginas zeradas).
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <lz4frame.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "boot_load.h"
+#include "boot_smp.h"
+#include "lz4_boot.h"
+
+#define GUARD 4096
+#define MB    (1024.0 * 1024.0)
+
+#define CHECK(cond, ...) do { if (!(cond)) { fprintf(stderr, "check failed: " __VA_ARGS__); \
+                                             fprintf(stderr, "\n"); return 1; } } while (0)
+
+struct test_source {
+    const uint8_t *p, *end;
+    int mode;               /* 0 = até len, 1 = um byte, 2 = aleatório */
+    uint32_t rng;
+};
+
+static uint32_t xorshift(uint32_t *s)
+{
+    uint32_t x = *s;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *s = x;
+}
+
+static long test_read(void *ctx, void *buf, size_t len)
+{
+    struct test_source *t = ctx;
+    size_t n = t->end - t->p;
+
+    if (t->mode == 1)
+        len = 1;
+    else if (t->mode == 2)
+        len = 1 + xorshift(&t->rng) % len;
+    if (n > len)
+        n = len;
+    memcpy(buf, t->p, n);
+    t->p += n;
+    return n;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench_record_threads(const char *name, unsigned threads, double value,
+                                 const char *unit, const char *better)
+{
+    printf("{\"bench\":\"%s\",\"threads\":%u,\"value\":%.3f,\"unit\":\"%s\",\"better\":\"%s\"}\n",
+           name, threads, value, unit, better);
+    fflush(stdout);
+    fprintf(stderr, "  %-28s %12.3f %s\n", name, value, unit);
+}
+
+static void bench_record(const char *name, double value, const char *unit, const char *better)
+{
+    bench_record_threads(name, 1, value, unit, better);
+}
+
+/* Mistura com a cara de uma imagem de kernel: ~1,6x com LZ4 HC */
+static uint8_t *synth_image(size_t size)
+{
+    static const char *words[] = { "irq", "sched", "mm", "page", "alloc", "neural", "touch",
+                                   "eyes", "spin_lock", "kfree", "printk", "boot", "%s: %d\n" };
+    uint32_t dict[256], rng = 0x2025, *w;
+    uint8_t *img = malloc(size), *p = img, *end = img + size;
+    size_t i;
+
+    if (!img)
+        return NULL;
+    for (i = 0; i < 256; i++)
+        dict[i] = xorshift(&rng);
+    while (p < end) {
+        size_t run = 4096 + xorshift(&rng) % 16384, kind = xorshift(&rng) % 10;
+
+        if (run > (size_t)(end - p))
+            run = end - p;
+        if (kind < 5) {                 /* código: palavras de um vocabulário pequeno */
+            for (i = 0; i + 4 <= run; i += 4) {
+                uint32_t v = dict[xorshift(&rng) & 0xff];
+
+                if (!(xorshift(&rng) & 3))
+                    v ^= xorshift(&rng) & 0xfff;
+                w = (uint32_t *)(p + i);
+                memcpy(w, &v, 4);
+            }
+            memset(p + i, 0, run - i);
+        } else if (kind < 7) {          /* tabelas de strings */
+            for (i = 0; i < run;) {
+                const char *s = words[xorshift(&rng) % (sizeof(words) / sizeof(words[0]))];
+                size_t l = strlen(s) + 1;
+
+                if (l > run - i)
+                    l = run - i;
+                memcpy(p + i, s, l);
+                i += l;
+            }
+        } else if (kind < 8) {          /* .bss/alinhamento */
+            memset(p, 0, run);
+        } else {                        /* dados já comprimidos, firmware */
+            for (i = 0; i < run; i++)
+                p[i] = xorshift(&rng);
+        }
+        p += run;
+    }
+    return img;
+}
+
+static uint8_t *compress(const uint8_t *src, size_t size, const LZ4F_preferences_t *prefs,
+                         size_t *out_size)
+{
+    size_t cap = LZ4F_compressFrameBound(size, prefs);
+    uint8_t *out = malloc(cap);
+
+    if (!out)
+        return NULL;
+    *out_size = LZ4F_compressFrame(out, cap, src, size, prefs);
+    if (LZ4F_isError(*out_size)) {
+        fprintf(stderr, "LZ4F_compressFrame: %s\n", LZ4F_getErrorName(*out_size));
+        free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/* Carrega em área com guardas dos dois lados; -1000 se alguma guarda foi tocada */
+static int load(const uint8_t *stored, size_t stored_size, int mode, uint8_t *area, size_t max,
+                unsigned flags, struct boot_image *img)
+{
+    struct test_source t = { stored, stored + stored_size, mode, 0x1234 + (uint32_t)stored_size };
+    struct boot_source src = { test_read, &t };
+    size_t i;
+    int ret;
+
+    memset(area, 0xa5, GUARD);
+    memset(area + GUARD + max, 0xa5, GUARD);
+    ret = boot_load_image(&src, area + GUARD, max, flags, img);
+    for (i = 0; i < GUARD; i++)
+        if (area[i] != 0xa5 || area[GUARD + max + i] != 0xa5)
+            return -1000;
+    return ret;
+}
+
+/* Como load, mas pelo caminho de imagem em memória (paralelo quando possível) */
+static int load_mem(const uint8_t *stored, size_t stored_size, uint8_t *area, size_t max,
+                    unsigned flags, struct boot_image *img)
+{
+    size_t i;
+    int ret;
+
+    memset(area, 0xa5, GUARD);
+    memset(area + GUARD + max, 0xa5, GUARD);
+    ret = boot_load_image_mem(stored, stored_size, area + GUARD, max, flags, img);
+    for (i = 0; i < GUARD; i++)
+        if (area[i] != 0xa5 || area[GUARD + max + i] != 0xa5)
+            return -1000;
+    return ret;
+}
+
+static int check_image(const uint8_t *raw, size_t size, uint8_t *area)
+{
+    static const struct {
+        LZ4F_blockSizeID_t bs;
+        LZ4F_blockMode_t mode;
+        int block_csum, content_csum, content_size, level;
+    } cfg[] = {
+        { LZ4F_max64KB,  LZ4F_blockLinked,      0, 1, 0, 0 },
+        { LZ4F_max64KB,  LZ4F_blockIndependent, 1, 1, 1, 0 },
+        { LZ4F_max256KB, LZ4F_blockLinked,      0, 1, 1, 9 },
+        { LZ4F_max256KB, LZ4F_blockIndependent, 0, 1, 0, 9 },
+        { LZ4F_max1MB,   LZ4F_blockIndependent, 0, 0, 0, 0 },
+        { LZ4F_max4MB,   LZ4F_blockLinked,      1, 1, 1, 12 },
+    };
+    struct boot_image img;
+    size_t c, stored_size, i;
+    unsigned verify;
+    int mode, ret;
+
+    for (c = 0; c < sizeof(cfg) / sizeof(cfg[0]); c++) {
+        LZ4F_preferences_t prefs = { 0 };
+        uint8_t *stored;
+        uint32_t rng = 77;
+
+        prefs.frameInfo.blockSizeID = cfg[c].bs;
+        prefs.frameInfo.blockMode = cfg[c].mode;
+        prefs.frameInfo.blockChecksumFlag = cfg[c].block_csum;
+        prefs.frameInfo.contentChecksumFlag = cfg[c].content_csum;
+        prefs.frameInfo.contentSize = cfg[c].content_size ? size : 0;
+        prefs.compressionLevel = cfg[c].level;
+        stored = compress(raw, size, &prefs, &stored_size);
+        CHECK(stored, "compress cfg %zu", c);
+        verify = cfg[c].content_csum ? BOOT_LOAD_VERIFY : 0;
+
+        for (mode = size > 65536 ? 0 : 1; mode < 3; mode++) {
+            ret = load(stored, stored_size, mode, area, size, BOOT_LOAD_LZ4, &img);
+            CHECK(ret == 0, "cfg %zu mode %d: %s", c, mode, boot_load_strerror(ret));
+            CHECK(img.compressed && img.size == size && img.stored == stored_size &&
+                  img.verified == cfg[c].content_csum, "cfg %zu mode %d: image info", c, mode);
+            CHECK(!memcmp(area + GUARD, raw, size), "cfg %zu mode %d: output differs", c, mode);
+        }
+        memset(area + GUARD, 0, size);
+        ret = load_mem(stored, stored_size, area, size, BOOT_LOAD_LZ4, &img);
+        CHECK(ret == 0, "cfg %zu mem: %s", c, boot_load_strerror(ret));
+        CHECK(img.compressed && img.size == size && img.stored == stored_size &&
+              img.verified == cfg[c].content_csum, "cfg %zu mem: image info", c);
+        CHECK(!memcmp(area + GUARD, raw, size), "cfg %zu mem: output differs", c);
+
+        /* checksum de conteúdo exigido: só os quadros que o têm passam */
+        ret = load(stored, stored_size, 0, area, size, BOOT_LOAD_LZ4 | BOOT_LOAD_VERIFY, &img);
+        CHECK(ret == (verify ? 0 : BOOT_LOAD_ERR_UNVERIFIED), "cfg %zu verify gave %d", c, ret);
+        ret = load_mem(stored, stored_size, area, size, BOOT_LOAD_LZ4 | BOOT_LOAD_VERIFY, &img);
+        CHECK(ret == (verify ? 0 : BOOT_LOAD_ERR_UNVERIFIED), "cfg %zu mem verify gave %d", c, ret);
+
+        /* assinatura trocada: erro, não imagem crua */
+        stored[0] ^= 1;
+        ret = load(stored, stored_size, 0, area, size, BOOT_LOAD_LZ4, &img);
+        CHECK(ret == LZ4B_ERR_MAGIC, "cfg %zu: bad magic gave %d", c, ret);
+        ret = load_mem(stored, stored_size, area, size, BOOT_LOAD_LZ4, &img);
+        CHECK(ret == LZ4B_ERR_MAGIC, "cfg %zu mem: bad magic gave %d", c, ret);
+        stored[0] ^= 1;
+
+        /* área um byte menor */
+        ret = load(stored, stored_size, 0, area, size - 1, BOOT_LOAD_LZ4, &img);
+        CHECK(ret == LZ4B_ERR_OVERFLOW, "cfg %zu: small area gave %d", c, ret);
+        ret = load_mem(stored, stored_size, area, size - 1, BOOT_LOAD_LZ4, &img);
+        CHECK(ret == LZ4B_ERR_OVERFLOW, "cfg %zu mem: small area gave %d", c, ret);
+
+        /* truncado em pontos variados */
+        for (i = 1; i < 64; i++) {
+            size_t cut = stored_size * i / 64;
+
+            ret = load(stored, cut, 2, area, size, BOOT_LOAD_LZ4, &img);
+            CHECK(ret < 0 && ret != -1000, "cfg %zu: truncated at %zu gave %d", c, cut, ret);
+            ret = load_mem(stored, cut, area, size, BOOT_LOAD_LZ4, &img);
+            CHECK(ret < 0 && ret != -1000, "cfg %zu mem: truncated at %zu gave %d", c, cut, ret);
+        }
+
+        /* bytes trocados: erro, ou saída exata quando a troca não muda nada */
+        for (i = 0; i < 200; i++) {
+            size_t pos = xorshift(&rng) % stored_size;
+            uint8_t old = stored[pos];
+
+            stored[pos] ^= 1 + xorshift(&rng) % 255;
+            ret = i & 1 ? load_mem(stored, stored_size, area, size, BOOT_LOAD_LZ4 | verify, &img)
+                        : load(stored, stored_size, 0, area, size, BOOT_LOAD_LZ4 | verify, &img);
+            CHECK(ret != -1000, "cfg %zu: flip at %zu wrote outside the area", c, pos);
+            if (ret == 0 && cfg[c].content_csum)
+                CHECK(!memcmp(area + GUARD, raw, size),
+                      "cfg %zu: flip at %zu accepted with wrong output", c, pos);
+            stored[pos] = old;
+        }
+        free(stored);
+    }
+
+    /* imagem crua passa direto quando pedida, e é recusada onde se espera LZ4 */
+    ret = load(raw, size, 2, area, size, 0, &img);
+    CHECK(ret == 0 && !img.compressed && img.size == size && !memcmp(area + GUARD, raw, size),
+          "raw image");
+    ret = load(raw, size, 0, area, size - 1, 0, &img);
+    CHECK(ret == LZ4B_ERR_OVERFLOW, "raw image too big gave %d", ret);
+    ret = load(raw, size, 0, area, size, BOOT_LOAD_LZ4, &img);
+    CHECK(ret == LZ4B_ERR_MAGIC, "raw image as LZ4 gave %d", ret);
+    ret = load_mem(raw, size, area, size, BOOT_LOAD_LZ4, &img);
+    CHECK(ret == LZ4B_ERR_MAGIC, "raw image as LZ4 (mem) gave %d", ret);
+    return 0;
+}
+
+static int check_xxh32(void)
+{
+    /* vetores de referência do XXH32 */
+    CHECK(lz4b_xxh32("", 0, 0) == 0x02CC5D05U, "xxh32 empty");
+    CHECK(lz4b_xxh32("abc", 3, 0) == 0x32D153FFU, "xxh32 abc");
+    return 0;
+}
+
+static double time_load(const uint8_t *stored, size_t stored_size, uint8_t *area, size_t max,
+                        unsigned flags, int reps)
+{
+    struct boot_image img;
+    double best = 1e9;
+    int r;
+
+    for (r = 0; r < reps; r++) {
+        double t0 = now_s();
+
+        if (load(stored, stored_size, 0, area, max, flags, &img))
+            return -1;
+        t0 = now_s() - t0;
+        if (t0 < best)
+            best = t0;
+    }
+    return best;
+}
+
+static void bench(const uint8_t *raw, size_t size, uint8_t *area, int reps)
+{
+    static const struct { const char *name; double mb_s; } storage[] = {
+        { "sd", 25 }, { "emmc", 150 }, { "ufs", 800 }, { "nvme", 3000 },
+    };
+    LZ4F_preferences_t prefs = { 0 };
+    LZ4F_dctx *dctx;
+    size_t stored_size, smp_size, s, i;
+    uint8_t *stored, *smp_stored;
+    double t_raw, t_lz4, t_smp = 1e9, t_ref = 1e9;
+    unsigned cpus = boot_smp_cpus();
+    struct boot_image img;
+    char name[64];
+
+    prefs.frameInfo.blockSizeID = LZ4F_max4MB;
+    prefs.frameInfo.contentChecksumFlag = 1;
+    prefs.frameInfo.contentSize = size;
+    prefs.compressionLevel = 9;         /* HC: compressão lenta no build, descompressão igual */
+    stored = compress(raw, size, &prefs, &stored_size);
+    if (!stored)
+        return;
+
+    t_raw = time_load(raw, size, area, size, 0, reps);
+    t_lz4 = time_load(stored, stored_size, area, size, BOOT_LOAD_LZ4 | BOOT_LOAD_VERIFY, reps);
+
+    /* referência: liblz4 com o quadro inteiro em memória */
+    LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION);
+    for (i = 0; i < (size_t)reps; i++) {
+        size_t out = size, in = stored_size;
+        double t0 = now_s();
+
+        LZ4F_resetDecompressionContext(dctx);
+        LZ4F_decompress(dctx, area + GUARD, &out, stored, &in, NULL);
+        t0 = now_s() - t0;
+        if (t0 < t_ref)
+            t_ref = t0;
+    }
+    LZ4F_freeDecompressionContext(dctx);
+
+    /* paralelo: blocos independentes de 256 KB, uma fatia de trabalho cada */
+    prefs.frameInfo.blockSizeID = LZ4F_max256KB;
+    prefs.frameInfo.blockMode = LZ4F_blockIndependent;
+    smp_stored = compress(raw, size, &prefs, &smp_size);
+    if (!smp_stored) {
+        free(stored);
+        return;
+    }
+    for (i = 0; i < (size_t)reps; i++) {
+        double t0 = now_s();
+
+        if (load_mem(smp_stored, smp_size, area, size, BOOT_LOAD_LZ4 | BOOT_LOAD_VERIFY, &img)) {
+            fprintf(stderr, "lz4_load_test: parallel load failed\n");
+            break;
+        }
+        t0 = now_s() - t0;
+        if (t0 < t_smp)
+            t_smp = t0;
+    }
+
+    fprintf(stderr, "lz4_load_test: %.1f MB image, %.1f MB stored (ratio %.2f)\n",
+            size / MB, stored_size / MB, (double)size / stored_size);
+    bench_record("bl.lz4.ratio", (double)size / stored_size, "x", "higher");
+    bench_record("bl.lz4.decode", size / MB / t_lz4, "MB/s", "higher");
+    bench_record("bl.lz4.decode_liblz4", size / MB / t_ref, "MB/s", "higher");
+    bench_record("bl.raw.copy", size / MB / t_raw, "MB/s", "higher");
+    bench_record_threads("bl.lz4.decode_smp", cpus, size / MB / t_smp, "MB/s", "higher");
+
+    for (s = 0; s < sizeof(storage) / sizeof(storage[0]); s++) {
+        double raw_ms = (size / MB / storage[s].mb_s + t_raw) * 1e3;
+        double lz4_ms = (stored_size / MB / storage[s].mb_s + t_lz4) * 1e3;
+
+        snprintf(name, sizeof(name), "bl.load.raw.%s", storage[s].name);
+        bench_record(name, raw_ms, "ms", "lower");
+        snprintf(name, sizeof(name), "bl.load.lz4.%s", storage[s].name);
+        bench_record(name, lz4_ms, "ms", "lower");
+        snprintf(name, sizeof(name), "bl.load.lz4_smp.%s", storage[s].name);
+        bench_record_threads(name, cpus, (smp_size / MB / storage[s].mb_s + t_smp) * 1e3,
+                             "ms", "lower");
+    }
+    free(smp_stored);
+    free(stored);
+}
+
+static void *secondary_thread(void *arg)
+{
+    boot_smp_secondary_main((unsigned)(uintptr_t)arg);
+    return NULL;
+}
+
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *data = NULL;
+    long len;
+
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+    if (fseek(f, 0, SEEK_END) == 0 && (len = ftell(f)) > 1 && fseek(f, 0, SEEK_SET) == 0 &&
+        (data = malloc(len)) && fread(data, 1, len, f) == (size_t)len) {
+        *size = len;
+    } else {
+        fprintf(stderr, "%s: unreadable or too small\n", path);
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+int main(int argc, char **argv)
+{
+    const char *input = NULL;
+    size_t size = 16 << 20, small = 200000;
+    uint8_t *raw, *area;
+    int reps = 5, secondaries = 3, opt, i;
+
+    while ((opt = getopt(argc, argv, "i:n:t:h")) != -1) {
+        switch (opt) {
+        case 'i': input = optarg; break;
+        case 'n': reps = atoi(optarg); break;
+        case 't': secondaries = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-i IMAGE] [-n REPS] [-t SECONDARIES]\n", argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (reps < 1)
+        reps = 1;
+    if (secondaries < 0 || secondaries >= BOOT_SMP_MAX_CPUS)
+        secondaries = secondaries < 0 ? 0 : BOOT_SMP_MAX_CPUS - 1;
+
+    /* os "núcleos secundários": threads presas no laço de boot_smp */
+    for (i = 0; i < secondaries; i++) {
+        pthread_t th;
+
+        if (pthread_create(&th, NULL, secondary_thread, (void *)(uintptr_t)(i + 1))) {
+            perror("pthread_create");
+            return 1;
+        }
+        pthread_detach(th);
+    }
+    while (boot_smp_init() < (unsigned)secondaries + 1)
+        ;
+
+    raw = input ? read_file(input, &size) : synth_image(size);
+    area = malloc(size + 2 * GUARD);
+    if (!raw || !area)
+        return 1;
+
+    if (check_xxh32())
+        return 1;
+    /* pequenas (modo byte a byte viável) e a imagem inteira */
+    if (check_image(raw, 1000, area) || check_image(raw, small < size ? small : size, area) ||
+        check_image(raw, size, area))
+        return 1;
+    fprintf(stderr, "lz4_load_test: checks passed\n");
+
+    bench(raw, size, area, reps);
+    free(area);
+    free(raw);
+    return 0;
+}
@@ -0,0 +1,557 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lz4_boot.c — Linus Neural Project
+ *
+ * Descompressor LZ4-frame incremental (lz4_boot.h). Cada estado consome
+ * o que houver do pedaço atual e guarda o resto para a próxima chamada;
+ * quando o pedaço contém sequências inteiras, um laço rápido as decodifica
+ * sem passar pela máquina de estados.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include <string.h>
+
+#include "lz4_boot.h"
+
+#define FLG_VERSION     0xC0
+#define FLG_BLOCK_INDEP 0x20
+#define FLG_BLOCK_CSUM  0x10
+#define FLG_SIZE        0x08
+#define FLG_CONTENT_CSUM 0x04
+#define FLG_RESERVED    0x02
+#define FLG_DICT_ID     0x01
+#define MIN_MATCH       4
+
+enum {
+    ST_MAGIC,
+    ST_DESC,
+    ST_DESC_REST,
+    ST_BLOCK_SIZE,
+    ST_RAW,
+    ST_TOKEN,
+    ST_LIT_EXT,
+    ST_LITERALS,
+    ST_OFFSET,
+    ST_MATCH_EXT,
+    ST_BLOCK_CSUM,
+    ST_CONTENT_CSUM,
+    ST_DONE,
+};
+
+/* ---- XXH32 incremental ---- */
+
+#define P1 2654435761U
+#define P2 2246822519U
+#define P3 3266489917U
+#define P4 668265263U
+#define P5 374761393U
+
+static inline uint32_t rotl32(uint32_t x, int r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+static inline uint32_t le32(const uint8_t *p)
+{
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static inline uint32_t xxh_round(uint32_t acc, uint32_t in)
+{
+    return rotl32(acc + in * P2, 13) * P1;
+}
+
+void lz4b_xxh32_reset(struct lz4b_xxh32 *h, uint32_t seed)
+{
+    memset(h, 0, sizeof(*h));
+    h->v[0] = seed + P1 + P2;
+    h->v[1] = seed + P2;
+    h->v[2] = seed;
+    h->v[3] = seed - P1;
+}
+
+static void xxh32_stripe(struct lz4b_xxh32 *h, const uint8_t *p)
+{
+    h->v[0] = xxh_round(h->v[0], le32(p));
+    h->v[1] = xxh_round(h->v[1], le32(p + 4));
+    h->v[2] = xxh_round(h->v[2], le32(p + 8));
+    h->v[3] = xxh_round(h->v[3], le32(p + 12));
+}
+
+void lz4b_xxh32_update(struct lz4b_xxh32 *h, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+
+    h->total += len;
+    if (h->memsize + len < 16) {
+        memcpy(h->mem + h->memsize, p, len);
+        h->memsize += len;
+        return;
+    }
+    if (h->memsize) {
+        size_t fill = 16 - h->memsize;
+
+        memcpy(h->mem + h->memsize, p, fill);
+        xxh32_stripe(h, h->mem);
+        p += fill;
+        len -= fill;
+        h->memsize = 0;
+    }
+    while (len >= 16) {
+        xxh32_stripe(h, p);
+        p += 16;
+        len -= 16;
+    }
+    memcpy(h->mem, p, len);
+    h->memsize = len;
+}
+
+uint32_t lz4b_xxh32_digest(const struct lz4b_xxh32 *h)
+{
+    const uint8_t *p = h->mem, *end = h->mem + h->memsize;
+    uint32_t acc;
+
+    if (h->total >= 16)
+        acc = rotl32(h->v[0], 1) + rotl32(h->v[1], 7) + rotl32(h->v[2], 12) + rotl32(h->v[3], 18);
+    else
+        acc = h->v[2] + P5;
+    acc += (uint32_t)h->total;
+
+    for (; p + 4 <= end; p += 4)
+        acc = rotl32(acc + le32(p) * P3, 17) * P4;
+    for (; p < end; p++)
+        acc = rotl32(acc + *p * P5, 11) * P1;
+
+    acc ^= acc >> 15;
+    acc *= P2;
+    acc ^= acc >> 13;
+    acc *= P3;
+    acc ^= acc >> 16;
+    return acc;
+}
+
+uint32_t lz4b_xxh32(const void *data, size_t len, uint32_t seed)
+{
+    struct lz4b_xxh32 h;
+
+    lz4b_xxh32_reset(&h, seed);
+    lz4b_xxh32_update(&h, data, len);
+    return lz4b_xxh32_digest(&h);
+}
+
+/* ---- decodificação ---- */
+
+void lz4b_init(struct lz4b_stream *s, void *dst, size_t dst_size)
+{
+    memset(s, 0, sizeof(*s));
+    s->dst = s->out = dst;
+    s->dst_end = s->dst + dst_size;
+    s->state = ST_MAGIC;
+}
+
+/* Junta campos partidos em tmp; true quando tmp tem n bytes */
+static int collect(struct lz4b_stream *s, const uint8_t **ip, const uint8_t *iend, uint32_t n)
+{
+    while (s->tmp_len < n && *ip < iend)
+        s->tmp[s->tmp_len++] = *(*ip)++;
+    return s->tmp_len == n;
+}
+
+/* Consome n bytes do bloco atual, alimentando o checksum do bloco */
+static void take(struct lz4b_stream *s, const uint8_t *p, uint32_t n)
+{
+    s->blk_left -= n;
+    if (s->flg & FLG_BLOCK_CSUM)
+        lz4b_xxh32_update(&s->block_hash, p, n);
+}
+
+/* Match de até len bytes a offset atrás; sobreposto quando offset < len */
+static inline void copy_match(uint8_t *out, uint32_t offset, uint32_t len)
+{
+    const uint8_t *m = out - offset;
+
+    if (offset >= len) {
+        memcpy(out, m, len);
+        return;
+    }
+    if (offset >= 8) {
+        for (; len >= 8; len -= 8, out += 8, m += 8)
+            memcpy(out, m, 8);
+    }
+    while (len--)
+        *out++ = *m++;
+}
+
+/*
+ * Decodifica sequências completas (literais + match) contidas em
+ * [ip, lim). Para no começo da primeira que não está inteira no pedaço,
+ * que não cabe no destino ou que é a última do bloco (só literais), e
+ * deixa esses casos, e os erros, para a máquina de estados.
+ */
+static const uint8_t *decode_fast(struct lz4b_stream *s, const uint8_t *ip, const uint8_t *lim)
+{
+    while (ip < lim) {
+        const uint8_t *seq = ip, *lits;
+        uint32_t tok = *ip++, lit = tok >> 4, mlen = tok & 15, off, b;
+
+        if (lit == 15) {
+            do {
+                if (ip >= lim)
+                    return seq;
+                b = *ip++;
+                lit += b;
+            } while (b == 255);
+        }
+        if ((size_t)(lim - ip) < (size_t)lit + 2)
+            return seq;
+        lits = ip;
+        ip += lit;
+        off = ip[0] | (uint32_t)ip[1] << 8;
+        ip += 2;
+        if (mlen == 15) {
+            do {
+                if (ip >= lim)
+                    return seq;
+                b = *ip++;
+                mlen += b;
+            } while (b == 255);
+        }
+        mlen += MIN_MATCH;
+
+        if (!off || off > (size_t)(s->out - s->dst) + lit ||
+            (size_t)(s->dst_end - s->out) < (size_t)lit + mlen)
+            return seq;
+
+        memcpy(s->out, lits, lit);
+        s->out += lit;
+        copy_match(s->out, off, mlen);
+        s->out += mlen;
+    }
+    return ip;
+}
+
+static void end_block(struct lz4b_stream *s)
+{
+    if (s->flg & FLG_CONTENT_CSUM)
+        lz4b_xxh32_update(&s->content_hash, s->blk_out, s->out - s->blk_out);
+    s->tmp_len = 0;
+    s->state = (s->flg & FLG_BLOCK_CSUM) ? ST_BLOCK_CSUM : ST_BLOCK_SIZE;
+}
+
+int lz4b_feed(struct lz4b_stream *s, const void *in, size_t len, size_t *used)
+{
+    const uint8_t *ip = in, *iend = ip + len;
+    int ret = LZ4B_MORE;
+
+    for (;;) {
+        /* dentro de um bloco comprimido não se lê além do seu fim */
+        const uint8_t *bend = (size_t)(iend - ip) < s->blk_left ? iend : ip + s->blk_left;
+        const uint8_t *p;
+        uint32_t v;
+
+        switch (s->state) {
+        case ST_MAGIC:
+            if (!collect(s, &ip, iend, 4))
+                goto out;
+            if (le32(s->tmp) != LZ4B_MAGIC) {
+                ret = LZ4B_ERR_MAGIC;
+                goto out;
+            }
+            s->tmp_len = 0;
+            s->state = ST_DESC;
+            break;
+
+        case ST_DESC:
+            if (!collect(s, &ip, iend, 2))
+                goto out;
+            s->flg = s->tmp[0];
+            v = s->tmp[1];
+            if ((s->flg & FLG_VERSION) != 0x40 || (s->flg & FLG_RESERVED) ||
+                (v & 0x8F) || (v >> 4) < 4) {
+                ret = LZ4B_ERR_HEADER;
+                goto out;
+            }
+            if (s->flg & FLG_DICT_ID) {
+                ret = LZ4B_ERR_UNSUPPORTED;
+                goto out;
+            }
+            s->blk_max = 1U << (2 * (v >> 4) + 8);
+            s->desc_len = 2 + ((s->flg & FLG_SIZE) ? 8 : 0);
+            s->state = ST_DESC_REST;
+            break;
+
+        case ST_DESC_REST:
+            /* tmp já tem FLG e BD; o checksum cobre o descritor inteiro */
+            if (!collect(s, &ip, iend, s->desc_len + 1))
+                goto out;
+            if (((lz4b_xxh32(s->tmp, s->desc_len, 0) >> 8) & 0xff) != s->tmp[s->desc_len]) {
+                ret = LZ4B_ERR_HEADER;
+                goto out;
+            }
+            if (s->flg & FLG_SIZE) {
+                s->content_size = le32(s->tmp + 2) | (uint64_t)le32(s->tmp + 6) << 32;
+                if (s->content_size > (uint64_t)(s->dst_end - s->dst)) {
+                    ret = LZ4B_ERR_OVERFLOW;
+                    goto out;
+                }
+            }
+            lz4b_xxh32_reset(&s->content_hash, 0);
+            s->tmp_len = 0;
+            s->state = ST_BLOCK_SIZE;
+            break;
+
+        case ST_BLOCK_SIZE:
+            if (!collect(s, &ip, iend, 4))
+                goto out;
+            v = le32(s->tmp);
+            s->tmp_len = 0;
+            if (!v) {
+                s->state = (s->flg & FLG_CONTENT_CSUM) ? ST_CONTENT_CSUM : ST_DONE;
+                break;
+            }
+            s->blk_left = v & 0x7fffffffU;
+            if (s->blk_left > s->blk_max) {
+                ret = LZ4B_ERR_CORRUPT;
+                goto out;
+            }
+            lz4b_xxh32_reset(&s->block_hash, 0);
+            s->blk_out = s->out;
+            s->state = (v >> 31) ? ST_RAW : ST_TOKEN;
+            break;
+
+        case ST_RAW:
+            v = bend - ip;
+            if ((size_t)(s->dst_end - s->out) < v) {
+                ret = LZ4B_ERR_OVERFLOW;
+                goto out;
+            }
+            memcpy(s->out, ip, v);
+            s->out += v;
+            take(s, ip, v);
+            ip += v;
+            if (s->blk_left)
+                goto out;
+            end_block(s);
+            break;
+
+        case ST_TOKEN:
+            if (!s->blk_left) {
+                /* o bloco precisa terminar numa sequência só de literais */
+                ret = LZ4B_ERR_CORRUPT;
+                goto out;
+            }
+            p = decode_fast(s, ip, bend);
+            if (p != ip) {
+                take(s, ip, p - ip);
+                ip = p;
+                break;
+            }
+            if (ip == iend)
+                goto out;
+            v = *ip;
+            take(s, ip, 1);
+            ip++;
+            s->lit_left = v >> 4;
+            s->match_len = v & 15;
+            s->state = s->lit_left == 15 ? ST_LIT_EXT : ST_LITERALS;
+            break;
+
+        case ST_LIT_EXT:
+        case ST_MATCH_EXT:
+            if (ip == bend) {
+                if (!s->blk_left)
+                    ret = LZ4B_ERR_CORRUPT;
+                goto out;
+            }
+            v = *ip;
+            take(s, ip, 1);
+            ip++;
+            if (s->state == ST_LIT_EXT) {
+                s->lit_left += v;
+                if (v != 255)
+                    s->state = ST_LITERALS;
+            } else {
+                s->match_len += v;
+                if (v != 255)
+                    goto match;
+            }
+            break;
+
+        case ST_LITERALS:
+            if ((size_t)(s->dst_end - s->out) < s->lit_left) {
+                ret = LZ4B_ERR_OVERFLOW;
+                goto out;
+            }
+            v = (uint32_t)(bend - ip) < s->lit_left ? (uint32_t)(bend - ip) : s->lit_left;
+            memcpy(s->out, ip, v);
+            s->out += v;
+            take(s, ip, v);
+            ip += v;
+            s->lit_left -= v;
+            if (s->lit_left) {
+                if (!s->blk_left)
+                    ret = LZ4B_ERR_CORRUPT;
+                goto out;
+            }
+            if (!s->blk_left) {
+                end_block(s);
+                break;
+            }
+            s->tmp_len = 0;
+            s->state = ST_OFFSET;
+            break;
+
+        case ST_OFFSET:
+            p = ip;
+            if (!collect(s, &ip, bend, 2)) {
+                take(s, p, ip - p);
+                if (!s->blk_left)
+                    ret = LZ4B_ERR_CORRUPT;
+                goto out;
+            }
+            take(s, p, ip - p);
+            s->offset = s->tmp[0] | (uint32_t)s->tmp[1] << 8;
+            if (!s->offset || s->offset > (size_t)(s->out - s->dst)) {
+                ret = LZ4B_ERR_CORRUPT;
+                goto out;
+            }
+            if (s->match_len == 15) {
+                s->state = ST_MATCH_EXT;
+                break;
+            }
+match:
+            v = s->match_len + MIN_MATCH;
+            if ((size_t)(s->dst_end - s->out) < v) {
+                ret = LZ4B_ERR_OVERFLOW;
+                goto out;
+            }
+            copy_match(s->out, s->offset, v);
+            s->out += v;
+            s->state = ST_TOKEN;
+            break;
+
+        case ST_BLOCK_CSUM:
+            if (!collect(s, &ip, iend, 4))
+                goto out;
+            if (le32(s->tmp) != lz4b_xxh32_digest(&s->block_hash)) {
+                ret = LZ4B_ERR_CHECKSUM;
+                goto out;
+            }
+            s->tmp_len = 0;
+            s->state = ST_BLOCK_SIZE;
+            break;
+
+        case ST_CONTENT_CSUM:
+            if (!collect(s, &ip, iend, 4))
+                goto out;
+            if (le32(s->tmp) != lz4b_xxh32_digest(&s->content_hash)) {
+                ret = LZ4B_ERR_CHECKSUM;
+                goto out;
+            }
+            s->state = ST_DONE;
+            break;
+
+        case ST_DONE:
+            if (s->content_size && s->content_size != lz4b_output_size(s))
+                ret = LZ4B_ERR_CORRUPT;
+            else
+                ret = LZ4B_DONE;
+            goto out;
+        }
+    }
+
+out:
+    if (used)
+        *used = ip - (const uint8_t *)in;
+    return ret;
+}
+
+/* ---- quadro em memória, bloco a bloco ---- */
+
+int lz4b_frame_open(struct lz4b_frame *f, const void *in, size_t len, void *dst, size_t dst_size)
+{
+    const uint8_t *p = in, *end = p + len;
+    struct lz4b_stream s;
+    size_t used;
+    int ret;
+
+    memset(f, 0, sizeof(*f));
+    f->dst = dst;
+    f->dst_size = dst_size;
+
+    /* o cabeçalho passa pela mesma validação do caminho incremental */
+    lz4b_init(&s, dst, dst_size);
+    while (s.state != ST_BLOCK_SIZE) {
+        if (p == end)
+            return LZ4B_ERR_CORRUPT;
+        ret = lz4b_feed(&s, p, 1, &used);
+        if (ret < 0)
+            return ret;
+        p++;
+    }
+    f->flg = s.flg;
+    f->blk_max = s.blk_max;
+    f->content_size = s.content_size;
+    f->first = p;
+
+    for (;;) {
+        uint32_t v, size;
+
+        if (end - p < 4)
+            return LZ4B_ERR_CORRUPT;
+        v = le32(p);
+        p += 4;
+        if (!v)
+            break;
+        size = v & 0x7fffffffU;
+        if (size > f->blk_max)
+            return LZ4B_ERR_CORRUPT;
+        size += (f->flg & FLG_BLOCK_CSUM) ? 4 : 0;
+        if ((size_t)(end - p) < size)
+            return LZ4B_ERR_CORRUPT;
+        p += size;
+        f->nblocks++;
+    }
+    if (f->flg & FLG_CONTENT_CSUM) {
+        if (end - p < 4)
+            return LZ4B_ERR_CORRUPT;
+        f->content_csum = le32(p);
+        p += 4;
+    }
+    f->end = p;
+    return 0;
+}
+
+const uint8_t *lz4b_frame_next(const struct lz4b_frame *f, const uint8_t *blk, size_t *blk_len)
+{
+    size_t len = 4 + (le32(blk) & 0x7fffffffU) + ((f->flg & FLG_BLOCK_CSUM) ? 4 : 0);
+
+    *blk_len = len;
+    blk += len;
+    return le32(blk) ? blk : NULL;
+}
+
+int lz4b_decode_block(const struct lz4b_frame *f, const uint8_t *blk, size_t blk_len,
+                      void *out, size_t cap, size_t *out_size)
+{
+    struct lz4b_stream s;
+    size_t used;
+    int ret;
+
+    if (!(f->flg & FLG_BLOCK_INDEP))
+        return LZ4B_ERR_UNSUPPORTED;
+
+    /* offsets conferidos contra o início do bloco; o conteúdo é somado por quem chama */
+    lz4b_init(&s, out, cap);
+    s.flg = f->flg & ~FLG_CONTENT_CSUM;
+    s.blk_max = f->blk_max;
+    s.state = ST_BLOCK_SIZE;
+    ret = lz4b_feed(&s, blk, blk_len, &used);
+    if (ret < 0)
+        return ret;
+    if (ret != LZ4B_MORE || used != blk_len || s.state != ST_BLOCK_SIZE || s.tmp_len)
+        return LZ4B_ERR_CORRUPT;
+    *out_size = lz4b_output_size(&s);
+    return 0;
+}
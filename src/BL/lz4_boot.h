@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lz4_boot.h — Linus Neural Project
+ *
+ * Descompressor LZ4-frame incremental do bootloader. A entrada chega em
+ * pedaços de qualquer tamanho (como saem do armazenamento) e a saída é
+ * escrita direto no endereço de carga, sem buffer intermediário: as
+ * referências de match apontam para a própria imagem já descomprimida.
+ * O estado ocupa algumas dezenas de bytes e nada é alocado.
+ *
+ * Suporta blocos de 64 KB a 4 MB, independentes ou encadeados, checksum
+ * de cabeçalho, de bloco e de conteúdo (XXH32) e tamanho de conteúdo.
+ * Dicionários externos (DictID) são recusados.
+ *
+ * Com o quadro inteiro em memória e blocos independentes, cada bloco
+ * pode ser decodificado à parte (lz4b_frame_open/next, lz4b_decode_block)
+ * em núcleos diferentes: o bloco i vai para dst + i * blk_max, o que vale
+ * porque o compressor só emite bloco menor que blk_max no fim do quadro.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef LZ4_BOOT_H
+#define LZ4_BOOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LZ4B_MAGIC 0x184D2204U
+
+/* Retornos de lz4b_feed */
+#define LZ4B_MORE               0       /* consumiu tudo, quer mais entrada */
+#define LZ4B_DONE               1       /* quadro completo e verificado */
+#define LZ4B_ERR_MAGIC         -1
+#define LZ4B_ERR_HEADER        -2       /* descritor inválido ou checksum do cabeçalho */
+#define LZ4B_ERR_UNSUPPORTED   -3       /* DictID */
+#define LZ4B_ERR_CORRUPT       -4       /* bloco malformado, offset fora da imagem */
+#define LZ4B_ERR_OVERFLOW      -5       /* não cabe no destino */
+#define LZ4B_ERR_CHECKSUM      -6       /* bloco ou conteúdo não confere */
+
+struct lz4b_xxh32 {
+    uint32_t v[4];
+    uint64_t total;
+    uint8_t mem[16];
+    uint32_t memsize;
+};
+
+struct lz4b_stream {
+    uint8_t *dst;           /* início da imagem */
+    uint8_t *out;           /* próximo byte a escrever */
+    uint8_t *dst_end;
+    uint8_t *blk_out;       /* início do bloco atual na saída */
+    int state;
+    uint8_t flg;
+    uint8_t tmp[16];        /* campos que chegam partidos entre pedaços */
+    uint32_t tmp_len;
+    uint32_t desc_len;
+    uint32_t blk_max;
+    uint32_t blk_left;      /* bytes de entrada restantes no bloco */
+    uint32_t lit_left;
+    uint32_t match_len;
+    uint32_t offset;
+    uint64_t content_size;  /* 0 se o quadro não informa */
+    struct lz4b_xxh32 content_hash;
+    struct lz4b_xxh32 block_hash;
+};
+
+/* Quadro inteiro em memória, percorrido bloco a bloco */
+struct lz4b_frame {
+    uint8_t *dst;
+    size_t dst_size;
+    uint8_t flg;
+    uint32_t blk_max;
+    uint32_t nblocks;
+    uint64_t content_size;  /* 0 se o quadro não informa */
+    uint32_t content_csum;  /* válido se lz4b_frame_has_content_checksum */
+    const uint8_t *first;   /* cabeçalho do primeiro bloco */
+    const uint8_t *end;     /* primeiro byte depois do quadro */
+};
+
+void lz4b_init(struct lz4b_stream *s, void *dst, size_t dst_size);
+/* Consome in[0..len); *used recebe quantos bytes foram usados (menos que len após LZ4B_DONE) */
+int lz4b_feed(struct lz4b_stream *s, const void *in, size_t len, size_t *used);
+
+static inline size_t lz4b_output_size(const struct lz4b_stream *s)
+{
+    return (size_t)(s->out - s->dst);
+}
+
+/* true se o quadro traz checksum do conteúdo (válido após o cabeçalho) */
+static inline int lz4b_has_content_checksum(const struct lz4b_stream *s)
+{
+    return (s->flg >> 2) & 1;
+}
+
+/* Valida o cabeçalho e os tamanhos de todos os blocos de in[0..len) */
+int lz4b_frame_open(struct lz4b_frame *f, const void *in, size_t len, void *dst, size_t dst_size);
+/* Bloco seguinte a blk (cabeçalho incluído em *blk_len); NULL depois do último */
+const uint8_t *lz4b_frame_next(const struct lz4b_frame *f, const uint8_t *blk, size_t *blk_len);
+/* Decodifica um bloco independente em out[0..cap); 0 ou LZ4B_ERR_* */
+int lz4b_decode_block(const struct lz4b_frame *f, const uint8_t *blk, size_t blk_len,
+                      void *out, size_t cap, size_t *out_size);
+
+static inline int lz4b_frame_independent(const struct lz4b_frame *f)
+{
+    return (f->flg >> 5) & 1;
+}
+
+static inline int lz4b_frame_has_content_checksum(const struct lz4b_frame *f)
+{
+    return (f->flg >> 2) & 1;
+}
+
+uint32_t lz4b_xxh32(const void *data, size_t len, uint32_t seed);
+void lz4b_xxh32_reset(struct lz4b_xxh32 *h, uint32_t seed);
+void lz4b_xxh32_update(struct lz4b_xxh32 *h, const void *data, size_t len);
+uint32_t lz4b_xxh32_digest(const struct lz4b_xxh32 *h);
+
+#endif /* LZ4_BOOT_H */
@@ -7,10 +7,20 @@
  * dmesg tail, network interfaces, common tools availability,
  * presence of specific device nodes (e.g. /dev/neural), etc.
  *
+ * Probes read /proc, /sys and the kernel log directly instead of forking
+ * shell pipelines; only checks that really need an external program
+ * (ping, java, systemctl) still go through popen.
+ *
  * Compile:
- *   gcc TestingSystem.c -o test_system
+ *   gcc -O2 -pthread TestingSystem.c -o test_system
  * Run (recommended as root for full checks):
  *   sudo ./test_system
+ *   sudo ./test_system --compare-popen   # also time the legacy popen probes
+ *   ./test_system --watch 1              # stream per-second deltas as NDJSON
+ *   ./test_system --topology             # CPU topology + pinning map as JSON
+ *   ./test_system --bench > board.json   # micro-benchmarks, NDJSON results
+ *   ./test_system --bench --baseline board.json   # flag regressions
+ *   sudo ./test_system --devbench=10     # /dev/neural, /dev/eyes, evdev bench
  *
  * Copyright (c) 2025 Linus Neural Project - TestingSystem
  */
@@ -30,9 +40,64 @@
 #include <ifaddrs.h>
 #include <arpa/inet.h>
 #include <net/if.h>
+#include <netdb.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/utsname.h>
+#include <sys/klog.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <poll.h>
+#include <linux/input.h>
 
 #define BUF_SIZE 4096
+#define TOP_PROCS 10
+
+/* Wall-clock cost of each probe, filled in by main() */
+struct probe_cost {
+    const char *name;
+    const char *legacy_cmd;     /* shell pipeline the probe used to fork */
+    double native_ms;
+};
+
+static struct probe_cost probe_costs[] = {
+    {"uname",     "uname -a; cat /etc/os-release | sed -n '1,6p'", 0},
+    {"disk",      "head -n 6 /proc/mounts", 0},
+    {"lsmod",     "lsmod | head -n 20", 0},
+    {"dmesg",     "dmesg -T | tail -n 10", 0},
+    {"network",   "which ip || which ifconfig", 0},
+    {"binaries",  "for b in fastboot adb java javac gcc make python3; do "
+                  "command -v $b >/dev/null 2>&1 && echo FOUND || echo MISSING; done", 0},
+    {"processes", "ps aux --sort=-%cpu | head -n 11", 0},
+    {"proc",      "cat /proc/sys/vm/overcommit_memory; "
+                  "dmesg | egrep -i 'oom|panic|oops' | tail -n 10", 0},
+    {"loop",      "ls -1 /dev/loop* 2>/dev/null | sed -n '1,10p'", 0},
+    {"devices",   "grep -i neural /proc/devices || true", 0},
+    {NULL, NULL, 0},
+};
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void record_probe_cost(const char *name, double ms) {
+    for (int i = 0; probe_costs[i].name; ++i) {
+        if (strcmp(probe_costs[i].name, name) == 0) {
+            probe_costs[i].native_ms += ms;
+            return;
+        }
+    }
+}
 
 /* Utility: run a shell command and capture first N bytes of output */
 static int run_cmd(const char *cmd, char *out, size_t out_len, int max_lines) {
@@ -62,6 +127,125 @@ static int file_exists_readable(const char *path) {
     return (access(path, R_OK) == 0);
 }
 
+/* Utility: copy the first max_lines lines of a file (native `head -n`) */
+static int read_file_lines(const char *path, char *out, size_t out_len, int max_lines) {
+    FILE *f = fopen(path, "r");
+    size_t written = 0;
+    int lines = 0;
+
+    if (!f) return -1;
+    out[0] = '\0';
+    while (written < out_len - 1 && fgets(out + written, (int)(out_len - written), f)) {
+        written += strlen(out + written);
+        lines++;
+        if (max_lines > 0 && lines >= max_lines) break;
+    }
+    fclose(f);
+    return 0;
+}
+
+/* Utility: resolve a binary through $PATH (native `command -v`) */
+static int find_in_path(const char *bin, char *out, size_t out_len) {
+    const char *path = getenv("PATH");
+    struct stat st;
+
+    if (!path || !*path) path = "/usr/local/bin:/usr/bin:/bin";
+    while (*path) {
+        const char *end = strchr(path, ':');
+        size_t dlen = end ? (size_t)(end - path) : strlen(path);
+
+        if (dlen == 0) {
+            snprintf(out, out_len, "./%s", bin);
+        } else {
+            snprintf(out, out_len, "%.*s/%s", (int)dlen, path, bin);
+        }
+        if (access(out, X_OK) == 0 && stat(out, &st) == 0 && S_ISREG(st.st_mode))
+            return 0;
+        if (!end) break;
+        path = end + 1;
+    }
+    out[0] = '\0';
+    return -1;
+}
+
+/*
+ * Utility: tail of the kernel ring buffer via klogctl(2), optionally keeping
+ * only lines that contain one of the '|'-separated words in `filter`
+ * (case-insensitive). Timestamps are rewritten to wall-clock like `dmesg -T`.
+ */
+static int read_kernel_log_tail(char *out, size_t out_len, int max_lines, const char *filter) {
+    int size = klogctl(10 /* SYSLOG_ACTION_SIZE_BUFFER */, NULL, 0);
+    char *log, *line, *save = NULL;
+    char **tail;
+    int len, kept = 0, first;
+    size_t written = 0;
+    struct timespec rt, mono;
+
+    if (size <= 0) size = 1 << 17;
+    log = malloc((size_t)size + 1);
+    tail = calloc((size_t)max_lines, sizeof(*tail));
+    if (!log || !tail) {
+        free(log);
+        free(tail);
+        return -1;
+    }
+    len = klogctl(3 /* SYSLOG_ACTION_READ_ALL */, log, size);
+    if (len < 0) {
+        snprintf(out, out_len, "klogctl failed: %s\n", strerror(errno));
+        free(log);
+        free(tail);
+        return -1;
+    }
+    log[len] = '\0';
+
+    /* keep a ring of the last max_lines matching lines */
+    for (line = strtok_r(log, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+        if (line[0] == '<') {
+            char *gt = strchr(line, '>');
+            if (gt) line = gt + 1;
+        }
+        if (filter) {
+            char words[128];
+            char *w, *wsave = NULL;
+            int hit = 0;
+            snprintf(words, sizeof(words), "%s", filter);
+            for (w = strtok_r(words, "|", &wsave); w && !hit; w = strtok_r(NULL, "|", &wsave))
+                hit = (strcasestr(line, w) != NULL);
+            if (!hit) continue;
+        }
+        tail[kept % max_lines] = line;
+        kept++;
+    }
+
+    /* boot time in wall-clock terms, as dmesg -T computes it */
+    clock_gettime(CLOCK_REALTIME, &rt);
+    clock_gettime(CLOCK_MONOTONIC, &mono);
+
+    out[0] = '\0';
+    first = kept > max_lines ? kept - max_lines : 0;
+    for (int i = first; i < kept && written < out_len - 1; ++i) {
+        char *msg = tail[i % max_lines];
+        double secs;
+        int n;
+
+        if (msg[0] == '[' && sscanf(msg + 1, "%lf", &secs) == 1 && strchr(msg, ']')) {
+            time_t when = rt.tv_sec - mono.tv_sec + (time_t)secs;
+            char ts[64];
+            strftime(ts, sizeof(ts), "%a %b %e %T %Y", localtime(&when));
+            msg = strchr(msg, ']') + 1;
+            n = snprintf(out + written, out_len - written, "[%s]%s\n", ts, msg);
+        } else {
+            n = snprintf(out + written, out_len - written, "%s\n", msg);
+        }
+        if (n < 0) break;
+        written += (size_t)n;
+    }
+    if (written >= out_len) out[out_len - 1] = '\0';
+    free(log);
+    free(tail);
+    return 0;
+}
+
 /* Print header */
 static void print_header(const char *title) {
     time_t t = time(NULL);
@@ -84,38 +268,342 @@ static void check_user(void) {
     }
 }
 
-/* 2. CPU info (reads /proc/cpuinfo first processor summary) */
-static void check_cpu(void) {
-    print_header("CPU Info");
-    FILE *f = fopen("/proc/cpuinfo", "r");
-    if (!f) {
-        printf("Unable to open /proc/cpuinfo: %s\n", strerror(errno));
-        return;
+/* 2. CPU topology from /sys/devices/system/cpu: packages, cores, SMT, caches, NUMA, frequency */
+#define TOPO_MAX_CPUS   1024
+#define TOPO_MAX_CACHES 64
+#define TOPO_MAX_NODES  64
+#define TOPO_MAX_MODELS 4
+
+struct topo_cpu {
+    int cpu;
+    int package;
+    int core;
+    int node;
+    int smt_index;              /* position among its thread siblings, 0 = first */
+    int core_cpu;               /* lowest CPU among its thread siblings: one per physical core */
+    unsigned long min_khz, max_khz;
+};
+
+struct topo_cache {
+    int level;
+    char type[16];
+    unsigned long size_kb;
+    unsigned line_size;
+    unsigned ways;
+    char shared[128];           /* shared_cpu_list of this instance */
+    int shared_count;
+};
+
+struct topo_node {
+    int id;
+    char cpulist[256];
+    int distance[TOPO_MAX_NODES];
+    int ndistance;
+};
+
+struct cpu_topology {
+    int ncpu;
+    struct topo_cpu cpus[TOPO_MAX_CPUS];
+    int npackages;
+    int ncores;
+    int ncache;
+    struct topo_cache caches[TOPO_MAX_CACHES];
+    int nnode;
+    struct topo_node nodes[TOPO_MAX_NODES];
+    int nmodel;
+    char models[TOPO_MAX_MODELS][128];
+    int pin_map[TOPO_MAX_CPUS];  /* one CPU per physical core first, then SMT siblings */
+};
+
+/* Read a small sysfs attribute into buf, newline stripped */
+static int read_sysfs_str(const char *path, char *buf, size_t len) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    ssize_t n;
+    if (fd < 0) return -1;
+    n = read(fd, buf, len - 1);
+    close(fd);
+    if (n <= 0) return -1;
+    buf[n] = '\0';
+    if (buf[n - 1] == '\n') buf[n - 1] = '\0';
+    return 0;
+}
+
+static long read_sysfs_long(const char *path, long def) {
+    char buf[64];
+    if (read_sysfs_str(path, buf, sizeof(buf)) != 0) return def;
+    return strtol(buf, NULL, 10);
+}
+
+/* Parse a kernel cpulist ("0-3,8,10-11") into cpus[]; returns count */
+static int parse_cpulist(const char *list, int *cpus, int max) {
+    int n = 0;
+    const char *p = list;
+    while (*p && n < max) {
+        char *end;
+        long a = strtol(p, &end, 10), b;
+        if (end == p) break;
+        b = a;
+        if (*end == '-') {
+            p = end + 1;
+            b = strtol(p, &end, 10);
+        }
+        for (long c = a; c <= b && n < max; ++c) cpus[n++] = (int)c;
+        p = (*end == ',') ? end + 1 : end;
+        if (*p == '\0' || *p == '\n') break;
     }
-    char line[512];
-    char model[256] = "<unknown>";
-    int cores = 0;
-    while (fgets(line, sizeof(line), f)) {
-        if (strncmp(line, "model name", 10) == 0 || strncmp(line, "Processor", 9) == 0) {
-            char *p = strchr(line, ':');
-            if (p) {
-                while (*++p == ' ') ; /* skip space */
-                strncpy(model, p, sizeof(model)-1);
-                /* trim newline */
-                char *nl = strchr(model, '\n');
-                if (nl) *nl = '\0';
+    return n;
+}
+
+static int cmp_pin_order(const void *a, const void *b) {
+    const struct topo_cpu *x = a, *y = b;
+    if (x->smt_index != y->smt_index) return x->smt_index - y->smt_index;
+    if (x->node != y->node) return x->node - y->node;
+    if (x->package != y->package) return x->package - y->package;
+    if (x->core_cpu != y->core_cpu) return x->core_cpu - y->core_cpu;
+    return x->cpu - y->cpu;
+}
+
+static void discover_topology(struct cpu_topology *t) {
+    char path[320], buf[512];
+    int online[TOPO_MAX_CPUS];
+    int nonline;
+
+    memset(t, 0, sizeof(*t));
+    if (read_sysfs_str("/sys/devices/system/cpu/online", buf, sizeof(buf)) == 0) {
+        nonline = parse_cpulist(buf, online, TOPO_MAX_CPUS);
+    } else {
+        nonline = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if (nonline > TOPO_MAX_CPUS) nonline = TOPO_MAX_CPUS;
+        for (int i = 0; i < nonline; ++i) online[i] = i;
+    }
+
+    /* NUMA nodes: cpulist and distance vector per node */
+    DIR *d = opendir("/sys/devices/system/node");
+    if (d) {
+        struct dirent *de;
+        while ((de = readdir(d)) != NULL && t->nnode < TOPO_MAX_NODES) {
+            int id;
+            if (sscanf(de->d_name, "node%d", &id) != 1) continue;
+            struct topo_node *nd = &t->nodes[t->nnode];
+            nd->id = id;
+            snprintf(path, sizeof(path), "/sys/devices/system/node/%s/cpulist", de->d_name);
+            if (read_sysfs_str(path, nd->cpulist, sizeof(nd->cpulist)) != 0) nd->cpulist[0] = '\0';
+            snprintf(path, sizeof(path), "/sys/devices/system/node/%s/distance", de->d_name);
+            if (read_sysfs_str(path, buf, sizeof(buf)) == 0) {
+                char *p = buf, *end;
+                while (nd->ndistance < TOPO_MAX_NODES) {
+                    long v = strtol(p, &end, 10);
+                    if (end == p) break;
+                    nd->distance[nd->ndistance++] = (int)v;
+                    p = end;
+                }
             }
+            t->nnode++;
         }
-        if (strncmp(line, "processor", 9) == 0 || strncmp(line, "cpu cores", 9) == 0) {
-            cores++;
+        closedir(d);
+    }
+
+    for (int i = 0; i < nonline; ++i) {
+        struct topo_cpu *c = &t->cpus[t->ncpu++];
+        int siblings[TOPO_MAX_CPUS], nsib;
+        c->cpu = online[i];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", c->cpu);
+        c->package = (int)read_sysfs_long(path, 0);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", c->cpu);
+        c->core = (int)read_sysfs_long(path, c->cpu);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", c->cpu);
+        c->smt_index = 0;
+        c->core_cpu = c->cpu;
+        if (read_sysfs_str(path, buf, sizeof(buf)) == 0) {
+            nsib = parse_cpulist(buf, siblings, TOPO_MAX_CPUS);
+            for (int s = 0; s < nsib; ++s) {
+                if (siblings[s] == c->cpu) c->smt_index = s;
+                if (siblings[s] < c->core_cpu) c->core_cpu = siblings[s];
+            }
+        }
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_min_freq", c->cpu);
+        c->min_khz = (unsigned long)read_sysfs_long(path, 0);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", c->cpu);
+        c->max_khz = (unsigned long)read_sysfs_long(path, 0);
+        c->node = 0;
+        for (int n = 0; n < t->nnode; ++n) {
+            int ncpus[TOPO_MAX_CPUS];
+            int k = parse_cpulist(t->nodes[n].cpulist, ncpus, TOPO_MAX_CPUS);
+            for (int j = 0; j < k; ++j)
+                if (ncpus[j] == c->cpu) c->node = t->nodes[n].id;
+        }
+
+        /* cache instances, deduplicated by level/type/sharing set */
+        for (int idx = 0; t->ncache < TOPO_MAX_CACHES; ++idx) {
+            struct topo_cache tc;
+            int shared[TOPO_MAX_CPUS], dup = 0;
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/level", c->cpu, idx);
+            tc.level = (int)read_sysfs_long(path, -1);
+            if (tc.level < 0) break;
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/type", c->cpu, idx);
+            if (read_sysfs_str(path, tc.type, sizeof(tc.type)) != 0) snprintf(tc.type, sizeof(tc.type), "Unknown");
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/size", c->cpu, idx);
+            tc.size_kb = (unsigned long)read_sysfs_long(path, 0);   /* "32K" parses as 32 */
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/coherency_line_size", c->cpu, idx);
+            tc.line_size = (unsigned)read_sysfs_long(path, 0);
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/ways_of_associativity", c->cpu, idx);
+            tc.ways = (unsigned)read_sysfs_long(path, 0);
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", c->cpu, idx);
+            if (read_sysfs_str(path, tc.shared, sizeof(tc.shared)) != 0)
+                snprintf(tc.shared, sizeof(tc.shared), "%d", c->cpu);
+            tc.shared_count = parse_cpulist(tc.shared, shared, TOPO_MAX_CPUS);
+            for (int k = 0; k < t->ncache && !dup; ++k)
+                dup = t->caches[k].level == tc.level && strcmp(t->caches[k].type, tc.type) == 0
+                      && strcmp(t->caches[k].shared, tc.shared) == 0;
+            if (!dup) t->caches[t->ncache++] = tc;
         }
     }
-    fclose(f);
-    if (cores == 0) { /* fallback: use sysconf */
-        cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    /*
+     * Distinct packages and physical cores. Cores are told apart by their
+     * sibling set, not by (package, core_id): on ARM device-tree boards
+     * core_id restarts in every cluster of the same package.
+     */
+    for (int i = 0; i < t->ncpu; ++i) {
+        int seen_pkg = 0, seen_core = 0;
+        for (int j = 0; j < i; ++j) {
+            if (t->cpus[j].package == t->cpus[i].package) seen_pkg = 1;
+            if (t->cpus[j].core_cpu == t->cpus[i].core_cpu) seen_core = 1;
+        }
+        if (!seen_pkg) t->npackages++;
+        if (!seen_core) t->ncores++;
+    }
+
+    /* model strings (x86 "model name", ARM "CPU part" / "Processor") */
+    FILE *f = fopen("/proc/cpuinfo", "r");
+    if (f) {
+        char line[512];
+        while (fgets(line, sizeof(line), f)) {
+            if (strncmp(line, "model name", 10) != 0 && strncmp(line, "Processor", 9) != 0
+                && strncmp(line, "CPU part", 8) != 0)
+                continue;
+            char *p = strchr(line, ':');
+            if (!p) continue;
+            while (*++p == ' ') ;
+            p[strcspn(p, "\n")] = '\0';
+            int dup = 0;
+            for (int m = 0; m < t->nmodel && !dup; ++m)
+                dup = strcmp(t->models[m], p) == 0;
+            if (!dup && t->nmodel < TOPO_MAX_MODELS)
+                snprintf(t->models[t->nmodel++], sizeof(t->models[0]), "%s", p);
+        }
+        fclose(f);
+    }
+
+    struct topo_cpu *order = malloc(sizeof(struct topo_cpu) * (size_t)(t->ncpu ? t->ncpu : 1));
+    if (order) {
+        memcpy(order, t->cpus, sizeof(struct topo_cpu) * (size_t)t->ncpu);
+        qsort(order, (size_t)t->ncpu, sizeof(*order), cmp_pin_order);
+        for (int i = 0; i < t->ncpu; ++i) t->pin_map[i] = order[i].cpu;
+        free(order);
+    } else {
+        for (int i = 0; i < t->ncpu; ++i) t->pin_map[i] = t->cpus[i].cpu;
+    }
+}
+
+/* One worker per physical core: SMT siblings share execution units */
+static int topo_recommended_workers(const struct cpu_topology *t) {
+    return t->ncores > 0 ? t->ncores : (t->ncpu > 0 ? t->ncpu : 1);
+}
+
+static void check_cpu(void) {
+    print_header("CPU Info");
+    struct cpu_topology *t = malloc(sizeof(*t));
+    if (!t) {
+        printf("Out of memory for topology discovery\n");
+        return;
+    }
+    discover_topology(t);
+
+    if (t->nmodel == 0) printf("Model: <unknown>\n");
+    for (int m = 0; m < t->nmodel; ++m) printf("Model: %s\n", t->models[m]);
+    printf("Sockets: %d  Cores: %d  Threads: %d  (SMT %s)\n",
+           t->npackages, t->ncores, t->ncpu, t->ncpu > t->ncores ? "on" : "off");
+
+    unsigned long fmin = 0, fmax = 0;
+    for (int i = 0; i < t->ncpu; ++i) {
+        if (t->cpus[i].min_khz && (!fmin || t->cpus[i].min_khz < fmin)) fmin = t->cpus[i].min_khz;
+        if (t->cpus[i].max_khz > fmax) fmax = t->cpus[i].max_khz;
+    }
+    if (fmax) printf("Frequency: %lu - %lu MHz\n", fmin / 1000, fmax / 1000);
+    else printf("Frequency: n/a (no cpufreq)\n");
+
+    printf("\nCaches:\n");
+    for (int i = 0; i < t->ncache; ++i) {
+        const struct topo_cache *c = &t->caches[i];
+        printf("  L%d %-12s %6lu KB  line %3u  %2u-way  shared by cpus %s\n",
+               c->level, c->type, c->size_kb, c->line_size, c->ways, c->shared);
+    }
+
+    printf("\nNUMA nodes:\n");
+    for (int n = 0; n < t->nnode; ++n) {
+        printf("  node%d cpus=%s distances=", t->nodes[n].id, t->nodes[n].cpulist);
+        for (int k = 0; k < t->nodes[n].ndistance; ++k)
+            printf("%s%d", k ? "," : "", t->nodes[n].distance[k]);
+        printf("\n");
     }
-    printf("Model: %s\n", model);
-    printf("Cores: %d\n", cores);
+    if (t->nnode == 0) printf("  (no NUMA information)\n");
+
+    printf("\nRecommended worker threads: %d\n", topo_recommended_workers(t));
+    printf("CPU pinning map (worker -> cpu): ");
+    for (int i = 0; i < t->ncpu; ++i) printf("%s%d", i ? "," : "", t->pin_map[i]);
+    printf("\n");
+    free(t);
+}
+
+/* s as a JSON string literal: quotes, backslashes and control characters escaped */
+static void print_json_string(const char *s) {
+    putchar('"');
+    for (const unsigned char *p = (const unsigned char *)s; *p; ++p) {
+        if (*p == '"' || *p == '\\') printf("\\%c", *p);
+        else if (*p < 0x20) printf("\\u%04x", *p);
+        else putchar(*p);
+    }
+    putchar('"');
+}
+
+/* --topology: the same discovery as one JSON object for services sizing their pools */
+static int print_topology_json(void) {
+    struct cpu_topology *t = malloc(sizeof(*t));
+    if (!t) return 1;
+    discover_topology(t);
+
+    printf("{\"models\":[");
+    for (int m = 0; m < t->nmodel; ++m) {
+        if (m) putchar(',');
+        print_json_string(t->models[m]);
+    }
+    printf("],\"sockets\":%d,\"cores\":%d,\"threads\":%d,\"recommended_workers\":%d,\"pin_map\":[",
+           t->npackages, t->ncores, t->ncpu, topo_recommended_workers(t));
+    for (int i = 0; i < t->ncpu; ++i) printf("%s%d", i ? "," : "", t->pin_map[i]);
+    printf("],\"cpus\":[");
+    for (int i = 0; i < t->ncpu; ++i) {
+        const struct topo_cpu *c = &t->cpus[i];
+        printf("%s{\"cpu\":%d,\"socket\":%d,\"core\":%d,\"node\":%d,\"smt\":%d,\"min_khz\":%lu,\"max_khz\":%lu}",
+               i ? "," : "", c->cpu, c->package, c->core, c->node, c->smt_index, c->min_khz, c->max_khz);
+    }
+    printf("],\"caches\":[");
+    for (int i = 0; i < t->ncache; ++i) {
+        const struct topo_cache *c = &t->caches[i];
+        printf("%s{\"level\":%d,\"type\":\"%s\",\"size_kb\":%lu,\"line\":%u,\"ways\":%u,\"shared_cpus\":\"%s\"}",
+               i ? "," : "", c->level, c->type, c->size_kb, c->line_size, c->ways, c->shared);
+    }
+    printf("],\"nodes\":[");
+    for (int n = 0; n < t->nnode; ++n) {
+        printf("%s{\"node\":%d,\"cpus\":\"%s\",\"distances\":[", n ? "," : "",
+               t->nodes[n].id, t->nodes[n].cpulist);
+        for (int k = 0; k < t->nodes[n].ndistance; ++k)
+            printf("%s%d", k ? "," : "", t->nodes[n].distance[k]);
+        printf("]}");
+    }
+    printf("]}\n");
+    free(t);
+    return 0;
 }
 
 /* 3. Memory info (sysinfo + /proc/meminfo brief) */
@@ -165,30 +653,47 @@ static void check_disk(void) {
 
     /* Show top mounted filesystems (first 6 lines of /proc/mounts) */
     char buf[BUF_SIZE] = {0};
-    if (run_cmd("head -n 6 /proc/mounts", buf, sizeof(buf), 0) == 0) {
+    if (read_file_lines("/proc/mounts", buf, sizeof(buf), 6) == 0) {
         printf("\nMounted filesystems (top 6):\n%s", buf);
     }
 }
 
-/* 5. Kernel modules (lsmod) */
+/* 5. Kernel modules (/proc/modules, formatted like lsmod) */
 static void check_lsmod(void) {
     print_header("Loaded Kernel Modules (lsmod top 20)");
-    char buf[BUF_SIZE] = {0};
-    if (run_cmd("lsmod | head -n 20", buf, sizeof(buf), 20) == 0) {
-        printf("%s", buf);
-    } else {
-        printf("Failed to run lsmod\n");
+    FILE *f = fopen("/proc/modules", "r");
+    if (!f) {
+        printf("Unable to open /proc/modules: %s\n", strerror(errno));
+        return;
+    }
+    char line[1024];
+    int shown = 0;
+    printf("%-19s %8s  %s\n", "Module", "Size", "Used by");
+    while (shown < 19 && fgets(line, sizeof(line), f)) {
+        char name[128], deps[768];
+        unsigned long size;
+        int refs;
+        if (sscanf(line, "%127s %lu %d %767s", name, &size, &refs, deps) != 4) continue;
+        if (strcmp(deps, "-") == 0) {
+            deps[0] = '\0';
+        } else {
+            size_t dl = strlen(deps);
+            if (dl > 0 && deps[dl - 1] == ',') deps[dl - 1] = '\0';
+        }
+        printf("%-19s %8lu  %d %s\n", name, size, refs, deps);
+        shown++;
     }
+    fclose(f);
 }
 
 /* 6. Tail of dmesg (last 10 lines) */
 static void check_dmesg_tail(void) {
     print_header("dmesg (last 10 lines)");
     char buf[BUF_SIZE] = {0};
-    if (run_cmd("dmesg -T | tail -n 10", buf, sizeof(buf), 10) == 0) {
+    if (read_kernel_log_tail(buf, sizeof(buf), 10, NULL) == 0) {
         printf("%s", buf);
     } else {
-        printf("Failed to run dmesg\n");
+        printf("Failed to read kernel log: %s", buf);
     }
 }
 
@@ -220,8 +725,8 @@ static void check_network(void) {
     /* Check network tools presence */
     char buf[256];
     printf("\nCommand checks:\n");
-    if (run_cmd("which ip || which ifconfig", buf, sizeof(buf), 1) == 0 && strlen(buf) > 0) {
-        printf("Networking tool: %s", buf);
+    if (find_in_path("ip", buf, sizeof(buf)) == 0 || find_in_path("ifconfig", buf, sizeof(buf)) == 0) {
+        printf("Networking tool: %s\n", buf);
     } else {
         printf("No ip/ifconfig found in PATH\n");
     }
@@ -231,16 +736,12 @@ static void check_network(void) {
 static void check_binaries(void) {
     print_header("Binary Availability");
     const char *bins[] = {"fastboot", "adb", "java", "javac", "gcc", "make", "python3", NULL};
-    char buf[256];
+    char buf[512];
     for (int i = 0; bins[i]; ++i) {
-        char cmd[256];
-        snprintf(cmd, sizeof(cmd), "command -v %s >/dev/null 2>&1 && echo FOUND || echo MISSING", bins[i]);
-        if (run_cmd(cmd, buf, sizeof(buf), 1) == 0) {
-            /* trim newline */
-            char *nl = strchr(buf, '\n'); if (nl) *nl = '\0';
-            printf("%-8s : %s\n", bins[i], buf);
+        if (find_in_path(bins[i], buf, sizeof(buf)) == 0) {
+            printf("%-8s : FOUND (%s)\n", bins[i], buf);
         } else {
-            printf("%-8s : check failed\n", bins[i]);
+            printf("%-8s : MISSING\n", bins[i]);
         }
     }
 }
@@ -257,36 +758,151 @@ static void check_dev_nodes(void) {
             printf("%-20s : MISSING (errno=%d %s)\n", devs[i], errno, strerror(errno));
         }
     }
+    printf("(run with --devbench to measure read throughput and latency of these nodes)\n");
 }
 
 /* 10. Simple kernel version & uname */
 static void check_uname(void) {
     print_header("Kernel & System Info (uname)");
-    char buf[BUF_SIZE] = {0};
-    if (run_cmd("uname -a", buf, sizeof(buf), 1) == 0) {
-        printf("%s", buf);
+    struct utsname un;
+    if (uname(&un) == 0) {
+        printf("%s %s %s %s %s\n", un.sysname, un.nodename, un.release, un.version, un.machine);
     } else {
-        printf("uname failed\n");
+        printf("uname failed: %s\n", strerror(errno));
     }
 
     /* Also show /etc/os-release if exists */
     if (file_exists_readable("/etc/os-release")) {
         char out[512] = {0};
-        if (run_cmd("cat /etc/os-release | sed -n '1,6p'", out, sizeof(out), 6) == 0) {
+        if (read_file_lines("/etc/os-release", out, sizeof(out), 6) == 0) {
             printf("\nOS release (top lines):\n%s", out);
         }
     }
 }
 
-/* 11. Check processes (top few lines of ps aux) */
+/* 11. Check processes: scan /proc/[pid]/stat, keep top 10 by %cpu in a min-heap */
+struct proc_sample {
+    int pid;
+    uid_t uid;
+    double pcpu;                /* lifetime cpu share, as ps computes %CPU */
+    unsigned long rss_kb;
+    char comm[32];
+};
+
+static void proc_heap_sift_down(struct proc_sample *h, int n, int i) {
+    for (;;) {
+        int l = 2 * i + 1, r = l + 1, m = i;
+        if (l < n && h[l].pcpu < h[m].pcpu) m = l;
+        if (r < n && h[r].pcpu < h[m].pcpu) m = r;
+        if (m == i) return;
+        struct proc_sample tmp = h[i]; h[i] = h[m]; h[m] = tmp;
+        i = m;
+    }
+}
+
+static void proc_heap_sift_up(struct proc_sample *h, int i) {
+    while (i > 0) {
+        int p = (i - 1) / 2;
+        if (h[p].pcpu <= h[i].pcpu) return;
+        struct proc_sample tmp = h[i]; h[i] = h[p]; h[p] = tmp;
+        i = p;
+    }
+}
+
+static int cmp_proc_pcpu_desc(const void *a, const void *b) {
+    const struct proc_sample *pa = a, *pb = b;
+    return (pa->pcpu < pb->pcpu) - (pa->pcpu > pb->pcpu);
+}
+
+static int read_proc_sample(int pid, double uptime, long hz, long page_kb, struct proc_sample *ps) {
+    char path[64], buf[1024];
+    struct stat st;
+    int fd;
+    ssize_t n;
+
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    n = read(fd, buf, sizeof(buf) - 1);
+    if (n <= 0 || fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    buf[n] = '\0';
+
+    /* comm may contain spaces and parentheses: it ends at the last ')' */
+    char *lp = strchr(buf, '('), *rp = strrchr(buf, ')');
+    if (!lp || !rp || rp < lp) return -1;
+    size_t clen = (size_t)(rp - lp - 1);
+    if (clen >= sizeof(ps->comm)) clen = sizeof(ps->comm) - 1;
+    memcpy(ps->comm, lp + 1, clen);
+    ps->comm[clen] = '\0';
+
+    unsigned long utime, stime;
+    unsigned long long start;
+    long rss;
+    /* fields after comm: state(3) ... utime(14) stime(15) ... starttime(22) vsize(23) rss(24) */
+    if (sscanf(rp + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu "
+                       "%*d %*d %*d %*d %*d %*d %llu %*u %ld",
+               &utime, &stime, &start, &rss) != 4)
+        return -1;
+
+    double elapsed = uptime - (double)start / hz;
+    ps->pid = pid;
+    ps->uid = st.st_uid;
+    ps->pcpu = elapsed > 0 ? 100.0 * ((double)(utime + stime) / hz) / elapsed : 0.0;
+    ps->rss_kb = rss > 0 ? (unsigned long)rss * page_kb : 0;
+    return 0;
+}
+
 static void check_processes(void) {
     print_header("Running Processes (top 10 by cpu)");
-    char buf[BUF_SIZE] = {0};
-    if (run_cmd("ps aux --sort=-%cpu | head -n 11", buf, sizeof(buf), 11) == 0) {
-        printf("%s", buf);
-    } else {
-        printf("ps failed\n");
+    struct proc_sample heap[TOP_PROCS];
+    int count = 0, total = 0;
+    long hz = sysconf(_SC_CLK_TCK);
+    long page_kb = sysconf(_SC_PAGESIZE) / 1024;
+    double uptime = 0;
+    char buf[64];
+
+    if (read_file_lines("/proc/uptime", buf, sizeof(buf), 1) != 0 || sscanf(buf, "%lf", &uptime) != 1) {
+        printf("Unable to read /proc/uptime: %s\n", strerror(errno));
+        return;
+    }
+    DIR *d = opendir("/proc");
+    if (!d) {
+        printf("Unable to open /proc: %s\n", strerror(errno));
+        return;
     }
+    struct dirent *de;
+    while ((de = readdir(d)) != NULL) {
+        struct proc_sample ps;
+        char *end;
+        long pid = strtol(de->d_name, &end, 10);
+        if (*end != '\0' || pid <= 0) continue;
+        if (read_proc_sample((int)pid, uptime, hz, page_kb, &ps) != 0) continue;
+        total++;
+        if (count < TOP_PROCS) {
+            heap[count] = ps;
+            proc_heap_sift_up(heap, count++);
+        } else if (ps.pcpu > heap[0].pcpu) {
+            heap[0] = ps;
+            proc_heap_sift_down(heap, count, 0);
+        }
+    }
+    closedir(d);
+
+    qsort(heap, (size_t)count, sizeof(heap[0]), cmp_proc_pcpu_desc);
+    printf("%-10s %7s %5s %10s  %s\n", "USER", "PID", "%CPU", "RSS(KB)", "COMMAND");
+    for (int i = 0; i < count; ++i) {
+        struct passwd *pw = getpwuid(heap[i].uid);
+        char user[16];
+        if (pw) snprintf(user, sizeof(user), "%s", pw->pw_name);
+        else snprintf(user, sizeof(user), "%u", (unsigned)heap[i].uid);
+        printf("%-10s %7d %5.1f %10lu  %s\n", user, heap[i].pid, heap[i].pcpu,
+               heap[i].rss_kb, heap[i].comm);
+    }
+    printf("(%d processes scanned)\n", total);
 }
 
 /* 12. Check /proc entries for potential kernel alerts (oom, errors) */
@@ -294,11 +910,11 @@ static void check_proc_status(void) {
     print_header("/proc/sys and kernel alerts");
     char buf[BUF_SIZE] = {0};
     if (file_exists_readable("/proc/sys/vm/overcommit_memory")) {
-        if (run_cmd("cat /proc/sys/vm/overcommit_memory", buf, sizeof(buf), 1) == 0)
+        if (read_file_lines("/proc/sys/vm/overcommit_memory", buf, sizeof(buf), 1) == 0)
             printf("vm.overcommit_memory = %s", buf);
     }
     /* check last kernel OOPS or panic lines in dmesg */
-    if (run_cmd("dmesg | egrep -i 'oom|panic|oops' | tail -n 10", buf, sizeof(buf), 10) == 0) {
+    if (read_kernel_log_tail(buf, sizeof(buf), 10, "oom|panic|oops") == 0) {
         if (strlen(buf) > 0)
             printf("\nRecent kernel warnings (oom/panic/oops):\n%s", buf);
         else
@@ -307,14 +923,31 @@ static void check_proc_status(void) {
 }
 
 /* 13. Quick check for mounted loop devices (useful in test envs) */
+static int cmp_str(const void *a, const void *b) {
+    return strcmp(*(const char * const *)a, *(const char * const *)b);
+}
+
 static void check_loop_devices(void) {
     print_header("Loop Devices (ls /dev/loop*)");
-    char buf[BUF_SIZE] = {0};
-    if (run_cmd("ls -1 /dev/loop* 2>/dev/null | sed -n '1,10p'", buf, sizeof(buf), 10) == 0) {
-        if (strlen(buf) > 0)
-            printf("%s", buf);
-        else
-            printf("No loop devices found or not accessible.\n");
+    char *names[256];
+    int count = 0;
+    DIR *d = opendir("/dev");
+    if (d) {
+        struct dirent *de;
+        while (count < 256 && (de = readdir(d)) != NULL) {
+            if (strncmp(de->d_name, "loop", 4) == 0)
+                names[count++] = strdup(de->d_name);
+        }
+        closedir(d);
+    }
+    if (count == 0) {
+        printf("No loop devices found or not accessible.\n");
+        return;
+    }
+    qsort(names, (size_t)count, sizeof(names[0]), cmp_str);
+    for (int i = 0; i < count; ++i) {
+        if (i < 10) printf("/dev/%s\n", names[i]);
+        free(names[i]);
     }
 }
 
@@ -383,37 +1016,1356 @@ static void check_services_drivers(void) {
     }
 
     /* Check /proc/devices for character devices list */
-    if (file_exists_readable("/proc/devices")) {
-        if (run_cmd("grep -i neural /proc/devices || true", buf, sizeof(buf), 5) == 0 && strlen(buf) > 0)
+    double t0 = now_ms();
+    FILE *f = fopen("/proc/devices", "r");
+    if (f) {
+        char line[256];
+        size_t written = 0;
+        buf[0] = '\0';
+        while (fgets(line, sizeof(line), f)) {
+            if (strcasestr(line, "neural") && written + strlen(line) < sizeof(buf)) {
+                strcpy(buf + written, line);
+                written += strlen(line);
+            }
+        }
+        fclose(f);
+        if (written > 0)
             printf("/proc/devices mentions:\n%s", buf);
         else
             printf("/proc/devices contains no 'neural' entry (expected in many systems).\n");
     }
+    record_probe_cost("devices", now_ms() - t0);
+}
+
+/* Time the legacy popen pipelines against the native probes above */
+static void report_probe_costs(int compare_popen) {
+    print_header("Probe Cost (native vs popen)");
+    double native_total = 0, popen_total = 0;
+    char buf[BUF_SIZE];
+
+    if (compare_popen)
+        printf("%-10s %12s %12s\n", "probe", "native(ms)", "popen(ms)");
+    else
+        printf("%-10s %12s\n", "probe", "native(ms)");
+    for (int i = 0; probe_costs[i].name; ++i) {
+        native_total += probe_costs[i].native_ms;
+        if (compare_popen) {
+            double t0 = now_ms();
+            run_cmd(probe_costs[i].legacy_cmd, buf, sizeof(buf), 0);
+            double ms = now_ms() - t0;
+            popen_total += ms;
+            printf("%-10s %12.3f %12.3f\n", probe_costs[i].name, probe_costs[i].native_ms, ms);
+        } else {
+            printf("%-10s %12.3f\n", probe_costs[i].name, probe_costs[i].native_ms);
+        }
+    }
+    printf("%-10s %12.3f", "total", native_total);
+    if (compare_popen)
+        printf(" %12.3f  (%.1fx)", popen_total, native_total > 0 ? popen_total / native_total : 0.0);
+    printf("\n");
+}
+
+/*
+ * Watch mode: a lightweight agent loop. The four /proc sources stay open for
+ * the whole run and are re-read with pread() at offset 0, so each interval
+ * costs four syscalls plus parsing; deltas against the previous sample are
+ * streamed as one JSON object per line.
+ */
+#define WATCH_MAX_CPUS 512
+#define WATCH_MAX_DEVS 64
+#define WATCH_MAX_IFS  32
+#define WATCH_BUF_SIZE (64 * 1024)
+
+struct watch_cpu {
+    int id;                     /* N of "cpuN", -1 for the aggregate line */
+    unsigned long long user, nice, system, idle, iowait, irq, softirq, steal;
+};
+
+struct watch_disk {
+    char name[32];
+    unsigned long long rd_ios, rd_sectors, wr_ios, wr_sectors, io_ms;
+};
+
+struct watch_if {
+    char name[32];
+    unsigned long long rx_bytes, rx_packets, tx_bytes, tx_packets;
+};
+
+struct watch_sample {
+    struct timespec ts;
+    int ncpu;                   /* entry 0 is the aggregate "cpu" line; offline CPUs are absent */
+    struct watch_cpu cpu[WATCH_MAX_CPUS + 1];
+    unsigned long long mem_total_kb, mem_avail_kb, mem_free_kb, cached_kb, swap_total_kb, swap_free_kb;
+    int ndisk;
+    struct watch_disk disk[WATCH_MAX_DEVS];
+    int nif;
+    struct watch_if ifs[WATCH_MAX_IFS];
+};
+
+struct watch_ctx {
+    int fd_stat, fd_meminfo, fd_diskstats, fd_netdev;
+    char buf[WATCH_BUF_SIZE];
+};
+
+static volatile sig_atomic_t watch_stop;
+
+static void watch_on_signal(int sig) {
+    (void)sig;
+    watch_stop = 1;
+}
+
+/* Re-read a /proc file from offset 0 into ctx->buf; returns bytes or -1 */
+static ssize_t watch_pread(struct watch_ctx *ctx, int fd) {
+    size_t total = 0;
+    for (;;) {
+        ssize_t n = pread(fd, ctx->buf + total, sizeof(ctx->buf) - 1 - total, (off_t)total);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) break;
+        total += (size_t)n;
+        if (total >= sizeof(ctx->buf) - 1) break;
+    }
+    ctx->buf[total] = '\0';
+    return (ssize_t)total;
+}
+
+static void watch_parse_stat(const char *buf, struct watch_sample *s) {
+    const char *line = buf;
+    s->ncpu = 0;
+    while (line && strncmp(line, "cpu", 3) == 0 && s->ncpu <= WATCH_MAX_CPUS) {
+        struct watch_cpu *c = &s->cpu[s->ncpu];
+        char *p = (char *)line + 3;
+        memset(c, 0, sizeof(*c));
+        c->id = *p == ' ' ? -1 : (int)strtol(p, &p, 10);
+        if (sscanf(p, "%llu %llu %llu %llu %llu %llu %llu %llu",
+                   &c->user, &c->nice, &c->system, &c->idle,
+                   &c->iowait, &c->irq, &c->softirq, &c->steal) >= 4)
+            s->ncpu++;
+        line = strchr(line, '\n');
+        if (line) line++;
+    }
+}
+
+static void watch_parse_meminfo(const char *buf, struct watch_sample *s) {
+    static const struct {
+        const char *key;
+        size_t off;
+    } fields[] = {
+        {"MemTotal:",     offsetof(struct watch_sample, mem_total_kb)},
+        {"MemFree:",      offsetof(struct watch_sample, mem_free_kb)},
+        {"MemAvailable:", offsetof(struct watch_sample, mem_avail_kb)},
+        {"Cached:",       offsetof(struct watch_sample, cached_kb)},
+        {"SwapTotal:",    offsetof(struct watch_sample, swap_total_kb)},
+        {"SwapFree:",     offsetof(struct watch_sample, swap_free_kb)},
+    };
+    const char *line = buf;
+    size_t found = 0;
+    while (line && *line && found < sizeof(fields) / sizeof(fields[0])) {
+        for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); ++i) {
+            size_t kl = strlen(fields[i].key);
+            if (strncmp(line, fields[i].key, kl) == 0) {
+                *(unsigned long long *)((char *)s + fields[i].off) = strtoull(line + kl, NULL, 10);
+                found++;
+                break;
+            }
+        }
+        line = strchr(line, '\n');
+        if (line) line++;
+    }
+}
+
+static void watch_parse_diskstats(const char *buf, struct watch_sample *s) {
+    const char *line = buf;
+    s->ndisk = 0;
+    while (line && *line && s->ndisk < WATCH_MAX_DEVS) {
+        struct watch_disk *d = &s->disk[s->ndisk];
+        unsigned long long rd_merged, rd_ms, wr_merged, wr_ms, inflight;
+        if (sscanf(line, "%*u %*u %31s %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
+                   d->name, &d->rd_ios, &rd_merged, &d->rd_sectors, &rd_ms,
+                   &d->wr_ios, &wr_merged, &d->wr_sectors, &wr_ms, &inflight, &d->io_ms) == 11) {
+            /* idle pseudo devices (unused loop/ram) only add noise */
+            if (!((strncmp(d->name, "loop", 4) == 0 || strncmp(d->name, "ram", 3) == 0)
+                  && d->rd_ios == 0 && d->wr_ios == 0))
+                s->ndisk++;
+        }
+        line = strchr(line, '\n');
+        if (line) line++;
+    }
+}
+
+static void watch_parse_netdev(const char *buf, struct watch_sample *s) {
+    const char *line = buf;
+    s->nif = 0;
+    while (line && *line && s->nif < WATCH_MAX_IFS) {
+        const char *colon = strchr(line, ':');
+        const char *nl = strchr(line, '\n');
+        if (colon && (!nl || colon < nl)) {
+            struct watch_if *w = &s->ifs[s->nif];
+            const char *n = line;
+            while (*n == ' ') n++;
+            size_t len = (size_t)(colon - n);
+            if (len >= sizeof(w->name)) len = sizeof(w->name) - 1;
+            memcpy(w->name, n, len);
+            w->name[len] = '\0';
+            if (sscanf(colon + 1, "%llu %llu %*u %*u %*u %*u %*u %*u %llu %llu",
+                       &w->rx_bytes, &w->rx_packets, &w->tx_bytes, &w->tx_packets) == 4)
+                s->nif++;
+        }
+        line = nl ? nl + 1 : NULL;
+    }
+}
+
+static int watch_sample(struct watch_ctx *ctx, struct watch_sample *s) {
+    /* a key missing from /proc/meminfo (old kernels, containers) reads as 0, not stale memory */
+    memset(s, 0, sizeof(*s));
+    clock_gettime(CLOCK_MONOTONIC, &s->ts);
+    if (watch_pread(ctx, ctx->fd_stat) < 0) return -1;
+    watch_parse_stat(ctx->buf, s);
+    if (watch_pread(ctx, ctx->fd_meminfo) < 0) return -1;
+    watch_parse_meminfo(ctx->buf, s);
+    if (ctx->fd_diskstats >= 0 && watch_pread(ctx, ctx->fd_diskstats) >= 0)
+        watch_parse_diskstats(ctx->buf, s);
+    if (ctx->fd_netdev >= 0 && watch_pread(ctx, ctx->fd_netdev) >= 0)
+        watch_parse_netdev(ctx->buf, s);
+    return 0;
+}
+
+/* Counter delta clamped at 0: iowait can go backwards, and counters reset when a device reappears */
+static unsigned long long watch_delta(unsigned long long a, unsigned long long b) {
+    return b > a ? b - a : 0;
+}
+
+static void watch_emit_cpu(const struct watch_cpu *a, const struct watch_cpu *b) {
+    unsigned long long user = watch_delta(a->user, b->user) + watch_delta(a->nice, b->nice);
+    unsigned long long system = watch_delta(a->system, b->system) + watch_delta(a->irq, b->irq) +
+                                watch_delta(a->softirq, b->softirq);
+    unsigned long long steal = watch_delta(a->steal, b->steal);
+    unsigned long long iowait = watch_delta(a->iowait, b->iowait);
+    unsigned long long busy = user + system + steal;
+    double total = (double)(busy + iowait + watch_delta(a->idle, b->idle));
+    char id[16];
+    if (total <= 0) total = 1;
+    if (b->id < 0) snprintf(id, sizeof(id), "all");
+    else snprintf(id, sizeof(id), "%d", b->id);
+    printf("{\"id\":\"%s\",\"util\":%.2f,\"user\":%.2f,\"system\":%.2f,\"iowait\":%.2f,\"steal\":%.2f}",
+           id, 100.0 * busy / total, 100.0 * user / total, 100.0 * system / total,
+           100.0 * iowait / total, 100.0 * steal / total);
+}
+
+static void watch_emit(const struct watch_sample *a, const struct watch_sample *b, double self_cpu_pct) {
+    double dt = (b->ts.tv_sec - a->ts.tv_sec) + (b->ts.tv_nsec - a->ts.tv_nsec) / 1e9;
+    struct timespec wall;
+    clock_gettime(CLOCK_REALTIME, &wall);
+    if (dt <= 0) dt = 1e-9;
+
+    printf("{\"ts\":%ld.%03ld,\"interval_s\":%.3f,\"cpu\":[",
+           (long)wall.tv_sec, wall.tv_nsec / 1000000, dt);
+    /* matched by CPU number: a CPU going offline or online shifts the array */
+    int first = 1;
+    for (int i = 0; i < b->ncpu; ++i) {
+        const struct watch_cpu *ca = NULL;
+        if (i < a->ncpu && a->cpu[i].id == b->cpu[i].id) ca = &a->cpu[i];
+        for (int j = 0; !ca && j < a->ncpu; ++j)
+            if (a->cpu[j].id == b->cpu[i].id) ca = &a->cpu[j];
+        if (!ca) continue;
+        if (!first) putchar(',');
+        watch_emit_cpu(ca, &b->cpu[i]);
+        first = 0;
+    }
+    printf("],\"mem\":{\"total_kb\":%llu,\"available_kb\":%llu,\"free_kb\":%llu,"
+           "\"cached_kb\":%llu,\"swap_used_kb\":%llu}",
+           b->mem_total_kb, b->mem_avail_kb, b->mem_free_kb, b->cached_kb,
+           b->swap_total_kb - b->swap_free_kb);
+
+    printf(",\"disk\":[");
+    first = 1;
+    for (int i = 0; i < b->ndisk; ++i) {
+        const struct watch_disk *db = &b->disk[i], *da = NULL;
+        for (int j = 0; j < a->ndisk; ++j)
+            if (strcmp(a->disk[j].name, db->name) == 0) { da = &a->disk[j]; break; }
+        if (!da) continue;
+        printf("%s{\"dev\":\"%s\",\"rd_iops\":%.1f,\"wr_iops\":%.1f,\"rd_Bps\":%.0f,\"wr_Bps\":%.0f,\"busy_pct\":%.1f}",
+               first ? "" : ",", db->name,
+               watch_delta(da->rd_ios, db->rd_ios) / dt, watch_delta(da->wr_ios, db->wr_ios) / dt,
+               watch_delta(da->rd_sectors, db->rd_sectors) * 512.0 / dt,
+               watch_delta(da->wr_sectors, db->wr_sectors) * 512.0 / dt,
+               watch_delta(da->io_ms, db->io_ms) / (dt * 10.0));
+        first = 0;
+    }
+
+    printf("],\"net\":[");
+    first = 1;
+    for (int i = 0; i < b->nif; ++i) {
+        const struct watch_if *ib = &b->ifs[i], *ia = NULL;
+        for (int j = 0; j < a->nif; ++j)
+            if (strcmp(a->ifs[j].name, ib->name) == 0) { ia = &a->ifs[j]; break; }
+        if (!ia) continue;
+        printf("%s{\"if\":\"%s\",\"rx_Bps\":%.0f,\"tx_Bps\":%.0f,\"rx_pps\":%.1f,\"tx_pps\":%.1f}",
+               first ? "" : ",", ib->name,
+               watch_delta(ia->rx_bytes, ib->rx_bytes) / dt, watch_delta(ia->tx_bytes, ib->tx_bytes) / dt,
+               watch_delta(ia->rx_packets, ib->rx_packets) / dt,
+               watch_delta(ia->tx_packets, ib->tx_packets) / dt);
+        first = 0;
+    }
+    printf("],\"self_cpu_pct\":%.3f}\n", self_cpu_pct);
+    fflush(stdout);
+}
+
+static double process_cpu_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int run_watch(double interval_s, long count) {
+    struct watch_ctx *ctx = malloc(sizeof(*ctx));
+    struct watch_sample *prev = malloc(sizeof(*prev));
+    struct watch_sample *cur = malloc(sizeof(*cur));
+    int rc = 0;
+
+    if (!ctx || !prev || !cur) {
+        fprintf(stderr, "watch: out of memory\n");
+        free(ctx); free(prev); free(cur);
+        return 1;
+    }
+    ctx->fd_stat = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    ctx->fd_meminfo = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+    ctx->fd_diskstats = open("/proc/diskstats", O_RDONLY | O_CLOEXEC);
+    ctx->fd_netdev = open("/proc/net/dev", O_RDONLY | O_CLOEXEC);
+    if (ctx->fd_stat < 0 || ctx->fd_meminfo < 0) {
+        fprintf(stderr, "watch: unable to open /proc/stat or /proc/meminfo: %s\n", strerror(errno));
+        rc = 1;
+        goto out;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = watch_on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    if (watch_sample(ctx, prev) != 0) {
+        fprintf(stderr, "watch: initial sample failed: %s\n", strerror(errno));
+        rc = 1;
+        goto out;
+    }
+
+    /* absolute deadlines so the period does not drift with sampling cost */
+    struct timespec next = prev->ts;
+    long period_ns = (long)(interval_s * 1e9);
+    double cpu_prev = process_cpu_seconds();
+    for (long n = 0; !watch_stop && (count <= 0 || n < count); ++n) {
+        next.tv_sec += period_ns / 1000000000L;
+        next.tv_nsec += period_ns % 1000000000L;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000L;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR)
+            if (watch_stop) goto out;
+
+        if (watch_sample(ctx, cur) != 0) {
+            fprintf(stderr, "watch: sample failed: %s\n", strerror(errno));
+            rc = 1;
+            break;
+        }
+        double cpu_now = process_cpu_seconds();
+        double wall = (cur->ts.tv_sec - prev->ts.tv_sec) + (cur->ts.tv_nsec - prev->ts.tv_nsec) / 1e9;
+        watch_emit(prev, cur, wall > 0 ? 100.0 * (cpu_now - cpu_prev) / wall : 0.0);
+        cpu_prev = cpu_now;
+
+        struct watch_sample *tmp = prev;
+        prev = cur;
+        cur = tmp;
+    }
+
+out:
+    if (ctx->fd_stat >= 0) close(ctx->fd_stat);
+    if (ctx->fd_meminfo >= 0) close(ctx->fd_meminfo);
+    if (ctx->fd_diskstats >= 0) close(ctx->fd_diskstats);
+    if (ctx->fd_netdev >= 0) close(ctx->fd_netdev);
+    free(ctx);
+    free(prev);
+    free(cur);
+    return rc;
+}
+
+/*
+ * Bench mode: hardware micro-benchmarks for board qualification. Every
+ * result is one NDJSON line on stdout ({"bench","threads","value","unit",
+ * "better"}), so a run redirected to a file is itself a baseline; passing
+ * it back with --baseline flags results that moved the wrong way by more
+ * than --regress-pct. Progress and the regression report go to stderr.
+ */
+#define BENCH_STREAM_ELEMS  (4 * 1024 * 1024)   /* minimum doubles per array, split across threads */
+#define BENCH_STREAM_LLC_X  4                   /* each array is at least this many times the LLC */
+#define BENCH_STREAM_REPS   4
+#define BENCH_CHASE_LOADS   (4 * 1024 * 1024)
+#define BENCH_SYSCALLS      (1 * 1024 * 1024)
+#define BENCH_PINGPONGS     (50 * 1000)
+#define BENCH_DISK_MB       64
+#define BENCH_DISK_BLOCK    (1024 * 1024)
+#define BENCH_DISK_RANDOM   4096
+#define BENCH_DISK_ALIGN    4096                /* O_DIRECT offset and length granularity */
+#define BENCH_DISK_RAND_OPS 4096
+#define BENCH_MAX_RESULTS   256
+#define BENCH_MAX_THREADS   256
+
+enum {
+    BENCH_MEM  = 1 << 0,
+    BENCH_LAT  = 1 << 1,
+    BENCH_SYS  = 1 << 2,
+    BENCH_DISK = 1 << 3,
+    BENCH_ALL  = BENCH_MEM | BENCH_LAT | BENCH_SYS | BENCH_DISK,
+};
+
+struct bench_result {
+    char name[48];
+    int threads;
+    double value;
+    const char *unit;
+    int higher_better;
+};
+
+static struct bench_result bench_results[BENCH_MAX_RESULTS];
+static int bench_nresults;
+
+/* Start barrier whose count can drop when a thread fails to start */
+struct bench_gate {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int waiting, need;
+};
+
+struct bench_worker {
+    pthread_t tid;
+    int index;
+    int nthreads;
+    struct bench_gate *start;
+    void *shared;               /* per-benchmark shared state */
+    double t_start, t_end;      /* ms, taken after the start barrier */
+    double work;                /* bytes moved / ops done by this thread */
+    int err;                    /* errno of a failed operation, 0 if none */
+};
+
+static void bench_record(const char *name, int threads, double value, const char *unit, int higher_better) {
+    if (bench_nresults < BENCH_MAX_RESULTS) {
+        struct bench_result *r = &bench_results[bench_nresults++];
+        snprintf(r->name, sizeof(r->name), "%s", name);
+        r->threads = threads;
+        r->value = value;
+        r->unit = unit;
+        r->higher_better = higher_better;
+    }
+    printf("{\"bench\":\"%s\",\"threads\":%d,\"value\":%.3f,\"unit\":\"%s\",\"better\":\"%s\"}\n",
+           name, threads, value, unit, higher_better ? "higher" : "lower");
+    fflush(stdout);
+    fprintf(stderr, "  %-16s x%-3d %12.3f %s\n", name, threads, value, unit);
+}
+
+static void bench_gate_wait(struct bench_gate *g) {
+    pthread_mutex_lock(&g->lock);
+    if (++g->waiting >= g->need)
+        pthread_cond_broadcast(&g->cond);
+    while (g->waiting < g->need)
+        pthread_cond_wait(&g->cond, &g->lock);
+    pthread_mutex_unlock(&g->lock);
+}
+
+/*
+ * Start nthreads copies of fn behind a barrier; returns aggregate wall time
+ * in ms, or -1 if not every thread could be created (the ones that did are
+ * released, joined and their results discarded).
+ */
+static double bench_run_threads(int nthreads, void *(*fn)(void *), void *shared, struct bench_worker *w) {
+    struct bench_gate start = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, nthreads};
+    double first = 0, last = 0;
+    int started, err = 0;
+
+    for (started = 0; started < nthreads; ++started) {
+        w[started].index = started;
+        w[started].nthreads = nthreads;
+        w[started].start = &start;
+        w[started].shared = shared;
+        w[started].work = 0;
+        w[started].err = 0;
+        err = pthread_create(&w[started].tid, NULL, fn, &w[started]);
+        if (err != 0) break;
+    }
+    if (err != 0) {
+        fprintf(stderr, "  bench: thread %d of %d: %s\n", started + 1, nthreads, strerror(err));
+        pthread_mutex_lock(&start.lock);
+        start.need = started;
+        pthread_cond_broadcast(&start.cond);
+        pthread_mutex_unlock(&start.lock);
+    }
+    for (int i = 0; i < started; ++i) {
+        pthread_join(w[i].tid, NULL);
+        if (i == 0 || w[i].t_start < first) first = w[i].t_start;
+        if (i == 0 || w[i].t_end > last) last = w[i].t_end;
+    }
+    pthread_cond_destroy(&start.cond);
+    pthread_mutex_destroy(&start.lock);
+    return err != 0 ? -1 : last - first;
+}
+
+static uint64_t bench_xorshift(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *s = x;
+}
+
+/* --- memory bandwidth (STREAM copy / scale / triad) --- */
+enum { STREAM_COPY, STREAM_SCALE, STREAM_TRIAD };
+
+struct stream_bench {
+    int kernel;
+    size_t elems;               /* doubles per array, all threads together */
+};
+
+/*
+ * Size in bytes of cpu0's data or unified cache at level 1..3, or of the
+ * largest one for level 0; 0 if unknown. sysfs first: sysconf reports 0 on
+ * most ARM boards.
+ */
+static size_t bench_cache_bytes(int level) {
+    char path[128];
+    long best = 0;
+    for (int idx = 0; idx < 16; ++idx) {
+        char type[32];
+        long kb;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/type", idx);
+        if (read_sysfs_str(path, type, sizeof(type)) != 0) break;
+        if (strcmp(type, "Instruction") == 0) continue;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/level", idx);
+        if (level && read_sysfs_long(path, 0) != level) continue;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", idx);
+        kb = read_sysfs_long(path, 0);      /* "32768K" parses as 32768 */
+        if (kb * 1024 > best) best = kb * 1024;
+    }
+    if (best <= 0) {
+        switch (level) {
+        case 1: best = sysconf(_SC_LEVEL1_DCACHE_SIZE); break;
+        case 2: best = sysconf(_SC_LEVEL2_CACHE_SIZE); break;
+        case 3: best = sysconf(_SC_LEVEL3_CACHE_SIZE); break;
+        default:
+            best = sysconf(_SC_LEVEL3_CACHE_SIZE);
+            if (best <= 0) best = sysconf(_SC_LEVEL2_CACHE_SIZE);
+            break;
+        }
+    }
+    return best > 0 ? (size_t)best : 0;
+}
+
+static void *bench_stream_worker(void *arg) {
+    struct bench_worker *w = arg;
+    const struct stream_bench *sb = w->shared;
+    int kernel = sb->kernel;
+    size_t n = sb->elems / (size_t)w->nthreads;
+    double *a = malloc(n * sizeof(double));
+    double *b = malloc(n * sizeof(double));
+    double *c = malloc(n * sizeof(double));
+    const double s = 3.0;
+
+    if (!a || !b || !c) {
+        free(a); free(b); free(c);
+        bench_gate_wait(w->start);
+        w->t_start = w->t_end = now_ms();
+        return NULL;
+    }
+    /* first touch from the owning thread keeps pages NUMA-local */
+    for (size_t i = 0; i < n; ++i) { a[i] = 1.0; b[i] = 2.0; c[i] = 0.0; }
+
+    bench_gate_wait(w->start);
+    w->t_start = now_ms();
+    for (int r = 0; r < BENCH_STREAM_REPS; ++r) {
+        switch (kernel) {
+        case STREAM_COPY:
+            for (size_t i = 0; i < n; ++i) c[i] = a[i];
+            break;
+        case STREAM_SCALE:
+            for (size_t i = 0; i < n; ++i) b[i] = s * c[i];
+            break;
+        default:
+            for (size_t i = 0; i < n; ++i) a[i] = b[i] + s * c[i];
+            break;
+        }
+        __asm__ __volatile__("" ::: "memory");
+    }
+    w->t_end = now_ms();
+    w->work = (double)n * BENCH_STREAM_REPS * sizeof(double) * (kernel == STREAM_TRIAD ? 3 : 2);
+    free(a); free(b); free(c);
+    return NULL;
+}
+
+static void bench_memory(const int *thread_counts, int nthread_counts, struct bench_worker *w) {
+    static const char *names[] = {"mem.copy", "mem.scale", "mem.triad"};
+    struct stream_bench sb = {STREAM_COPY, BENCH_STREAM_ELEMS};
+    size_t llc = bench_cache_bytes(0);
+
+    /* arrays that fit in the LLC would measure the cache, not DRAM */
+    if (llc * BENCH_STREAM_LLC_X / sizeof(double) > sb.elems)
+        sb.elems = llc * BENCH_STREAM_LLC_X / sizeof(double);
+    fprintf(stderr, "  mem: 3 x %zu MB arrays (LLC %zu KB)\n", sb.elems * sizeof(double) >> 20, llc >> 10);
+    for (sb.kernel = STREAM_COPY; sb.kernel <= STREAM_TRIAD; ++sb.kernel) {
+        for (int t = 0; t < nthread_counts; ++t) {
+            int n = thread_counts[t];
+            double ms = bench_run_threads(n, bench_stream_worker, &sb, w);
+            double bytes = 0;
+            if (ms < 0) continue;
+            for (int i = 0; i < n; ++i) bytes += w[i].work;
+            bench_record(names[sb.kernel], n, ms > 0 ? bytes / (ms / 1000.0) / 1e6 : 0, "MB/s", 1);
+        }
+    }
+}
+
+/* --- pointer-chasing latency --- */
+struct chase_node {
+    struct chase_node *next;
+    char pad[64 - sizeof(void *)];
+};
+
+struct chase_chain {
+    struct chase_node *nodes;
+    size_t count;
+};
+
+/* Sattolo's algorithm: one random cycle through every line, defeating prefetch */
+static int chase_build(struct chase_chain *ch, size_t bytes) {
+    size_t n = bytes / sizeof(struct chase_node);
+    size_t *order;
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;
+
+    if (n < 2) n = 2;
+    if (posix_memalign((void **)&ch->nodes, 4096, n * sizeof(struct chase_node)) != 0)
+        return -1;
+    order = malloc(n * sizeof(*order));
+    if (!order) {
+        free(ch->nodes);
+        return -1;
+    }
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    for (size_t i = n - 1; i > 0; --i) {
+        size_t j = (size_t)(bench_xorshift(&seed) % i);
+        size_t tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+    }
+    for (size_t i = 0; i < n; ++i)
+        ch->nodes[order[i]].next = &ch->nodes[order[(i + 1) % n]];
+    ch->count = n;
+    free(order);
+    return 0;
+}
+
+static void *bench_chase_worker(void *arg) {
+    struct bench_worker *w = arg;
+    struct chase_chain *ch = w->shared;
+    /* threads share one chain but start on different lines */
+    struct chase_node *p = &ch->nodes[(ch->count / (size_t)w->nthreads) * (size_t)w->index];
+
+    for (size_t i = 0; i < ch->count; ++i) p = p->next;   /* warm up */
+    bench_gate_wait(w->start);
+    w->t_start = now_ms();
+    for (long i = 0; i < BENCH_CHASE_LOADS; ++i) p = p->next;
+    w->t_end = now_ms();
+    __asm__ __volatile__("" :: "r"(p));
+    w->work = (w->t_end - w->t_start) * 1e6 / BENCH_CHASE_LOADS;   /* ns per load */
+    return NULL;
+}
+
+static void bench_latency(const int *thread_counts, int nthread_counts, struct bench_worker *w) {
+    long l1 = (long)bench_cache_bytes(1);
+    long l2 = (long)bench_cache_bytes(2);
+    long l3 = (long)bench_cache_bytes(3);
+    if (l1 <= 0) l1 = 32 * 1024;
+    if (l2 <= 0) l2 = 512 * 1024;
+    if (l3 <= 0) l3 = 8 * 1024 * 1024;
+
+    /* half of each level stays resident; DRAM is well past the last level */
+    const struct { const char *name; size_t bytes; } sizes[] = {
+        {"lat.L1",   (size_t)l1 / 2},
+        {"lat.L2",   (size_t)l2 / 2},
+        {"lat.L3",   (size_t)l3 / 2},
+        {"lat.DRAM", (size_t)(l3 * 4 > 64L * 1024 * 1024 ? l3 * 4 : 64L * 1024 * 1024)},
+    };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        struct chase_chain ch;
+        if (chase_build(&ch, sizes[s].bytes) != 0) {
+            fprintf(stderr, "  %s: allocation of %zu bytes failed\n", sizes[s].name, sizes[s].bytes);
+            continue;
+        }
+        for (int t = 0; t < nthread_counts; ++t) {
+            int n = thread_counts[t];
+            double ns = 0;
+            if (bench_run_threads(n, bench_chase_worker, &ch, w) < 0) continue;
+            for (int i = 0; i < n; ++i) ns += w[i].work;
+            bench_record(sizes[s].name, n, ns / n, "ns", 0);
+        }
+        free(ch.nodes);
+    }
+}
+
+/* --- syscall and context-switch latency --- */
+static void *bench_syscall_worker(void *arg) {
+    struct bench_worker *w = arg;
+    bench_gate_wait(w->start);
+    w->t_start = now_ms();
+    for (long i = 0; i < BENCH_SYSCALLS; ++i)
+        syscall(SYS_getppid);
+    w->t_end = now_ms();
+    w->work = (w->t_end - w->t_start) * 1e6 / BENCH_SYSCALLS;
+    return NULL;
+}
+
+struct pingpong {
+    int to_peer[2], from_peer[2];
+    int cpu;
+};
+
+static void bench_pin(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+static void *bench_pong(void *arg) {
+    struct pingpong *pp = arg;
+    char c;
+    bench_pin(pp->cpu);
+    while (read(pp->to_peer[0], &c, 1) == 1) {
+        if (write(pp->from_peer[1], &c, 1) != 1) break;
+    }
+    return NULL;
+}
+
+/* Each worker ping-pongs with a partner pinned to the same CPU, so every hop is a switch */
+static void *bench_ctxsw_worker(void *arg) {
+    struct bench_worker *w = arg;
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    struct pingpong pp;
+    pthread_t peer;
+    char c = 'x';
+
+    pp.cpu = (int)(w->index % (ncpu > 0 ? ncpu : 1));
+    if (pipe(pp.to_peer) != 0) {
+        bench_gate_wait(w->start);
+        w->t_start = w->t_end = now_ms();
+        return NULL;
+    }
+    if (pipe(pp.from_peer) != 0) {
+        close(pp.to_peer[0]);
+        close(pp.to_peer[1]);
+        bench_gate_wait(w->start);
+        w->t_start = w->t_end = now_ms();
+        return NULL;
+    }
+    bench_pin(pp.cpu);
+    /* without the partner every write would wait for a reply forever */
+    if (pthread_create(&peer, NULL, bench_pong, &pp) != 0) {
+        close(pp.to_peer[0]);
+        close(pp.to_peer[1]);
+        close(pp.from_peer[0]);
+        close(pp.from_peer[1]);
+        bench_gate_wait(w->start);
+        w->t_start = w->t_end = now_ms();
+        return NULL;
+    }
+
+    bench_gate_wait(w->start);
+    w->t_start = now_ms();
+    for (long i = 0; i < BENCH_PINGPONGS; ++i) {
+        if (write(pp.to_peer[1], &c, 1) != 1 || read(pp.from_peer[0], &c, 1) != 1) break;
+    }
+    w->t_end = now_ms();
+    w->work = (w->t_end - w->t_start) * 1e6 / (2.0 * BENCH_PINGPONGS);
+
+    close(pp.to_peer[1]);
+    pthread_join(peer, NULL);
+    close(pp.to_peer[0]);
+    close(pp.from_peer[0]);
+    close(pp.from_peer[1]);
+    return NULL;
+}
+
+static void bench_syscalls(const int *thread_counts, int nthread_counts, struct bench_worker *w) {
+    for (int t = 0; t < nthread_counts; ++t) {
+        int n = thread_counts[t];
+        double ns = 0;
+        if (bench_run_threads(n, bench_syscall_worker, NULL, w) < 0) continue;
+        for (int i = 0; i < n; ++i) ns += w[i].work;
+        bench_record("sys.syscall", n, ns / n, "ns", 0);
+    }
+    for (int t = 0; t < nthread_counts; ++t) {
+        int n = thread_counts[t];
+        double ns = 0;
+        if (bench_run_threads(n, bench_ctxsw_worker, NULL, w) < 0) continue;
+        for (int i = 0; i < n; ++i) ns += w[i].work;
+        bench_record("sys.ctxswitch", n, ns / n, "ns", 0);
+    }
+}
+
+/* --- disk throughput on an unlinked temp file --- */
+enum { DISK_SEQ_WRITE, DISK_SEQ_READ, DISK_RAND_READ };
+
+struct disk_bench {
+    int fd;
+    int mode;
+    size_t file_size;
+};
+
+static void *bench_disk_worker(void *arg) {
+    struct bench_worker *w = arg;
+    struct disk_bench *db = w->shared;
+    /* O_DIRECT wants aligned offsets: each thread's region is a whole number of blocks */
+    size_t span = db->file_size / (size_t)w->nthreads / BENCH_DISK_ALIGN * BENCH_DISK_ALIGN;
+    size_t block;
+    off_t base;
+    uint64_t seed = 0x2545f4914f6cdd1dULL + (uint64_t)w->index;
+    void *buf;
+
+    if (span < BENCH_DISK_ALIGN) span = BENCH_DISK_ALIGN;
+    block = db->mode == DISK_RAND_READ ? BENCH_DISK_RANDOM
+          : span < BENCH_DISK_BLOCK ? span : BENCH_DISK_BLOCK;
+    span -= span % block;
+    base = (off_t)span * w->index;
+
+    if (posix_memalign(&buf, BENCH_DISK_ALIGN, block) != 0) {
+        w->err = ENOMEM;
+        bench_gate_wait(w->start);
+        w->t_start = w->t_end = now_ms();
+        return NULL;
+    }
+    memset(buf, 0xa5, block);
+
+    bench_gate_wait(w->start);
+    w->t_start = now_ms();
+    if (db->mode == DISK_RAND_READ) {
+        size_t blocks = db->file_size / block;
+        long ops = BENCH_DISK_RAND_OPS / w->nthreads;
+        for (long i = 0; i < ops; ++i) {
+            off_t off = (off_t)(bench_xorshift(&seed) % blocks) * (off_t)block;
+            ssize_t n = pread(db->fd, buf, block, off);
+            if (n != (ssize_t)block) {
+                w->err = n < 0 ? errno : EIO;
+                break;
+            }
+            w->work += 1;
+        }
+    } else {
+        for (size_t done = 0; done + block <= span; done += block) {
+            ssize_t n = db->mode == DISK_SEQ_WRITE
+                ? pwrite(db->fd, buf, block, base + (off_t)done)
+                : pread(db->fd, buf, block, base + (off_t)done);
+            if (n != (ssize_t)block) {
+                w->err = n < 0 ? errno : EIO;
+                break;
+            }
+            w->work += (double)block;
+        }
+        if (db->mode == DISK_SEQ_WRITE && fdatasync(db->fd) != 0 && !w->err)
+            w->err = errno;
+    }
+    w->t_end = now_ms();
+    free(buf);
+    return NULL;
+}
+
+/* Returns the number of data points that failed; none of them is recorded */
+static int bench_disk(const char *dir, const int *thread_counts, int nthread_counts, struct bench_worker *w) {
+    char path[PATH_MAX];
+    struct disk_bench db;
+    int failed = 0;
+
+    snprintf(path, sizeof(path), "%s/lnp_bench_XXXXXX", dir);
+    db.fd = mkstemp(path);
+    if (db.fd < 0) {
+        fprintf(stderr, "  disk: unable to create temp file in %s: %s\n", dir, strerror(errno));
+        return 1;
+    }
+    unlink(path);
+    /* O_DIRECT bypasses the page cache; tmpfs and some overlays refuse it */
+    int fl = fcntl(db.fd, F_GETFL);
+    if (fcntl(db.fd, F_SETFL, fl | O_DIRECT) != 0) {
+        fprintf(stderr, "  disk: O_DIRECT not supported in %s, results include page cache\n", dir);
+    }
+    db.file_size = (size_t)BENCH_DISK_MB * 1024 * 1024;
+
+    static const struct { const char *name; int mode; const char *unit; } tests[] = {
+        {"disk.seq_write", DISK_SEQ_WRITE, "MB/s"},
+        {"disk.seq_read",  DISK_SEQ_READ,  "MB/s"},
+        {"disk.rand_read", DISK_RAND_READ, "IOPS"},
+    };
+    for (size_t k = 0; k < sizeof(tests) / sizeof(tests[0]); ++k) {
+        db.mode = tests[k].mode;
+        for (int t = 0; t < nthread_counts; ++t) {
+            int n = thread_counts[t], err = 0;
+            double work = 0;
+            double ms = bench_run_threads(n, bench_disk_worker, &db, w);
+            if (ms < 0) continue;
+            for (int i = 0; i < n; ++i) {
+                work += w[i].work;
+                if (w[i].err && !err) {
+                    err = w[i].err;
+                    fprintf(stderr, "  %s x%d: thread %d: %s\n", tests[k].name, n, i, strerror(err));
+                }
+            }
+            /* a partial run would record only the threads that got through */
+            if (err) {
+                ++failed;
+                continue;
+            }
+            double rate = ms > 0 ? work / (ms / 1000.0) : 0;
+            if (db.mode != DISK_RAND_READ) rate /= 1e6;
+            bench_record(tests[k].name, n, rate, tests[k].unit, 1);
+        }
+    }
+    close(db.fd);
+    return failed;
+}
+
+/* Exit statuses of --bench/--devbench with --baseline */
+#define BENCH_EXIT_REGRESSION   3
+#define BENCH_EXIT_NO_BASELINE  4
+#define BENCH_EXIT_FAILED       5       /* a benchmark failed and recorded nothing */
+#define BENCH_BASELINE_ERROR    (-1)
+
+/* Compare against a previous --bench run; returns the number of regressions or BENCH_BASELINE_ERROR */
+static int bench_compare_baseline(const char *path, double regress_pct) {
+    FILE *f = fopen(path, "r");
+    char line[512];
+    int regressions = 0, compared = 0;
+
+    if (!f) {
+        fprintf(stderr, "baseline %s: %s\n", path, strerror(errno));
+        return BENCH_BASELINE_ERROR;
+    }
+    fprintf(stderr, "\nBaseline comparison against %s (threshold %.1f%%):\n", path, regress_pct);
+    while (fgets(line, sizeof(line), f)) {
+        char name[48];
+        int threads;
+        double base;
+        char *p = strstr(line, "\"bench\":\"");
+        char *t = strstr(line, "\"threads\":");
+        char *v = strstr(line, "\"value\":");
+        if (!p || !t || !v) continue;
+        if (sscanf(p + 9, "%47[^\"]", name) != 1 || sscanf(t + 10, "%d", &threads) != 1
+            || sscanf(v + 8, "%lf", &base) != 1)
+            continue;
+        for (int i = 0; i < bench_nresults; ++i) {
+            struct bench_result *r = &bench_results[i];
+            if (r->threads != threads || strcmp(r->name, name) != 0) continue;
+            double delta = base != 0 ? 100.0 * (r->value - base) / base : 0;
+            int worse = r->higher_better ? (delta < -regress_pct) : (delta > regress_pct);
+            compared++;
+            if (worse) regressions++;
+            fprintf(stderr, "  %-16s x%-3d %12.3f -> %12.3f %s (%+.1f%%)%s\n",
+                    name, threads, base, r->value, r->unit, delta, worse ? "  REGRESSION" : "");
+            break;
+        }
+    }
+    if (ferror(f)) {
+        fprintf(stderr, "baseline %s: read error\n", path);
+        fclose(f);
+        return BENCH_BASELINE_ERROR;
+    }
+    fclose(f);
+    fprintf(stderr, "%d result(s) compared, %d regression(s)\n", compared, regressions);
+    return regressions;
+}
+
+static int parse_bench_groups(const char *spec) {
+    int mask = 0;
+    char tmp[128];
+    char *tok, *save = NULL;
+
+    if (!spec || !*spec) return BENCH_ALL;
+    snprintf(tmp, sizeof(tmp), "%s", spec);
+    for (tok = strtok_r(tmp, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        if (strcmp(tok, "mem") == 0) mask |= BENCH_MEM;
+        else if (strcmp(tok, "lat") == 0) mask |= BENCH_LAT;
+        else if (strcmp(tok, "sys") == 0) mask |= BENCH_SYS;
+        else if (strcmp(tok, "disk") == 0) mask |= BENCH_DISK;
+        else if (strcmp(tok, "all") == 0) mask |= BENCH_ALL;
+        else return -1;
+    }
+    return mask;
+}
+
+static int run_bench(int groups, int max_threads, const char *dir, const char *baseline, double regress_pct) {
+    struct bench_worker *w;
+    int thread_counts[32];
+    int ncounts = 0, failed = 0;
+
+    if (max_threads <= 0) max_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (max_threads <= 0) max_threads = 1;
+    if (max_threads > BENCH_MAX_THREADS) max_threads = BENCH_MAX_THREADS;
+    /* 1, 2, 4, ... plus the exact maximum for the scaling curve */
+    for (int n = 1; n < max_threads && ncounts < 31; n *= 2)
+        thread_counts[ncounts++] = n;
+    thread_counts[ncounts++] = max_threads;
+
+    w = calloc((size_t)max_threads, sizeof(*w));
+    if (!w) {
+        fprintf(stderr, "bench: out of memory\n");
+        return 1;
+    }
+    fprintf(stderr, "=== Linus Neural Project — TestingSystem bench (up to %d threads) ===\n", max_threads);
+    if (groups & BENCH_MEM) bench_memory(thread_counts, ncounts, w);
+    if (groups & BENCH_LAT) bench_latency(thread_counts, ncounts, w);
+    if (groups & BENCH_SYS) bench_syscalls(thread_counts, ncounts, w);
+    if (groups & BENCH_DISK) failed += bench_disk(dir, thread_counts, ncounts, w);
+    free(w);
+    if (failed)
+        fprintf(stderr, "bench: %d result(s) not recorded because of errors\n", failed);
+
+    if (baseline) {
+        int regressions = bench_compare_baseline(baseline, regress_pct);
+        if (regressions == BENCH_BASELINE_ERROR) return BENCH_EXIT_NO_BASELINE;
+        if (regressions != 0) return BENCH_EXIT_REGRESSION;
+    }
+    return failed ? BENCH_EXIT_FAILED : 0;
+}
+
+/*
+ * Device-node bench: sustained reads from the project's driver nodes for a
+ * fixed duration. Character devices report throughput and per-read latency
+ * percentiles; evdev nodes report event rate and the delay from the kernel
+ * event timestamp to the moment userspace holds the event. Results go
+ * through bench_record(), so --baseline turns a run into a regression gate.
+ */
+#define DEVBENCH_READ_SIZE   4096
+#define DEVBENCH_MAX_SAMPLES (1 << 22)
+
+struct lat_samples {
+    uint32_t *ns;
+    size_t count;
+    size_t cap;
+};
+
+static void lat_add(struct lat_samples *l, double ns) {
+    if (l->count == l->cap) {
+        size_t cap = l->cap ? l->cap * 2 : 4096;
+        if (cap > DEVBENCH_MAX_SAMPLES) return;
+        uint32_t *p = realloc(l->ns, cap * sizeof(*p));
+        if (!p) return;
+        l->ns = p;
+        l->cap = cap;
+    }
+    l->ns[l->count++] = ns > 4e9 ? 4000000000u : (uint32_t)ns;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Percentile in microseconds; samples must already be sorted */
+static double lat_pct_us(const struct lat_samples *l, double pct) {
+    if (l->count == 0) return 0;
+    size_t idx = (size_t)(pct / 100.0 * (double)(l->count - 1) + 0.5);
+    return l->ns[idx] / 1000.0;
+}
+
+static void devbench_report_latency(const char *prefix, const char *what, struct lat_samples *l) {
+    static const struct { const char *name; double pct; } pcts[] = {
+        {"p50", 50.0}, {"p90", 90.0}, {"p99", 99.0}, {"p999", 99.9}, {"max", 100.0},
+    };
+    char name[48];
+    qsort(l->ns, l->count, sizeof(*l->ns), cmp_u32);
+    for (size_t i = 0; i < sizeof(pcts) / sizeof(pcts[0]); ++i) {
+        snprintf(name, sizeof(name), "%s.%s_%s", prefix, what, pcts[i].name);
+        bench_record(name, 1, lat_pct_us(l, pcts[i].pct), "us", 0);
+    }
+}
+
+/* Wait until fd is readable or the deadline passes; returns 1 when readable */
+static int devbench_wait(int fd, double deadline_ms) {
+    double left = deadline_ms - now_ms();
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    if (left <= 0) return 0;
+    return poll(&pfd, 1, (int)left + 1) > 0 && (pfd.revents & POLLIN);
+}
+
+static void devbench_evdev(int fd, const char *prefix, double seconds) {
+    struct input_event ev[64];
+    struct lat_samples delay = {0};
+    int clk = CLOCK_MONOTONIC;
+    long events = 0, reports = 0;
+    double start, deadline;
+
+    /* stamp events with the clock we compare against */
+    if (ioctl(fd, EVIOCSCLOCKID, &clk) != 0) clk = CLOCK_REALTIME;
+
+    start = now_ms();
+    deadline = start + seconds * 1000.0;
+    while (now_ms() < deadline) {
+        ssize_t n = read(fd, ev, sizeof(ev));
+        if (n < 0) {
+            if (errno == EAGAIN && devbench_wait(fd, deadline)) continue;
+            if (errno == EAGAIN || errno == EINTR) continue;
+            fprintf(stderr, "  %s: read failed: %s\n", prefix, strerror(errno));
+            break;
+        }
+        struct timespec now;
+        clock_gettime(clk, &now);
+        for (size_t i = 0; i < (size_t)n / sizeof(ev[0]); ++i) {
+            events++;
+            if (ev[i].type != EV_SYN || ev[i].code != SYN_REPORT) continue;
+            reports++;
+            double ns = (now.tv_sec - ev[i].input_event_sec) * 1e9
+                        + (now.tv_nsec - ev[i].input_event_usec * 1000.0);
+            lat_add(&delay, ns > 0 ? ns : 0);
+        }
+    }
+    double secs = (now_ms() - start) / 1000.0;
+    char name[48];
+    snprintf(name, sizeof(name), "%s.events", prefix);
+    bench_record(name, 1, events / secs, "ev/s", 1);
+    snprintf(name, sizeof(name), "%s.reports", prefix);
+    bench_record(name, 1, reports / secs, "rep/s", 1);
+    if (delay.count) devbench_report_latency(prefix, "delay", &delay);
+    else fprintf(stderr, "  %s: no SYN_REPORT seen in %.1f s\n", prefix, secs);
+    free(delay.ns);
+}
+
+static void devbench_chardev(int fd, const char *prefix, double seconds) {
+    char *buf = malloc(DEVBENCH_READ_SIZE);
+    struct lat_samples lat = {0};
+    unsigned long long bytes = 0, reads = 0;
+    double start, deadline;
+
+    if (!buf) return;
+    start = now_ms();
+    deadline = start + seconds * 1000.0;
+    for (;;) {
+        struct timespec a, b;
+        clock_gettime(CLOCK_MONOTONIC, &a);
+        if (a.tv_sec * 1000.0 + a.tv_nsec / 1e6 >= deadline) break;
+        ssize_t n = read(fd, buf, DEVBENCH_READ_SIZE);
+        clock_gettime(CLOCK_MONOTONIC, &b);
+        if (n < 0) {
+            if (errno == EAGAIN && devbench_wait(fd, deadline)) continue;
+            if (errno == EAGAIN || errno == EINTR) continue;
+            fprintf(stderr, "  %s: read failed: %s\n", prefix, strerror(errno));
+            break;
+        }
+        if (n == 0) break;
+        bytes += (unsigned long long)n;
+        reads++;
+        lat_add(&lat, (b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec));
+    }
+    double secs = (now_ms() - start) / 1000.0;
+    char name[48];
+    snprintf(name, sizeof(name), "%s.throughput", prefix);
+    bench_record(name, 1, bytes / secs / 1024.0, "KB/s", 1);
+    snprintf(name, sizeof(name), "%s.reads", prefix);
+    bench_record(name, 1, reads / secs, "reads/s", 1);
+    if (lat.count) devbench_report_latency(prefix, "read", &lat);
+    free(lat.ns);
+    free(buf);
+}
+
+static int run_devbench(const char **nodes, int nnodes, double seconds, const char *baseline, double regress_pct) {
+    static const char *defaults[] = {"/dev/neural", "/dev/eyes", "/dev/input/event0"};
+    int tested = 0;
+
+    if (nnodes == 0) {
+        nodes = defaults;
+        nnodes = (int)(sizeof(defaults) / sizeof(defaults[0]));
+    }
+    fprintf(stderr, "=== Linus Neural Project — TestingSystem device bench (%.1f s per node) ===\n", seconds);
+    for (int i = 0; i < nnodes; ++i) {
+        char prefix[32];
+        const char *base = strrchr(nodes[i], '/');
+        int version;
+        int fd = open(nodes[i], O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) {
+            fprintf(stderr, "  %s: skipped (%s)\n", nodes[i], strerror(errno));
+            continue;
+        }
+        snprintf(prefix, sizeof(prefix), "dev.%s", base ? base + 1 : nodes[i]);
+        if (ioctl(fd, EVIOCGVERSION, &version) == 0)
+            devbench_evdev(fd, prefix, seconds);
+        else
+            devbench_chardev(fd, prefix, seconds);
+        close(fd);
+        tested++;
+    }
+    if (tested == 0) {
+        fprintf(stderr, "no device node could be opened\n");
+        return 1;
+    }
+    if (baseline) {
+        int regressions = bench_compare_baseline(baseline, regress_pct);
+        if (regressions == BENCH_BASELINE_ERROR) return BENCH_EXIT_NO_BASELINE;
+        if (regressions != 0) return BENCH_EXIT_REGRESSION;
+    }
+    return 0;
+}
+
+/* Run a check and charge its wall-clock time to the named probe */
+#define TIMED_CHECK(name, fn) do {              \
+        double t0_ = now_ms();                  \
+        fn();                                   \
+        record_probe_cost(name, now_ms() - t0_); \
+    } while (0)
+
+static void usage(const char *prog) {
+    printf("Usage: %s [--compare-popen] [--topology] [--watch SECONDS [--count N]]\n", prog);
+    printf("       %s --bench[=mem,lat,sys,disk] [--threads N] [--bench-dir DIR]\n", prog);
+    printf("                 [--baseline FILE] [--regress-pct PCT]\n");
+    printf("       %s --devbench[=SECONDS] [--dev NODE]... [--baseline FILE]\n", prog);
+    printf("  --compare-popen   also run the legacy shell pipelines and compare probe cost\n");
+    printf("  --topology        print CPU topology, worker count and pinning map as JSON\n");
+    printf("  --watch SECONDS   stream cpu/mem/disk/net deltas as newline-delimited JSON\n");
+    printf("  --count N         stop watch mode after N samples (default: run until SIGINT)\n");
+    printf("  --bench[=GROUPS]  run micro-benchmarks, one JSON result per line on stdout\n");
+    printf("  --threads N       largest thread count for scaling runs (default: online CPUs)\n");
+    printf("  --bench-dir DIR   directory for the disk test file (default: /var/tmp);\n");
+    printf("                    exit 5 if a disk test failed and recorded nothing\n");
+    printf("  --devbench[=SEC]  read each driver node for SEC seconds (default 5): throughput,\n");
+    printf("                    read latency percentiles, evdev event rate and delivery delay\n");
+    printf("  --dev NODE        node to bench instead of the defaults (repeatable)\n");
+    printf("  --baseline FILE   compare with a saved bench run; exit 3 on regressions,\n");
+    printf("                    4 if FILE cannot be read\n");
+    printf("  --regress-pct PCT tolerance before a change counts as a regression (default: 10)\n");
+}
+
+/* Strict number parsing for option values: the whole string must be a finite number */
+static int parse_double_arg(const char *s, double *out) {
+    char *end;
+    errno = 0;
+    *out = strtod(s, &end);
+    return end != s && *end == '\0' && errno == 0 && isfinite(*out) ? 0 : -1;
+}
+
+static int parse_long_arg(const char *s, long *out) {
+    char *end;
+    errno = 0;
+    *out = strtol(s, &end, 10);
+    return end != s && *end == '\0' && errno == 0 ? 0 : -1;
 }
 
 /* Main: orchestrate checks */
 int main(int argc, char **argv) {
+    int compare_popen = 0;
+    double watch_interval = 0;
+    long watch_count = 0;
+    int bench_groups = 0, bench_threads = 0;
+    const char *bench_dir = "/var/tmp", *baseline = NULL;
+    double regress_pct = 10.0;
+    double devbench_secs = 0;
+    const char *dev_nodes[16];
+    int ndev_nodes = 0;
+    static const struct option opts[] = {
+        {"compare-popen", no_argument,       NULL, 'c'},
+        {"topology",      no_argument,       NULL, 'T'},
+        {"watch",         required_argument, NULL, 'w'},
+        {"count",         required_argument, NULL, 'n'},
+        {"bench",         optional_argument, NULL, 'b'},
+        {"threads",       required_argument, NULL, 't'},
+        {"bench-dir",     required_argument, NULL, 'd'},
+        {"baseline",      required_argument, NULL, 'B'},
+        {"regress-pct",   required_argument, NULL, 'r'},
+        {"devbench",      optional_argument, NULL, 'D'},
+        {"dev",           required_argument, NULL, 'N'},
+        {"help",          no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "cw:n:h", opts, NULL)) != -1) {
+        switch (opt) {
+        case 'c': compare_popen = 1; break;
+        case 'T': return print_topology_json();
+        case 'w':
+            if (parse_double_arg(optarg, &watch_interval) != 0 || watch_interval <= 0) {
+                fprintf(stderr, "--watch needs a positive interval in seconds, got '%s'\n", optarg);
+                return 2;
+            }
+            break;
+        case 'n':
+            if (parse_long_arg(optarg, &watch_count) != 0 || watch_count < 0) {
+                fprintf(stderr, "--count needs a sample count, got '%s'\n", optarg);
+                return 2;
+            }
+            break;
+        case 'b':
+            bench_groups = parse_bench_groups(optarg);
+            if (bench_groups < 0) {
+                fprintf(stderr, "unknown bench group in '%s' (use mem,lat,sys,disk)\n", optarg);
+                return 2;
+            }
+            break;
+        case 't': {
+            long n;
+            if (parse_long_arg(optarg, &n) != 0 || n < 1 || n > BENCH_MAX_THREADS) {
+                fprintf(stderr, "--threads needs a count from 1 to %d, got '%s'\n", BENCH_MAX_THREADS, optarg);
+                return 2;
+            }
+            bench_threads = (int)n;
+            break;
+        }
+        case 'd': bench_dir = optarg; break;
+        case 'B': baseline = optarg; break;
+        case 'r':
+            if (parse_double_arg(optarg, &regress_pct) != 0 || regress_pct < 0) {
+                fprintf(stderr, "--regress-pct needs a non-negative percentage, got '%s'\n", optarg);
+                return 2;
+            }
+            break;
+        case 'D':
+            devbench_secs = 5.0;
+            if (optarg && (parse_double_arg(optarg, &devbench_secs) != 0 || devbench_secs <= 0)) {
+                fprintf(stderr, "--devbench needs a positive duration in seconds, got '%s'\n", optarg);
+                return 2;
+            }
+            break;
+        case 'N':
+            if (ndev_nodes < (int)(sizeof(dev_nodes) / sizeof(dev_nodes[0])))
+                dev_nodes[ndev_nodes++] = optarg;
+            break;
+        case 'h': usage(argv[0]); return 0;
+        default:  usage(argv[0]); return 2;
+        }
+    }
+
+    if (watch_interval < 0 || (watch_interval == 0 && watch_count > 0)) {
+        fprintf(stderr, "--watch needs a positive interval in seconds\n");
+        return 2;
+    }
+    if (watch_interval > 0)
+        return run_watch(watch_interval, watch_count);
+    if (devbench_secs > 0)
+        return run_devbench(dev_nodes, ndev_nodes, devbench_secs, baseline, regress_pct);
+    if (bench_groups)
+        return run_bench(bench_groups, bench_threads, bench_dir, baseline, regress_pct);
+
     printf("=== Linus Neural Project — TestingSystem (single-file) ===\n");
     printf("Note: this tool performs read-only checks and light commands. It is safe,\n");
     printf("but running as root allows more complete information. Proceeding...\n");
 
     check_user();
-    check_uname();
+    TIMED_CHECK("uname", check_uname);
     check_cpu();
     check_memory();
-    check_disk();
-    check_lsmod();
-    check_dmesg_tail();
-    check_network();
-    check_binaries();
+    TIMED_CHECK("disk", check_disk);
+    TIMED_CHECK("lsmod", check_lsmod);
+    TIMED_CHECK("dmesg", check_dmesg_tail);
+    TIMED_CHECK("network", check_network);
+    TIMED_CHECK("binaries", check_binaries);
     check_dev_nodes();
-    check_processes();
-    check_proc_status();
-    check_loop_devices();
+    TIMED_CHECK("processes", check_processes);
+    TIMED_CHECK("proc", check_proc_status);
+    TIMED_CHECK("loop", check_loop_devices);
     check_connectivity();
     check_java_env();
     check_tmp_permissions();
     check_services_drivers();
+    report_probe_costs(compare_popen);
 
     printf("\n=== TestingSystem completed. Review output above for any anomalies. ===\n");
     return 0;
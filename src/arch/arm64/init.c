@@ -2,8 +2,10 @@
 /*
  * init.c — ARM64 Architecture Initialization for Linus Neural Project
  *
- * Simula o boot de um sistema ARMv8-A (64 bits), detectando recursos
- * e inicializando subsistemas de memória e segurança.
+ * Inicialização da arquitetura ARMv8-A (64 bits): identifica o núcleo
+ * pelo MIDR_EL1, conta os núcleos, lê a frequência do cpufreq e os
+ * recursos nos registradores ID_AA64*, com lnp_cpu.h, o mesmo código que
+ * escolhe as implementações SIMD dos kernels em tempo de execução.
  *
  * Copyright (c) 2025 Linus Neural Project
  */
@@ -11,39 +13,42 @@
 #include <linux/init.h>
 #include <linux/kernel.h>
 #include <linux/module.h>
-#include <linux/delay.h>
+#include <asm/cpufeature.h>
+#include <asm/sysreg.h>
+
+#include "../../drivers/lnp_cpu.h"
 
 #define ARCH_NAME   "arm64"
 #define PROJECT_TAG "Linus Neural Project"
 
 struct arm64_cpu_info {
-    const char *model;
-    unsigned int cores;
-    unsigned int mhz;
-    bool has_neon;
+    struct lnp_cpu_info cpu;
+    bool has_sve;           /* habilitado pelo kernel para o espaço de usuário */
     bool has_secure_el3;
 };
 
-static struct arm64_cpu_info cpu_info = {
-    .model = "ARM Cortex-A78 (Simulated)",
-    .cores = 8,
-    .mhz = 2800,
-    .has_neon = true,
-    .has_secure_el3 = true,
-};
+static struct arm64_cpu_info cpu_info;
 
 static int __init arm64_arch_init(void)
 {
+    u64 pfr0 = read_sysreg_s(SYS_ID_AA64PFR0_EL1);
+
     pr_info("[%s] Inicializando arquitetura %s...\n", PROJECT_TAG, ARCH_NAME);
-    pr_info("[%s] CPU: %s — %u cores @ %u MHz\n",
-            PROJECT_TAG, cpu_info.model, cpu_info.cores, cpu_info.mhz);
+    lnp_cpu_detect(&cpu_info.cpu);
+    cpu_info.has_sve = system_supports_sve();
+    cpu_info.has_secure_el3 = ((pfr0 >> 12) & 0xf) != 0;   /* ID_AA64PFR0_EL1.EL3 */
+    pr_info("[%s] CPU: %s %s — %u cores @ %u MHz\n", PROJECT_TAG,
+            cpu_info.cpu.vendor, cpu_info.cpu.model, cpu_info.cpu.cores, cpu_info.cpu.mhz);
 
-    if (cpu_info.has_neon)
+    if (cpu_info.cpu.isa & LNP_ISA_BIT(LNP_ISA_NEON))
         pr_info("[%s] Vetorização NEON habilitada.\n", PROJECT_TAG);
+    if (cpu_info.has_sve)
+        pr_info("[%s] SVE disponível (espaço de usuário).\n", PROJECT_TAG);
     if (cpu_info.has_secure_el3)
         pr_info("[%s] EL3 (Secure Monitor) detectado.\n", PROJECT_TAG);
+    pr_info("[%s] Despacho SIMD no kernel: %s\n", PROJECT_TAG,
+            lnp_isa_name(lnp_isa_best(cpu_info.cpu.isa)));
 
-    msleep(100);
     pr_info("[%s] ARM64 inicializado com sucesso!\n", PROJECT_TAG);
     return 0;
 }
@@ -51,7 +56,6 @@ static int __init arm64_arch_init(void)
 static void __exit arm64_arch_exit(void)
 {
     pr_info("[%s] Finalizando arquitetura %s...\n", PROJECT_TAG, ARCH_NAME);
-    msleep(50);
     pr_info("[%s] ARM64 finalizada.\n", PROJECT_TAG);
 }
 
@@ -61,4 +65,4 @@ module_exit(arm64_arch_exit);
 MODULE_LICENSE("Apache-2.0");
 MODULE_AUTHOR("Linus Neural Project");
 MODULE_DESCRIPTION("Módulo de inicialização da arquitetura ARM64");
-MODULE_VERSION("0.1");
+MODULE_VERSION("0.2");
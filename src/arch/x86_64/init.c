@@ -2,8 +2,10 @@
 /*
  * init.c — x86_64 Architecture Initialization for Linus Neural Project
  *
- * Simula inicialização de uma arquitetura x86_64 moderna,
- * detectando recursos como HyperThreading, SSE e AVX.
+ * Inicialização da arquitetura x86_64: detecta fabricante, modelo,
+ * núcleos/threads, frequência e as extensões vetoriais (SSE4.2, AVX2,
+ * AVX-512) com lnp_cpu.h, o mesmo código que escolhe as implementações
+ * SIMD dos kernels em tempo de execução.
  *
  * Copyright (c) 2025 Linus Neural Project
  */
@@ -11,48 +13,33 @@
 #include <linux/init.h>
 #include <linux/kernel.h>
 #include <linux/module.h>
-#include <linux/delay.h>
+
+#include "../../drivers/lnp_cpu.h"
 
 #define ARCH_NAME   "x86_64"
 #define PROJECT_TAG "Linus Neural Project"
 
-struct x86_cpu_info {
-    const char *vendor;
-    const char *model;
-    unsigned int cores;
-    unsigned int threads;
-    unsigned int mhz;
-    bool has_sse;
-    bool has_avx;
-    bool has_ht;
-};
-
-static struct x86_cpu_info cpu_info = {
-    .vendor = "GenuineIntel",
-    .model = "Core i7-13700K (Simulated)",
-    .cores = 8,
-    .threads = 16,
-    .mhz = 5100,
-    .has_sse = true,
-    .has_avx = true,
-    .has_ht = true,
-};
+static struct lnp_cpu_info cpu_info;
 
 static int __init x86_arch_init(void)
 {
     pr_info("[%s] Inicializando arquitetura %s...\n", PROJECT_TAG, ARCH_NAME);
+    lnp_cpu_detect(&cpu_info);
     pr_info("[%s] CPU: %s %s — %uC/%uT @ %u MHz\n",
             PROJECT_TAG, cpu_info.vendor, cpu_info.model,
             cpu_info.cores, cpu_info.threads, cpu_info.mhz);
 
-    if (cpu_info.has_sse)
-        pr_info("[%s] SSE habilitado.\n", PROJECT_TAG);
-    if (cpu_info.has_avx)
-        pr_info("[%s] AVX habilitado.\n", PROJECT_TAG);
-    if (cpu_info.has_ht)
+    if (cpu_info.isa & LNP_ISA_BIT(LNP_ISA_SSE42))
+        pr_info("[%s] SSE4.2 habilitado.\n", PROJECT_TAG);
+    if (cpu_info.isa & LNP_ISA_BIT(LNP_ISA_AVX2))
+        pr_info("[%s] AVX2 habilitado.\n", PROJECT_TAG);
+    if (cpu_info.isa & LNP_ISA_BIT(LNP_ISA_AVX512))
+        pr_info("[%s] AVX-512 habilitado.\n", PROJECT_TAG);
+    if (cpu_info.threads > cpu_info.cores)
         pr_info("[%s] HyperThreading ativo.\n", PROJECT_TAG);
+    pr_info("[%s] Despacho SIMD: %s\n", PROJECT_TAG,
+            lnp_isa_name(lnp_isa_best(cpu_info.isa)));
 
-    msleep(120);
     pr_info("[%s] x86_64 inicializado com sucesso!\n", PROJECT_TAG);
     return 0;
 }
@@ -60,7 +47,6 @@ static int __init x86_arch_init(void)
 static void __exit x86_arch_exit(void)
 {
     pr_info("[%s] Finalizando arquitetura %s...\n", PROJECT_TAG, ARCH_NAME);
-    msleep(50);
     pr_info("[%s] x86_64 finalizada.\n", PROJECT_TAG);
 }
 
@@ -70,4 +56,4 @@ module_exit(x86_arch_exit);
 MODULE_LICENSE("Apache-2.0");
 MODULE_AUTHOR("Linus Neural Project");
 MODULE_DESCRIPTION("Módulo de inicialização da arquitetura x86_64");
-MODULE_VERSION("0.1");
+MODULE_VERSION("0.2");
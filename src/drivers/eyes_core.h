@@ -0,0 +1,353 @@
+// SPDX-License-Identifier: GPL-2.0 OR MIT
+/*
+ * eyes_core.h - Portable sample generation, filtering and formatting for /dev/eyes
+ *
+ * Shared by eyes_driver.c and, through lnp_kshim.h, by the userspace
+ * library in src/drivers/user.
+ *
+ * The optional processing stages run on every sample in fixed point with
+ * no allocation, so they can sit in the driver's timer callback:
+ *   smoothing   moving average over up to EYES_AVG_MAX samples, or a
+ *               One-Euro filter (cutoff grows with gaze speed)
+ *   fixations   velocity threshold (I-VT): a run of samples slower than
+ *               fixation= px/s lasting fixation_min= ms is a fixation
+ *   output      every (decimate=)th sample, or events only: fixation
+ *               start/end at the fixation centroid, and blinks
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef LNP_EYES_CORE_H
+#define LNP_EYES_CORE_H
+
+#ifdef __KERNEL__
+#include <linux/kernel.h>
+#include <linux/types.h>
+#include <linux/random.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/string.h>
+#else
+#include "lnp_kshim.h"
+#endif
+
+#define EYES_BUF_SZ 256
+
+/* Simulated gaze coordinate (x,y) and brightness (lux) */
+struct eyes_sample {
+    uint16_t x;     /* 0..1920 */
+    uint16_t y;     /* 0..1080 */
+    uint16_t lux;   /* ambient light lux */
+    bool blink;     /* blink event */
+    ktime_t ts;     /* timestamp */
+    u64 seq;        /* sampler sequence, set by the producer */
+    u8 event;       /* EYES_EV_*; EYES_EV_NONE for plain samples */
+};
+
+#define EYES_EV_NONE      0
+#define EYES_EV_FIX_START 1
+#define EYES_EV_FIX_END   2
+#define EYES_EV_BLINK     3
+
+#define EYES_MAX_X 1920
+#define EYES_MAX_Y 1080
+
+static inline void eyes_core_generate(struct eyes_sample *s, bool simulate_blink)
+{
+    uint32_t rnd;
+
+    get_random_bytes(&rnd, sizeof(rnd));
+    s->x = (rnd % 1921); /* inclusive 0..1920 */
+    s->y = ((rnd >> 16) % 1081);
+
+    /* ambient light: 0..10000 lux typical range */
+    s->lux = (rnd % 10001);
+
+    /* blink: small probability depending on simulate_blink */
+    if (simulate_blink) {
+        get_random_bytes(&rnd, sizeof(rnd));
+        s->blink = ((rnd % 100) < 5); /* ~5% chance */
+    } else {
+        s->blink = false;
+    }
+
+    s->ts = ktime_get();
+    s->event = EYES_EV_NONE;
+}
+
+static const char * const eyes_event_names[] = {
+    [EYES_EV_NONE] = "none",
+    [EYES_EV_FIX_START] = "fix_start",
+    [EYES_EV_FIX_END] = "fix_end",
+    [EYES_EV_BLINK] = "blink",
+};
+
+/*
+ * Format: timestamp_ms x y lux blink\n  e.g. 1617812345678 512 384 120 true\n
+ * Events replace the blink field with the event name (fix_start, fix_end, blink).
+ */
+static inline int eyes_core_format(char *buf, size_t size, const struct eyes_sample *s)
+{
+    return scnprintf(buf, size, "%llu %u %u %u %s\n",
+                     (unsigned long long)ktime_to_ns(s->ts) / 1000000ULL,
+                     (unsigned int)s->x,
+                     (unsigned int)s->y,
+                     (unsigned int)s->lux,
+                     s->event ? eyes_event_names[s->event] : s->blink ? "true" : "false");
+}
+
+#define EYES_SMOOTH_NONE 0
+#define EYES_SMOOTH_AVG  1
+#define EYES_SMOOTH_EURO 2
+
+#define EYES_AVG_MAX         16
+#define EYES_EURO_MAX_MHZ    1000000    /* cutoff cap, 1 kHz */
+#define EYES_FILTER_MAX_OUT  2          /* samples emitted per input sample */
+
+struct eyes_filter_cfg {
+    u32 smooth;             /* EYES_SMOOTH_* */
+    u32 avg_window;         /* 1..EYES_AVG_MAX samples */
+    u32 euro_min_mhz;       /* One-Euro minimum cutoff, mHz */
+    u32 euro_beta_uhz;      /* cutoff increase per px/s of speed, µHz */
+    u32 euro_d_mhz;         /* cutoff for the speed estimate, mHz */
+    u32 fix_px_s;           /* fixation velocity threshold, px/s */
+    u32 fix_min_ms;         /* minimum fixation duration */
+    u32 decimate;           /* emit every Nth sample (samples output) */
+    bool events_only;       /* emit fixation and blink events only */
+};
+
+struct eyes_euro_axis {
+    s64 hat;                /* filtered position, Q16 px */
+    s64 dhat;               /* filtered speed, Q16 px/s */
+};
+
+/* Filter configuration plus running state; no pointers, no allocation */
+struct eyes_filter {
+    struct eyes_filter_cfg cfg;
+    u16 hx[EYES_AVG_MAX], hy[EYES_AVG_MAX];
+    u32 sum_x, sum_y;
+    u32 hpos, hcount;
+    struct eyes_euro_axis ex, ey;
+    bool have_prev;
+    s64 prev_ts;            /* ns */
+    s64 prev_x, prev_y;     /* smoothed position, Q16 px */
+    bool in_fix;
+    u32 run_n;
+    u64 run_sx, run_sy;
+    s64 run_start, run_last;
+    u32 decim;
+};
+
+static inline void eyes_filter_default(struct eyes_filter_cfg *c)
+{
+    memset(c, 0, sizeof(*c));
+    c->smooth = EYES_SMOOTH_NONE;
+    c->avg_window = 4;
+    c->euro_min_mhz = 1000;
+    c->euro_beta_uhz = 1000;
+    c->euro_d_mhz = 1000;
+    c->fix_px_s = 1000;
+    c->fix_min_ms = 100;
+    c->decimate = 1;
+}
+
+/* Drop the running state (history, fixation run), keep the configuration */
+static inline void eyes_filter_reset(struct eyes_filter *f)
+{
+    struct eyes_filter_cfg cfg = f->cfg;
+
+    memset(f, 0, sizeof(*f));
+    f->cfg = cfg;
+}
+
+/*
+ * Applies one "key=value" filter command to c. Returns 0 when applied,
+ * -EINVAL for a bad value and -ENOENT when cmd is not a filter command.
+ * Commands: smooth=none|avg|euro, avg_window=N, euro_min=mHz,
+ * euro_beta=µHz, euro_dcutoff=mHz, fixation=px/s, fixation_min=ms,
+ * decimate=N, output=samples|events.
+ */
+static inline int eyes_filter_command(struct eyes_filter_cfg *c, const char *cmd)
+{
+    unsigned int v;
+
+    if (!strncmp(cmd, "smooth=", 7)) {
+        if (!strncmp(cmd + 7, "none", 4))
+            c->smooth = EYES_SMOOTH_NONE;
+        else if (!strncmp(cmd + 7, "avg", 3))
+            c->smooth = EYES_SMOOTH_AVG;
+        else if (!strncmp(cmd + 7, "euro", 4))
+            c->smooth = EYES_SMOOTH_EURO;
+        else
+            return -EINVAL;
+        return 0;
+    }
+    if (!strncmp(cmd, "output=", 7)) {
+        if (!strncmp(cmd + 7, "samples", 7))
+            c->events_only = false;
+        else if (!strncmp(cmd + 7, "events", 6))
+            c->events_only = true;
+        else
+            return -EINVAL;
+        return 0;
+    }
+    if (sscanf(cmd, "avg_window=%u", &v) == 1)
+        return v >= 1 && v <= EYES_AVG_MAX ? (c->avg_window = v, 0) : -EINVAL;
+    if (sscanf(cmd, "euro_min=%u", &v) == 1)
+        return v >= 1 && v <= EYES_EURO_MAX_MHZ ? (c->euro_min_mhz = v, 0) : -EINVAL;
+    if (sscanf(cmd, "euro_beta=%u", &v) == 1)
+        return v <= 1000000 ? (c->euro_beta_uhz = v, 0) : -EINVAL;
+    if (sscanf(cmd, "euro_dcutoff=%u", &v) == 1)
+        return v >= 1 && v <= EYES_EURO_MAX_MHZ ? (c->euro_d_mhz = v, 0) : -EINVAL;
+    if (sscanf(cmd, "fixation_min=%u", &v) == 1)
+        return v <= 10000 ? (c->fix_min_ms = v, 0) : -EINVAL;
+    if (sscanf(cmd, "fixation=%u", &v) == 1)
+        return v <= 100000 ? (c->fix_px_s = v, 0) : -EINVAL;
+    if (sscanf(cmd, "decimate=%u", &v) == 1)
+        return v >= 1 && v <= 10000 ? (c->decimate = v, 0) : -EINVAL;
+    return -ENOENT;
+}
+
+/* One-Euro smoothing factor 2π·fc·dt / (2π·fc·dt + 1), Q16 */
+static inline u32 eyes_euro_alpha(u32 cutoff_mhz, u32 dt_us)
+{
+    /* 411775 = 2π · 65536; fc·dt = mHz · µs / 1e9 */
+    u64 r = div_u64((u64)411775 * cutoff_mhz * dt_us, 1000000000);
+
+    return div64_u64(r << 16, r + 65536);
+}
+
+static inline void eyes_euro_step(struct eyes_euro_axis *a, const struct eyes_filter_cfg *c,
+                                  s64 pos, u32 dt_us)
+{
+    s64 d = div_s64((pos - a->hat) * 1000000, dt_us);
+    u64 speed, cutoff;
+
+    a->dhat += ((s64)eyes_euro_alpha(c->euro_d_mhz, dt_us) * (d - a->dhat)) >> 16;
+    speed = (a->dhat < 0 ? -a->dhat : a->dhat) >> 16;
+    cutoff = c->euro_min_mhz + div_u64((u64)c->euro_beta_uhz * speed, 1000);
+    if (cutoff > EYES_EURO_MAX_MHZ)
+        cutoff = EYES_EURO_MAX_MHZ;
+    a->hat += ((s64)eyes_euro_alpha(cutoff, dt_us) * (pos - a->hat)) >> 16;
+}
+
+static inline u16 eyes_q16_to_px(s64 v, u16 max)
+{
+    v = (v + 0x8000) >> 16;
+    return v < 0 ? 0 : v > max ? max : v;
+}
+
+static inline void eyes_fix_event(struct eyes_filter *f, const struct eyes_sample *in,
+                                  u8 event, s64 ts, struct eyes_sample *out)
+{
+    *out = *in;
+    out->x = div_u64(f->run_sx, f->run_n);
+    out->y = div_u64(f->run_sy, f->run_n);
+    out->ts = ns_to_ktime(ts);
+    out->blink = false;
+    out->event = event;
+}
+
+/*
+ * Runs one sample through the configured stages. Writes up to
+ * EYES_FILTER_MAX_OUT samples to out and returns how many; 0 means the
+ * sample was consumed (decimated, or no event in events-only output).
+ */
+static inline unsigned int eyes_filter_run(struct eyes_filter *f, const struct eyes_sample *in,
+                                           struct eyes_sample *out)
+{
+    const struct eyes_filter_cfg *c = &f->cfg;
+    s64 ts = ktime_to_ns(in->ts);
+    s64 x = (s64)in->x << 16, y = (s64)in->y << 16;
+    u32 dt_us = 1;
+    unsigned int n = 0;
+
+    if (f->have_prev && ts > f->prev_ts)
+        dt_us = max_t(u64, div_u64(ts - f->prev_ts, 1000), 1);
+
+    /* smoothing */
+    if (c->smooth == EYES_SMOOTH_AVG) {
+        u32 w = c->avg_window;
+
+        if (f->hcount == w) {
+            f->sum_x -= f->hx[f->hpos];
+            f->sum_y -= f->hy[f->hpos];
+        } else {
+            f->hcount++;
+        }
+        f->hx[f->hpos] = in->x;
+        f->hy[f->hpos] = in->y;
+        f->sum_x += in->x;
+        f->sum_y += in->y;
+        f->hpos = (f->hpos + 1) % w;
+        x = div_u64((u64)f->sum_x << 16, f->hcount);
+        y = div_u64((u64)f->sum_y << 16, f->hcount);
+    } else if (c->smooth == EYES_SMOOTH_EURO) {
+        if (!f->have_prev) {
+            f->ex.hat = x;
+            f->ey.hat = y;
+        } else {
+            eyes_euro_step(&f->ex, c, x, dt_us);
+            eyes_euro_step(&f->ey, c, y, dt_us);
+        }
+        x = f->ex.hat;
+        y = f->ey.hat;
+    }
+
+    if (!c->events_only) {
+        if (++f->decim >= c->decimate) {
+            f->decim = 0;
+            out[n] = *in;
+            out[n].x = eyes_q16_to_px(x, EYES_MAX_X);
+            out[n].y = eyes_q16_to_px(y, EYES_MAX_Y);
+            n++;
+        }
+        goto done;
+    }
+
+    /* I-VT fixation detection on the smoothed positions */
+    if (c->fix_px_s) {
+        bool slow = false;
+
+        if (f->have_prev) {
+            s64 dx = (x - f->prev_x) >> 8, dy = (y - f->prev_y) >> 8;      /* Q8 px */
+            u64 thr = div_u64((u64)c->fix_px_s * dt_us << 8, 1000000);     /* Q8 px */
+
+            slow = (u64)(dx * dx + dy * dy) <= thr * thr;
+        }
+        if (slow) {
+            f->run_n++;
+            f->run_sx += eyes_q16_to_px(x, EYES_MAX_X);
+            f->run_sy += eyes_q16_to_px(y, EYES_MAX_Y);
+            f->run_last = ts;
+            if (!f->in_fix && ts - f->run_start >= (s64)c->fix_min_ms * 1000000) {
+                f->in_fix = true;
+                eyes_fix_event(f, in, EYES_EV_FIX_START, f->run_start, &out[n++]);
+            }
+        } else {
+            if (f->in_fix) {
+                f->in_fix = false;
+                eyes_fix_event(f, in, EYES_EV_FIX_END, f->run_last, &out[n++]);
+            }
+            /* a new candidate run starts at this sample */
+            f->run_n = 1;
+            f->run_sx = eyes_q16_to_px(x, EYES_MAX_X);
+            f->run_sy = eyes_q16_to_px(y, EYES_MAX_Y);
+            f->run_start = f->run_last = ts;
+        }
+    }
+    if (in->blink) {
+        out[n] = *in;
+        out[n].event = EYES_EV_BLINK;
+        n++;
+    }
+
+done:
+    f->have_prev = true;
+    f->prev_ts = ts;
+    f->prev_x = x;
+    f->prev_y = y;
+    return n;
+}
+
+#endif /* LNP_EYES_CORE_H */
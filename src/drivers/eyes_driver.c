@@ -1,153 +1,673 @@
-// SPDX-License-Identifier: Apache-2.0 /**
-
-eyes_driver.c - Experimental Eye Sensor Kernel Module
-
-For the Linus Neural Project. This module creates a character device
-
-/dev/eyes that simulates a simple eye-tracking / ambient light sensor.
-
-It is intended for educational and development use only.
-
-Copyright (c) 2025 Linus Neural Project */
-
-
-#include <linux/module.h> #include <linux/kernel.h> #include <linux/init.h> #include <linux/fs.h> #include <linux/uaccess.h> #include <linux/device.h> #include <linux/mutex.h> #include <linux/random.h> #include <linux/slab.h> #include <linux/time.h>
-
-#define DEVICE_NAME "eyes" #define CLASS_NAME  "sensornet"
-
-static int    major_number; static struct class*  eyes_class  = NULL; static struct device* eyes_device = NULL; static DEFINE_MUTEX(eyes_mutex);
-
-/* Simple runtime configuration exposed via write to device: / static unsigned int sample_interval_ms = 100; / how often sample updates (simulated) */ static bool simulate_blink = true;
+// SPDX-License-Identifier: GPL-2.0 OR MIT
+/**
+ * eyes_driver.c - Experimental Eye Sensor Kernel Module
+ *
+ * For the Linus Neural Project. This module creates a character device
+ * /dev/eyes that simulates a simple eye-tracking / ambient light sensor.
+ * It is intended for educational and development use only.
+ * eyes_iio.c exposes the same simulated sensor through IIO instead.
+ *
+ * While the device is open an hrtimer samples the sensor every
+ * sample_interval_ms (1..10000 ms, "interval=N") and queues the samples
+ * in a kfifo, each stamped with the ideal time of its period so the
+ * stream has a true fixed rate. read() drains as many queued lines as fit
+ * and blocks (or -EAGAIN with O_NONBLOCK) when the queue is empty.
+ * Each open file reads either text lines (default) or, after
+ * EYES_IOC_SET_MODE / "mode=binary", packed struct eyes_record arrays
+ * (eyes_driver.h), hundreds per read() with nothing to parse.
+ * Optional processing stages from eyes_core.h (smoothing, fixation
+ * detection, decimation or event-only output) run in the timer before
+ * queuing, configured with the same text commands ("smooth=euro",
+ * "output=events", ...; see eyes_filter_command()) and shown in the
+ * sysfs "filter" attribute.
+ * When the queue is full the oldest sample is dropped by default;
+ * "overflow=newest" drops the incoming one instead. Either way the loss
+ * is counted in the debugfs "dropped" counter; queue depth and high
+ * water mark are in the sysfs "fifo" attribute.
+ *
+ * Per-CPU counters are exported under /sys/kernel/debug/eyes/ and the
+ * per-operation events are tracepoints (events/eyes/).
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
 
-/* Buffer to format sensor output for user-space */ #define EYES_BUF_SZ 256 static char eyes_buffer[EYES_BUF_SZ];
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/init.h>
+#include <linux/fs.h>
+#include <linux/uaccess.h>
+#include <linux/device.h>
+#include <linux/mutex.h>
+#include <linux/random.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+#include <linux/sched.h>
+#include <linux/time.h>
+#include <linux/ktime.h>
+#include <linux/hrtimer.h>
+#include <linux/kfifo.h>
+#include <linux/spinlock.h>
+#include <linux/wait.h>
+#include <linux/poll.h>
+#include <linux/version.h>
+
+#include "eyes_driver.h"
+#include "eyes_core.h"
+#include "lnp_drvstats.h"
+
+#define CREATE_TRACE_POINTS
+#include "eyes_trace.h"
+
+#define DEVICE_NAME "eyes"
+#define CLASS_NAME  "sensornet"
+
+#define EYES_FIFO_SIZE       1024   /* queued samples; power of 2 */
+#define EYES_INTERVAL_MIN_MS 1
+#define EYES_INTERVAL_MAX_MS 10000
+#define EYES_MAX_CATCHUP     64     /* missed periods replayed per timer expiry */
+#define EYES_BIN_CHUNK       16     /* records per copy_to_user in binary mode */
+
+static int    major_number;
+static struct class*  eyes_class  = NULL;
+static struct device* eyes_device = NULL;
+static DEFINE_MUTEX(eyes_mutex);
+static struct lnp_drv_stats __percpu *eyes_stats;
+static struct dentry *eyes_debugfs;
+
+/* Simple runtime configuration exposed via write to device: */
+static unsigned int sample_interval_ms = 100; /* sampler period */
+static bool simulate_blink = true;
+
+enum eyes_overflow {
+    EYES_DROP_OLDEST,       /* keep the freshest gaze data */
+    EYES_DROP_NEWEST,       /* keep what is queued, discard incoming */
+};
+static enum eyes_overflow eyes_overflow = EYES_DROP_OLDEST;
+
+/* Sampler: hrtimer producer, kfifo queue, readers wait on eyes_wq */
+static DECLARE_KFIFO(eyes_fifo, struct eyes_sample, EYES_FIFO_SIZE);
+static DEFINE_SPINLOCK(eyes_fifo_lock);     /* timer (hardirq) vs. reader */
+static unsigned int eyes_high_water;
+static struct hrtimer eyes_timer;
+static ktime_t eyes_period;
+static u64 eyes_seq;                        /* next sample sequence; timer only */
+static bool eyes_sampling;
+static DEFINE_MUTEX(eyes_cfg_lock);         /* interval changes vs. open/release */
+static DECLARE_WAIT_QUEUE_HEAD(eyes_wq);
+
+/* Processing stages; config written from process context, run in the timer */
+static struct eyes_filter eyes_filter;
+static DEFINE_SPINLOCK(eyes_filter_lock);
+
+/* Reader side: a sample that did not fit in the last read() is kept here */
+static DEFINE_MUTEX(eyes_read_lock);
+static struct eyes_sample eyes_pending;
+static bool eyes_has_pending;
+
+/* Buffer to format sensor output for user-space */
+static char eyes_buffer[EYES_BUF_SZ];
+
+/* Per-open state */
+struct eyes_file {
+    u32 mode;               /* EYES_MODE_TEXT or EYES_MODE_BINARY */
+};
+
+/* file operations prototypes */
+static int     eyes_open(struct inode*, struct file*);
+static int     eyes_release(struct inode*, struct file*);
+static ssize_t eyes_read(struct file*, char __user*, size_t, loff_t*);
+static ssize_t eyes_write(struct file*, const char __user*, size_t, loff_t*);
+static __poll_t eyes_poll(struct file*, poll_table*);
+static long    eyes_ioctl(struct file*, unsigned int, unsigned long);
+
+static struct file_operations fops = {
+    .owner = THIS_MODULE,
+    .open = eyes_open,
+    .read = eyes_read,
+    .write = eyes_write,
+    .poll = eyes_poll,
+    .unlocked_ioctl = eyes_ioctl,
+    .release = eyes_release,
+};
+
+/* Fresh sample from the shared core (eyes_core.h), counted per CPU */
+static void generate_sample(struct eyes_sample *s)
+{
+    eyes_core_generate(s, simulate_blink);
+    this_cpu_inc(eyes_stats->samples);
+}
 
-/* file operations prototypes / static int     eyes_open(struct inode, struct file*); static int     eyes_release(struct inode*, struct file*); static ssize_t eyes_read(struct file*, char*, size_t, loff_t*); static ssize_t eyes_write(struct file*, const char*, size_t, loff_t*);
+/* Queue one sample, applying the overflow policy when the fifo is full */
+static void eyes_push(const struct eyes_sample *s)
+{
+    unsigned long flags;
+    unsigned int len;
+
+    spin_lock_irqsave(&eyes_fifo_lock, flags);
+    if (kfifo_is_full(&eyes_fifo)) {
+        this_cpu_inc(eyes_stats->dropped);
+        if (eyes_overflow == EYES_DROP_NEWEST) {
+            spin_unlock_irqrestore(&eyes_fifo_lock, flags);
+            return;
+        }
+        kfifo_skip(&eyes_fifo);
+    }
+    kfifo_put(&eyes_fifo, *s);
+    len = kfifo_len(&eyes_fifo);
+    if (len > eyes_high_water)
+        eyes_high_water = len;
+    spin_unlock_irqrestore(&eyes_fifo_lock, flags);
+}
 
-static struct file_operations fops = { .open = eyes_open, .read = eyes_read, .write = eyes_write, .release = eyes_release, };
+/*
+ * Timer expiry: one sample per elapsed period, stamped with the ideal
+ * time of that period. Periods beyond EYES_MAX_CATCHUP are not replayed
+ * and count as dropped.
+ */
+static enum hrtimer_restart eyes_timer_fn(struct hrtimer *t)
+{
+    ktime_t expires = hrtimer_get_expires(t);
+    u64 periods = hrtimer_forward_now(t, eyes_period);
+    struct eyes_sample s, out[EYES_FILTER_MAX_OUT];
+    unsigned int nout, k;
+    u64 i;
+
+    if (periods > EYES_MAX_CATCHUP) {
+        this_cpu_add(eyes_stats->dropped, periods - EYES_MAX_CATCHUP);
+        eyes_seq += periods - EYES_MAX_CATCHUP;
+        expires = ktime_add_ns(expires, (periods - EYES_MAX_CATCHUP) * ktime_to_ns(eyes_period));
+        periods = EYES_MAX_CATCHUP;
+    }
+    for (i = 0; i < periods; i++) {
+        generate_sample(&s);
+        s.ts = ktime_add_ns(expires, i * ktime_to_ns(eyes_period));
+        s.seq = eyes_seq++;
+        trace_eyes_sample(s.x, s.y, s.lux, s.blink, ktime_to_ns(s.ts));
+
+        spin_lock(&eyes_filter_lock);
+        nout = eyes_filter_run(&eyes_filter, &s, out);
+        spin_unlock(&eyes_filter_lock);
+        for (k = 0; k < nout; k++)
+            eyes_push(&out[k]);
+    }
+
+    wake_up_interruptible(&eyes_wq);
+    return HRTIMER_RESTART;
+}
 
-/* Helper: produce a simulated gaze coordinate (x,y) and brightness (lux) / struct eyes_sample { uint16_t x;     / 0..1920 / uint16_t y;     / 0..1080 / uint16_t lux;   / ambient light lux / bool blink;     / blink event / ktime_t ts;     / timestamp */ };
+/* (Re)start the sampler at the current interval; called with eyes_cfg_lock held */
+static void eyes_start_sampling(void)
+{
+    hrtimer_cancel(&eyes_timer);
+    eyes_period = ms_to_ktime(sample_interval_ms);
+    hrtimer_start(&eyes_timer, ktime_add(ktime_get(), eyes_period), HRTIMER_MODE_ABS);
+    eyes_sampling = true;
+}
 
-static void generate_sample(struct eyes_sample *s) { uint32_t rnd;
+static int eyes_set_interval(unsigned int ms)
+{
+    if (ms < EYES_INTERVAL_MIN_MS || ms > EYES_INTERVAL_MAX_MS)
+        return -EINVAL;
+
+    mutex_lock(&eyes_cfg_lock);
+    sample_interval_ms = ms;
+    if (eyes_sampling)
+        eyes_start_sampling();
+    mutex_unlock(&eyes_cfg_lock);
+    pr_debug("eyes_driver: set interval=%u ms\n", sample_interval_ms);
+    return 0;
+}
 
-get_random_bytes(&rnd, sizeof(rnd));
-s->x = (rnd % 1921); /* inclusive 0..1920 */
-s->y = ((rnd >> 16) % 1081);
+/* Next sample for the reader: the held-back one first, then the fifo */
+static bool eyes_next(struct eyes_sample *s)
+{
+    unsigned long flags;
+    bool ok;
+
+    if (eyes_has_pending) {
+        *s = eyes_pending;
+        eyes_has_pending = false;
+        return true;
+    }
+    spin_lock_irqsave(&eyes_fifo_lock, flags);
+    ok = kfifo_get(&eyes_fifo, s);
+    spin_unlock_irqrestore(&eyes_fifo_lock, flags);
+    return ok;
+}
 
-/* ambient light: 0..10000 lux typical range */
-s->lux = (rnd % 10001);
+/* Up to max samples for the reader in one go: held-back one, then a kfifo_out */
+static unsigned int eyes_take(struct eyes_sample *out, unsigned int max)
+{
+    unsigned long flags;
+    unsigned int n = 0;
+
+    if (eyes_has_pending && max) {
+        out[n++] = eyes_pending;
+        eyes_has_pending = false;
+    }
+    spin_lock_irqsave(&eyes_fifo_lock, flags);
+    n += kfifo_out(&eyes_fifo, out + n, max - n);
+    spin_unlock_irqrestore(&eyes_fifo_lock, flags);
+    return n;
+}
 
-/* blink: small probability depending on simulate_blink */
-if (simulate_blink) {
-    get_random_bytes(&rnd, sizeof(rnd));
-    s->blink = ((rnd % 100) < 5); /* ~5% chance */
-} else {
-    s->blink = false;
+static bool eyes_ready(void)
+{
+    return READ_ONCE(eyes_has_pending) || !kfifo_is_empty(&eyes_fifo);
 }
 
-s->ts = ktime_get();
+static void eyes_hold_back(const struct eyes_sample *s)
+{
+    eyes_pending = *s;
+    eyes_has_pending = true;
+}
 
+/*
+ * Queue empty: block until the sampler queues something (or -EAGAIN with
+ * O_NONBLOCK). Called with eyes_read_lock held.
+ */
+static int eyes_wait_data(struct file *filep)
+{
+    if (filep->f_flags & O_NONBLOCK) {
+        this_cpu_inc(eyes_stats->busy);
+        return -EAGAIN;
+    }
+    if (wait_event_interruptible(eyes_wq, eyes_ready()))
+        return -ERESTARTSYS;
+    return 0;
 }
 
-static int eyes_open(struct inode *inodep, struct file *filep) { if (!mutex_trylock(&eyes_mutex)) { pr_alert("eyes_driver: device is busy\n"); return -EBUSY; } pr_info("eyes_driver: device opened\n"); return 0; }
+static void eyes_to_record(const struct eyes_sample *s, struct eyes_record *rec)
+{
+    rec->seq = s->seq;
+    rec->ts_ns = ktime_to_ns(s->ts);
+    rec->x = s->x;
+    rec->y = s->y;
+    rec->lux = s->lux;
+    rec->flags = s->blink ? EYES_REC_BLINK : 0;
+    if (s->event == EYES_EV_FIX_START)
+        rec->flags |= EYES_REC_FIX_START;
+    else if (s->event == EYES_EV_FIX_END)
+        rec->flags |= EYES_REC_FIX_END;
+    rec->reserved = 0;
+}
 
-static ssize_t eyes_read(struct file *filep, char *buffer, size_t len, loff_t *offset) { struct eyes_sample samp; int ret; size_t out_len;
+static int eyes_open(struct inode *inodep, struct file *filep)
+{
+    struct eyes_file *ef;
+
+    if (!mutex_trylock(&eyes_mutex)) {
+        this_cpu_inc(eyes_stats->busy);
+        trace_eyes_open(task_tgid_nr(current), -EBUSY);
+        return -EBUSY;
+    }
+
+    ef = kzalloc(sizeof(*ef), GFP_KERNEL);
+    if (!ef) {
+        mutex_unlock(&eyes_mutex);
+        return -ENOMEM;
+    }
+    ef->mode = EYES_MODE_TEXT;
+    filep->private_data = ef;
+
+    /* a new session starts with an empty queue */
+    mutex_lock(&eyes_cfg_lock);
+    spin_lock_irq(&eyes_fifo_lock);
+    kfifo_reset(&eyes_fifo);
+    spin_unlock_irq(&eyes_fifo_lock);
+    eyes_has_pending = false;
+    spin_lock_irq(&eyes_filter_lock);
+    eyes_filter_reset(&eyes_filter);
+    spin_unlock_irq(&eyes_filter_lock);
+    eyes_start_sampling();
+    mutex_unlock(&eyes_cfg_lock);
+
+    trace_eyes_open(task_tgid_nr(current), 0);
+    return 0;
+}
 
-/* Generate a fresh sample on each read */
-generate_sample(&samp);
+/*
+ * Binary mode: whole struct eyes_record entries, taken from the queue
+ * EYES_BIN_CHUNK at a time under one lock and copied with one
+ * copy_to_user per chunk. Samples of a chunk that fails to copy are lost
+ * (counted as copy failures).
+ */
+static ssize_t eyes_read_binary(struct file *filep, char __user *buffer, size_t len,
+                                unsigned int *count)
+{
+    struct eyes_sample samp[EYES_BIN_CHUNK];
+    struct eyes_record rec[EYES_BIN_CHUNK];
+    size_t max = len / sizeof(struct eyes_record);
+    unsigned int n = 0, fill, i;
+    ssize_t ret = 0;
+
+    if (max == 0)
+        return -EINVAL;
+
+    while (n < max) {
+        fill = eyes_take(samp, min_t(size_t, EYES_BIN_CHUNK, max - n));
+        if (fill == 0) {
+            if (n)
+                break;
+            ret = eyes_wait_data(filep);
+            if (ret)
+                break;
+            continue;
+        }
+        for (i = 0; i < fill; i++)
+            eyes_to_record(&samp[i], &rec[i]);
+        if (copy_to_user(buffer + n * sizeof(rec[0]), rec, fill * sizeof(rec[0]))) {
+            this_cpu_inc(eyes_stats->copy_failures);
+            ret = -EFAULT;
+            break;
+        }
+        n += fill;
+    }
+
+    *count = n;
+    return n ? n * sizeof(struct eyes_record) : ret;
+}
 
-/* Format: timestamp_ms x y lux blink\n  e.g. 1617812345678 512 384 120 true\n */
-snprintf(eyes_buffer, EYES_BUF_SZ, "%llu %u %u %u %s\n",
-         (unsigned long long)ktime_to_ns(samp.ts) / 1000000ULL,
-         (unsigned int)samp.x,
-         (unsigned int)samp.y,
-         (unsigned int)samp.lux,
-         samp.blink ? "true" : "false");
+/* Drain as many queued samples as fit in len, one text line each */
+static ssize_t eyes_read_text(struct file *filep, char __user *buffer, size_t len,
+                              unsigned int *count)
+{
+    struct eyes_sample samp;
+    size_t done = 0, out_len;
+    ssize_t ret = 0;
+
+    while (done < len) {
+        if (!eyes_next(&samp)) {
+            if (done)
+                break;
+            ret = eyes_wait_data(filep);
+            if (ret)
+                break;
+            continue;
+        }
+
+        out_len = eyes_core_format(eyes_buffer, EYES_BUF_SZ, &samp);
+        if (out_len > len - done) {
+            /* user buffer too small: keep the sample for the next read */
+            eyes_hold_back(&samp);
+            if (!done)
+                ret = -EINVAL;
+            break;
+        }
+        if (copy_to_user(buffer + done, eyes_buffer, out_len)) {
+            this_cpu_inc(eyes_stats->copy_failures);
+            eyes_hold_back(&samp);
+            ret = -EFAULT;
+            break;
+        }
+        done += out_len;
+        (*count)++;
+    }
+
+    return done ? done : ret;
+}
 
-out_len = strlen(eyes_buffer);
-if (len < out_len) {
-    /* user buffer too small */
-    pr_warn("eyes_driver: user buffer too small: need %zu bytes\n", out_len);
-    return -EINVAL;
+static ssize_t eyes_read(struct file *filep, char __user *buffer, size_t len, loff_t *offset)
+{
+    struct eyes_file *ef = filep->private_data;
+    unsigned int count = 0;
+    ssize_t ret;
+    u64 t0 = ktime_get_ns();
+
+    if (mutex_lock_interruptible(&eyes_read_lock))
+        return -ERESTARTSYS;
+    if (READ_ONCE(ef->mode) == EYES_MODE_BINARY)
+        ret = eyes_read_binary(filep, buffer, len, &count);
+    else
+        ret = eyes_read_text(filep, buffer, len, &count);
+    mutex_unlock(&eyes_read_lock);
+
+    if (ret > 0)
+        this_cpu_add(eyes_stats->bytes, ret);
+    lnp_stats_read_latency(eyes_stats, ktime_get_ns() - t0);
+    trace_eyes_read(count, ret > 0 ? ret : 0, ret > 0 ? 0 : ret);
+    return ret;
 }
 
-ret = copy_to_user(buffer, eyes_buffer, out_len);
-if (ret != 0) {
-    pr_warn("eyes_driver: failed to copy %d bytes to user\n", ret);
-    return -EFAULT;
+static __poll_t eyes_poll(struct file *filep, poll_table *wait)
+{
+    poll_wait(filep, &eyes_wq, wait);
+    if (eyes_ready())
+        return EPOLLIN | EPOLLRDNORM;
+    return 0;
 }
 
-pr_debug("eyes_driver: sample delivered: %s", eyes_buffer);
-return out_len;
+static int eyes_set_mode(struct file *filep, u32 mode)
+{
+    struct eyes_file *ef = filep->private_data;
 
+    if (mode != EYES_MODE_TEXT && mode != EYES_MODE_BINARY)
+        return -EINVAL;
+    WRITE_ONCE(ef->mode, mode);
+    return 0;
 }
 
-static ssize_t eyes_write(struct file *filep, const char *buffer, size_t len, loff_t *offset) { char *kbuf; ssize_t rc = len;
-
-/* Accept simple text commands to adjust simulated parameters:
- * e.g. "interval=200" or "blink=0" or "blink=1" 
- */
-kbuf = kzalloc(len + 1, GFP_KERNEL);
-if (!kbuf)
-    return -ENOMEM;
+static long eyes_ioctl(struct file *filep, unsigned int cmd, unsigned long arg)
+{
+    struct eyes_file *ef = filep->private_data;
+    struct eyes_abi abi = {
+        .version = EYES_ABI_VERSION,
+        .record_size = sizeof(struct eyes_record),
+    };
+    u32 mode;
+
+    switch (cmd) {
+    case EYES_IOC_SET_MODE:
+        if (get_user(mode, (u32 __user *)arg))
+            return -EFAULT;
+        return eyes_set_mode(filep, mode);
+    case EYES_IOC_GET_MODE:
+        return put_user(READ_ONCE(ef->mode), (u32 __user *)arg);
+    case EYES_IOC_GET_ABI:
+        if (copy_to_user((void __user *)arg, &abi, sizeof(abi)))
+            return -EFAULT;
+        return 0;
+    default:
+        return -ENOTTY;
+    }
+}
 
-if (copy_from_user(kbuf, buffer, len)) {
+static ssize_t eyes_write(struct file *filep, const char __user *buffer, size_t len, loff_t *offset)
+{
+    char *kbuf;
+    ssize_t rc = len;
+
+    /* Accept simple text commands to adjust simulated parameters:
+     * e.g. "interval=200", "blink=0", "blink=1", "overflow=oldest|newest",
+     * "mode=text|binary" (this open file only), or a filter command
+     * ("smooth=euro", "output=events", ...; see eyes_filter_command())
+     * A command is one short line: anything a page or longer is refused
+     * rather than copied into the kernel.
+     */
+    if (len >= PAGE_SIZE)
+        return -EINVAL;
+    kbuf = memdup_user_nul(buffer, len);
+    if (IS_ERR(kbuf)) {
+        if (PTR_ERR(kbuf) == -EFAULT)
+            this_cpu_inc(eyes_stats->copy_failures);
+        return PTR_ERR(kbuf);
+    }
+
+    /* parse basic commands */
+    if (strnstr(kbuf, "interval=", len)) {
+        unsigned int v = 0;
+        if (sscanf(kbuf, "interval=%u", &v) != 1 || eyes_set_interval(v))
+            rc = -EINVAL;
+    } else if (strnstr(kbuf, "blink=", len)) {
+        unsigned int v = 0;
+        if (sscanf(kbuf, "blink=%u", &v) == 1)
+            simulate_blink = (v != 0);
+        pr_debug("eyes_driver: set blink=%u\n", simulate_blink);
+    } else if (strnstr(kbuf, "overflow=", len)) {
+        if (strnstr(kbuf, "overflow=oldest", len))
+            WRITE_ONCE(eyes_overflow, EYES_DROP_OLDEST);
+        else if (strnstr(kbuf, "overflow=newest", len))
+            WRITE_ONCE(eyes_overflow, EYES_DROP_NEWEST);
+        else
+            rc = -EINVAL;
+    } else if (strnstr(kbuf, "mode=", len)) {
+        if (strnstr(kbuf, "mode=binary", len))
+            rc = eyes_set_mode(filep, EYES_MODE_BINARY) ?: len;
+        else if (strnstr(kbuf, "mode=text", len))
+            rc = eyes_set_mode(filep, EYES_MODE_TEXT) ?: len;
+        else
+            rc = -EINVAL;
+    } else {
+        struct eyes_filter_cfg cfg;
+        int err;
+
+        /* a config change restarts the stages from a clean state */
+        spin_lock_irq(&eyes_filter_lock);
+        cfg = eyes_filter.cfg;
+        err = eyes_filter_command(&cfg, kbuf);
+        if (!err) {
+            eyes_filter.cfg = cfg;
+            eyes_filter_reset(&eyes_filter);
+        }
+        spin_unlock_irq(&eyes_filter_lock);
+        if (err == -EINVAL)
+            rc = -EINVAL;
+    }
+
+    trace_eyes_command(kbuf, rc < 0 ? (int)rc : 0);
     kfree(kbuf);
-    return -EFAULT;
+    return rc;
 }
 
-/* parse basic commands */
-if (strnstr(kbuf, "interval=", len)) {
-    unsigned int v = 0;
-    if (sscanf(kbuf, "interval=%u", &v) == 1 && v > 0)
-        sample_interval_ms = v;
-    pr_info("eyes_driver: set interval=%u ms\n", sample_interval_ms);
-} else if (strnstr(kbuf, "blink=", len)) {
-    unsigned int v = 0;
-    if (sscanf(kbuf, "blink=%u", &v) == 1)
-        simulate_blink = (v != 0);
-    pr_info("eyes_driver: set blink=%u\n", simulate_blink);
-} else {
-    pr_info("eyes_driver: unknown command: %s\n", kbuf);
+static int eyes_release(struct inode *inodep, struct file *filep)
+{
+    mutex_lock(&eyes_cfg_lock);
+    hrtimer_cancel(&eyes_timer);
+    eyes_sampling = false;
+    mutex_unlock(&eyes_cfg_lock);
+
+    kfree(filep->private_data);
+    mutex_unlock(&eyes_mutex);
+    trace_eyes_release(task_tgid_nr(current));
+    return 0;
 }
 
-kfree(kbuf);
-return rc;
-
+/* sysfs "fifo": queue capacity, depth, high water mark and policy */
+static ssize_t fifo_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    return scnprintf(buf, PAGE_SIZE,
+                     "capacity %u\nqueued %u\nhigh_water %u\ninterval_ms %u\noverflow %s\n",
+                     (unsigned int)kfifo_size(&eyes_fifo), kfifo_len(&eyes_fifo),
+                     READ_ONCE(eyes_high_water), READ_ONCE(sample_interval_ms),
+                     READ_ONCE(eyes_overflow) == EYES_DROP_NEWEST ? "newest" : "oldest");
 }
-
-static int eyes_release(struct inode *inodep, struct file *filep) { mutex_unlock(&eyes_mutex); pr_info("eyes_driver: device closed\n"); return 0; }
-
-/* Module init/exit */ static int __init eyes_init(void) { pr_info("eyes_driver: initializing...\n");
-
-major_number = register_chrdev(0, DEVICE_NAME, &fops);
-if (major_number < 0) {
-    pr_err("eyes_driver: failed to register char device\n");
-    return major_number;
+static DEVICE_ATTR_RO(fifo);
+
+/* sysfs "filter": current processing stage configuration */
+static ssize_t filter_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    static const char * const smooth[] = { "none", "avg", "euro" };
+    struct eyes_filter_cfg c;
+
+    spin_lock_irq(&eyes_filter_lock);
+    c = eyes_filter.cfg;
+    spin_unlock_irq(&eyes_filter_lock);
+
+    return scnprintf(buf, PAGE_SIZE,
+                     "smooth %s\navg_window %u\neuro_min %u\neuro_beta %u\neuro_dcutoff %u\n"
+                     "fixation %u\nfixation_min %u\ndecimate %u\noutput %s\n",
+                     smooth[c.smooth], c.avg_window, c.euro_min_mhz, c.euro_beta_uhz,
+                     c.euro_d_mhz, c.fix_px_s, c.fix_min_ms, c.decimate,
+                     c.events_only ? "events" : "samples");
 }
-
-eyes_class = class_create(THIS_MODULE, CLASS_NAME);
-if (IS_ERR(eyes_class)) {
-    unregister_chrdev(major_number, DEVICE_NAME);
-    pr_err("eyes_driver: failed to create class\n");
-    return PTR_ERR(eyes_class);
+static DEVICE_ATTR_RO(filter);
+
+/* Module init/exit */
+static int __init eyes_init(void)
+{
+    int ret;
+
+    pr_info("eyes_driver: initializing...\n");
+
+    /* the record is part of the read() ABI: its size cannot change */
+    BUILD_BUG_ON(sizeof(struct eyes_record) != 24);
+
+    INIT_KFIFO(eyes_fifo);
+    eyes_filter_default(&eyes_filter.cfg);
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 13, 0)
+    hrtimer_setup(&eyes_timer, eyes_timer_fn, CLOCK_MONOTONIC, HRTIMER_MODE_ABS);
+#else
+    hrtimer_init(&eyes_timer, CLOCK_MONOTONIC, HRTIMER_MODE_ABS);
+    eyes_timer.function = eyes_timer_fn;
+#endif
+
+    eyes_stats = alloc_percpu(struct lnp_drv_stats);
+    if (!eyes_stats)
+        return -ENOMEM;
+
+    major_number = register_chrdev(0, DEVICE_NAME, &fops);
+    if (major_number < 0) {
+        pr_err("eyes_driver: failed to register char device\n");
+        free_percpu(eyes_stats);
+        return major_number;
+    }
+
+    eyes_class = class_create(THIS_MODULE, CLASS_NAME);
+    if (IS_ERR(eyes_class)) {
+        unregister_chrdev(major_number, DEVICE_NAME);
+        free_percpu(eyes_stats);
+        pr_err("eyes_driver: failed to create class\n");
+        return PTR_ERR(eyes_class);
+    }
+
+    eyes_device = device_create(eyes_class, NULL, MKDEV(major_number, 0), NULL, DEVICE_NAME);
+    if (IS_ERR(eyes_device)) {
+        class_destroy(eyes_class);
+        unregister_chrdev(major_number, DEVICE_NAME);
+        free_percpu(eyes_stats);
+        pr_err("eyes_driver: failed to create device\n");
+        return PTR_ERR(eyes_device);
+    }
+
+    ret = device_create_file(eyes_device, &dev_attr_fifo);
+    if (!ret) {
+        ret = device_create_file(eyes_device, &dev_attr_filter);
+        if (ret)
+            device_remove_file(eyes_device, &dev_attr_fifo);
+    }
+    if (ret) {
+        device_destroy(eyes_class, MKDEV(major_number, 0));
+        class_destroy(eyes_class);
+        unregister_chrdev(major_number, DEVICE_NAME);
+        free_percpu(eyes_stats);
+        return ret;
+    }
+
+    mutex_init(&eyes_mutex);
+    eyes_debugfs = lnp_stats_debugfs_create(DEVICE_NAME, eyes_stats);
+    pr_info("eyes_driver: module loaded (major=%d)\n", major_number);
+    return 0;
 }
 
-eyes_device = device_create(eyes_class, NULL, MKDEV(major_number, 0), NULL, DEVICE_NAME);
-if (IS_ERR(eyes_device)) {
+static void __exit eyes_exit(void)
+{
+    hrtimer_cancel(&eyes_timer);
+    debugfs_remove_recursive(eyes_debugfs);
+    mutex_destroy(&eyes_mutex);
+    device_remove_file(eyes_device, &dev_attr_filter);
+    device_remove_file(eyes_device, &dev_attr_fifo);
+    device_destroy(eyes_class, MKDEV(major_number, 0));
     class_destroy(eyes_class);
     unregister_chrdev(major_number, DEVICE_NAME);
-    pr_err("eyes_driver: failed to create device\n");
-    return PTR_ERR(eyes_device);
+    free_percpu(eyes_stats);
+    pr_info("eyes_driver: module removed\n");
 }
 
-mutex_init(&eyes_mutex);
-pr_info("eyes_driver: module loaded (major=%d)\n", major_number);
-return 0;
-
-}
-
-static void __exit eyes_exit(void) { mutex_destroy(&eyes_mutex); device_destroy(eyes_class, MKDEV(major_number, 0)); class_unregister(eyes_class); class_destroy(eyes_class); unregister_chrdev(major_number, DEVICE_NAME); pr_info("eyes_driver: module removed\n"); }
-
-MODULE_LICENSE("Apache-2.0"); MODULE_AUTHOR("Linus Neural Project"); MODULE_DESCRIPTION("Experimental eye/ambient sensor character driver (simulated samples)"); MODULE_VERSION("0.1");
+/* hrtimer, debugfs, alloc_percpu and tracepoints work in GPL modules only */
+MODULE_LICENSE("Dual MIT/GPL");
+MODULE_AUTHOR("Linus Neural Project");
+MODULE_DESCRIPTION("Experimental eye/ambient sensor character driver (simulated samples)");
+MODULE_VERSION("0.5");
 
-module_init(eyes_init); module_exit(eyes_exit);
+module_init(eyes_init);
+module_exit(eyes_exit);
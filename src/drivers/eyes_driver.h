@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: GPL-2.0 OR MIT
+/*
+ * eyes_driver.h - User interface of /dev/eyes
+ *
+ * Shared between the eyes_driver module and user-space programs: the
+ * binary sample record and the ioctls that select the read format of an
+ * open file.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef LNP_EYES_DRIVER_H
+#define LNP_EYES_DRIVER_H
+
+#include <linux/types.h>
+#include <linux/ioctl.h>
+
+#define EYES_IOC_MAGIC 'E'
+#define EYES_ABI_VERSION 1
+
+/*
+ * Binary sample record (fixed size, stable within an ABI version).
+ * In EYES_MODE_BINARY a read() returns as many whole records as fit in
+ * the buffer; a buffer smaller than one record gets -EINVAL.
+ */
+struct eyes_record {
+    __u64 seq;          /* sampler sequence; gaps mean dropped (or filtered) samples */
+    __s64 ts_ns;        /* ideal sampling time, CLOCK_MONOTONIC */
+    __u16 x;            /* gaze x, 0..1920 */
+    __u16 y;            /* gaze y, 0..1080 */
+    __u16 lux;          /* ambient light */
+    __u8  flags;        /* EYES_REC_* */
+    __u8  reserved;
+};
+
+#define EYES_REC_BLINK      0x01
+/* events-only output ("output=events"): fixation bounds at the centroid */
+#define EYES_REC_FIX_START  0x02
+#define EYES_REC_FIX_END    0x04
+
+/* Read format of one open file; the default is the text format */
+#define EYES_MODE_TEXT   0
+#define EYES_MODE_BINARY 1
+
+struct eyes_abi {
+    __u32 version;      /* EYES_ABI_VERSION */
+    __u32 record_size;  /* sizeof(struct eyes_record) */
+};
+
+#define EYES_IOC_SET_MODE _IOW(EYES_IOC_MAGIC, 1, __u32)
+#define EYES_IOC_GET_MODE _IOR(EYES_IOC_MAGIC, 2, __u32)
+#define EYES_IOC_GET_ABI  _IOR(EYES_IOC_MAGIC, 3, struct eyes_abi)
+
+#endif /* LNP_EYES_DRIVER_H */
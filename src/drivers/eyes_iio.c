@@ -0,0 +1,214 @@
+// SPDX-License-Identifier: GPL-2.0 OR MIT
+/**
+ * eyes_iio.c - IIO triggered-buffer backend for the simulated eye sensor
+ *
+ * For the Linus Neural Project. Registers the eyes sensor (sample
+ * generation from eyes_core.h) with the Industrial I/O subsystem instead
+ * of the /dev/eyes character protocol, so standard buffered tools
+ * (iio_generic_buffer, libiio) can stream it through the kernel's buffer
+ * code. Channels, in scan order:
+ *   in_positionrelative_x_raw     gaze x, 0..1920
+ *   in_positionrelative_y_raw     gaze y, 0..1080
+ *   in_illuminance_raw            ambient light, lux
+ *   in_positionrelative_blink_raw 1 while the eye is closed
+ *   in_timestamp                  trigger time, ns
+ *
+ * Samples are taken on each trigger; pair the device with the standard
+ * hrtimer trigger (iio-trig-hrtimer), whose sampling_frequency attribute
+ * sets the rate:
+ *   mkdir /sys/kernel/config/iio/triggers/hrtimer/eyes-trig
+ *   echo 500 > /sys/bus/iio/devices/triggerN/sampling_frequency
+ *   iio_generic_buffer -n eyes -t eyes-trig -a -c 1000
+ *
+ * It is intended for educational and development use only.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/init.h>
+#include <linux/platform_device.h>
+#include <linux/interrupt.h>
+#include <linux/version.h>
+#include <linux/iio/iio.h>
+#include <linux/iio/buffer.h>
+#include <linux/iio/trigger.h>
+#include <linux/iio/trigger_consumer.h>
+#include <linux/iio/triggered_buffer.h>
+
+#include "eyes_core.h"
+
+#define DRIVER_NAME "eyes"
+
+static bool simulate_blink = true;
+module_param(simulate_blink, bool, 0644);
+MODULE_PARM_DESC(simulate_blink, "Generate random blinks (default: true)");
+
+enum eyes_iio_scan {
+    EYES_SCAN_X,
+    EYES_SCAN_Y,
+    EYES_SCAN_LUX,
+    EYES_SCAN_BLINK,
+    EYES_SCAN_TIMESTAMP,
+};
+
+struct eyes_iio {
+    /* scan buffer pushed on every trigger; timestamp 8-byte aligned */
+    struct {
+        u16 chan[4];
+        s64 timestamp __aligned(8);
+    } scan;
+};
+
+#define EYES_IIO_CHAN(_type, _mod, _name, _idx) {               \
+    .type = (_type),                                            \
+    .modified = (_mod) != IIO_NO_MOD,                           \
+    .channel2 = (_mod),                                         \
+    .extend_name = (_name),                                     \
+    .address = (_idx),                                          \
+    .scan_index = (_idx),                                       \
+    .info_mask_separate = BIT(IIO_CHAN_INFO_RAW),               \
+    .scan_type = {                                              \
+        .sign = 'u',                                            \
+        .realbits = 16,                                         \
+        .storagebits = 16,                                      \
+        .endianness = IIO_CPU,                                  \
+    },                                                          \
+}
+
+static const struct iio_chan_spec eyes_iio_channels[] = {
+    EYES_IIO_CHAN(IIO_POSITIONRELATIVE, IIO_MOD_X, NULL, EYES_SCAN_X),
+    EYES_IIO_CHAN(IIO_POSITIONRELATIVE, IIO_MOD_Y, NULL, EYES_SCAN_Y),
+    EYES_IIO_CHAN(IIO_LIGHT, IIO_NO_MOD, NULL, EYES_SCAN_LUX),
+    EYES_IIO_CHAN(IIO_POSITIONRELATIVE, IIO_NO_MOD, "blink", EYES_SCAN_BLINK),
+    IIO_CHAN_SOFT_TIMESTAMP(EYES_SCAN_TIMESTAMP),
+};
+
+static void eyes_iio_fill(u16 *chan)
+{
+    struct eyes_sample s;
+
+    eyes_core_generate(&s, READ_ONCE(simulate_blink));
+    chan[EYES_SCAN_X] = s.x;
+    chan[EYES_SCAN_Y] = s.y;
+    chan[EYES_SCAN_LUX] = s.lux;
+    chan[EYES_SCAN_BLINK] = s.blink;
+}
+
+/* Bottom half of the trigger: one sample, stamped with the trigger time */
+static irqreturn_t eyes_iio_trigger_handler(int irq, void *p)
+{
+    struct iio_poll_func *pf = p;
+    struct iio_dev *indio_dev = pf->indio_dev;
+    struct eyes_iio *st = iio_priv(indio_dev);
+
+    eyes_iio_fill(st->scan.chan);
+    iio_push_to_buffers_with_timestamp(indio_dev, &st->scan, pf->timestamp);
+    iio_trigger_notify_done(indio_dev->trig);
+    return IRQ_HANDLED;
+}
+
+/* Direct (unbuffered) reads of in_*_raw take a fresh sample */
+static int eyes_iio_read_raw(struct iio_dev *indio_dev, const struct iio_chan_spec *chan,
+                             int *val, int *val2, long mask)
+{
+    u16 sample[4];
+
+    if (mask != IIO_CHAN_INFO_RAW)
+        return -EINVAL;
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 15, 0)
+    if (!iio_device_claim_direct(indio_dev))
+        return -EBUSY;
+    eyes_iio_fill(sample);
+    iio_device_release_direct(indio_dev);
+#else
+    {
+        int ret = iio_device_claim_direct_mode(indio_dev);
+
+        if (ret)
+            return ret;
+        eyes_iio_fill(sample);
+        iio_device_release_direct_mode(indio_dev);
+    }
+#endif
+
+    *val = sample[chan->address];
+    return IIO_VAL_INT;
+}
+
+static const struct iio_info eyes_iio_info = {
+    .read_raw = eyes_iio_read_raw,
+};
+
+static int eyes_iio_probe(struct platform_device *pdev)
+{
+    struct iio_dev *indio_dev;
+    int ret;
+
+    indio_dev = devm_iio_device_alloc(&pdev->dev, sizeof(struct eyes_iio));
+    if (!indio_dev)
+        return -ENOMEM;
+
+    indio_dev->name = DRIVER_NAME;
+    indio_dev->info = &eyes_iio_info;
+    indio_dev->modes = INDIO_DIRECT_MODE;
+    indio_dev->channels = eyes_iio_channels;
+    indio_dev->num_channels = ARRAY_SIZE(eyes_iio_channels);
+
+    ret = devm_iio_triggered_buffer_setup(&pdev->dev, indio_dev, iio_pollfunc_store_time,
+                                          eyes_iio_trigger_handler, NULL);
+    if (ret)
+        return ret;
+
+    ret = devm_iio_device_register(&pdev->dev, indio_dev);
+    if (ret)
+        return ret;
+
+    pr_info("eyes_iio: IIO device registered\n");
+    return 0;
+}
+
+static struct platform_driver eyes_iio_driver = {
+    .probe = eyes_iio_probe,
+    .driver = {
+        .name = "eyes-iio",
+    },
+};
+
+/* The sensor is simulated: no DT/ACPI node, so the module creates its own device */
+static struct platform_device *eyes_iio_pdev;
+
+static int __init eyes_iio_init(void)
+{
+    int ret;
+
+    ret = platform_driver_register(&eyes_iio_driver);
+    if (ret)
+        return ret;
+
+    eyes_iio_pdev = platform_device_register_simple("eyes-iio", -1, NULL, 0);
+    if (IS_ERR(eyes_iio_pdev)) {
+        platform_driver_unregister(&eyes_iio_driver);
+        pr_err("eyes_iio: failed to create platform device\n");
+        return PTR_ERR(eyes_iio_pdev);
+    }
+    return 0;
+}
+
+static void __exit eyes_iio_exit(void)
+{
+    platform_device_unregister(eyes_iio_pdev);
+    platform_driver_unregister(&eyes_iio_driver);
+    pr_info("eyes_iio: module removed\n");
+}
+
+/* the IIO core exports its API to GPL modules only */
+MODULE_LICENSE("Dual MIT/GPL");
+MODULE_AUTHOR("Linus Neural Project");
+MODULE_DESCRIPTION("Experimental eye/ambient sensor IIO driver (simulated samples, triggered buffer)");
+MODULE_VERSION("0.1");
+
+module_init(eyes_iio_init);
+module_exit(eyes_iio_exit);
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-2.0 OR MIT
+/*
+ * eyes_trace.h - Tracepoints for eyes_driver
+ *
+ * Replace the per-operation pr_info/pr_debug calls; they cost nothing
+ * while disabled.
+ *   echo 1 > /sys/kernel/tracing/events/eyes/enable
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM eyes
+
+#if !defined(_EYES_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _EYES_TRACE_H
+
+#include <linux/tracepoint.h>
+
+TRACE_EVENT(eyes_open,
+    TP_PROTO(pid_t pid, int ret),
+    TP_ARGS(pid, ret),
+    TP_STRUCT__entry(
+        __field(pid_t, pid)
+        __field(int, ret)
+    ),
+    TP_fast_assign(
+        __entry->pid = pid;
+        __entry->ret = ret;
+    ),
+    TP_printk("pid=%d ret=%d", __entry->pid, __entry->ret)
+);
+
+TRACE_EVENT(eyes_release,
+    TP_PROTO(pid_t pid),
+    TP_ARGS(pid),
+    TP_STRUCT__entry(
+        __field(pid_t, pid)
+    ),
+    TP_fast_assign(
+        __entry->pid = pid;
+    ),
+    TP_printk("pid=%d", __entry->pid)
+);
+
+TRACE_EVENT(eyes_read,
+    TP_PROTO(unsigned int count, size_t bytes, long ret),
+    TP_ARGS(count, bytes, ret),
+    TP_STRUCT__entry(
+        __field(unsigned int, count)
+        __field(size_t, bytes)
+        __field(long, ret)
+    ),
+    TP_fast_assign(
+        __entry->count = count;
+        __entry->bytes = bytes;
+        __entry->ret = ret;
+    ),
+    TP_printk("count=%u bytes=%zu ret=%ld", __entry->count, __entry->bytes, __entry->ret)
+);
+
+TRACE_EVENT(eyes_sample,
+    TP_PROTO(u16 x, u16 y, u16 lux, bool blink, s64 ts_ns),
+    TP_ARGS(x, y, lux, blink, ts_ns),
+    TP_STRUCT__entry(
+        __field(u16, x)
+        __field(u16, y)
+        __field(u16, lux)
+        __field(bool, blink)
+        __field(s64, ts_ns)
+    ),
+    TP_fast_assign(
+        __entry->x = x;
+        __entry->y = y;
+        __entry->lux = lux;
+        __entry->blink = blink;
+        __entry->ts_ns = ts_ns;
+    ),
+    TP_printk("x=%u y=%u lux=%u blink=%d ts=%lld",
+              __entry->x, __entry->y, __entry->lux, __entry->blink, __entry->ts_ns)
+);
+
+TRACE_EVENT(eyes_command,
+    TP_PROTO(const char *cmd, int ret),
+    TP_ARGS(cmd, ret),
+    TP_STRUCT__entry(
+        __array(char, cmd, 64)
+        __field(int, ret)
+    ),
+    TP_fast_assign(
+        strscpy(__entry->cmd, cmd, sizeof(__entry->cmd));
+        __entry->ret = ret;
+    ),
+    TP_printk("cmd=%s ret=%d", __entry->cmd, __entry->ret)
+);
+
+#endif /* _EYES_TRACE_H */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE eyes_trace
+#include <trace/define_trace.h>
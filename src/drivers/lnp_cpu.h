@@ -0,0 +1,486 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_cpu.h - CPU feature detection and runtime ISA dispatch
+ *
+ * Shared by the arch init modules (src/arch/x86_64, src/arch/arm64) and by
+ * userspace code (liblnpdrv, the inference engine); C and C++. Detection
+ * looks at the hardware and at what the OS enabled:
+ *   kernel x86_64  boot_cpu_has() (cpuid as filtered by the kernel) plus
+ *                  XGETBV when OSXSAVE is set, as in userspace
+ *   kernel arm64   ID_AA64PFR0_EL1.AdvSIMD; SVE is never usable in kernel code
+ *   user x86_64    cpuid plus XGETBV: AVX2 needs YMM state enabled by the
+ *                  OS, AVX-512 also opmask and ZMM
+ *   user arm64     getauxval(AT_HWCAP): HWCAP_ASIMD, HWCAP_SVE
+ *
+ * A dispatched kernel is a table of struct lnp_impl, one entry per ISA it
+ * was written for, always with an LNP_ISA_SCALAR entry. lnp_dispatch()
+ * picks the best entry the mask allows; call it once at init and keep the
+ * pointer. Within an architecture a higher enum value is the better ISA.
+ *
+ * Nothing is built for hardware that may be absent: entries for ISAs above
+ * the build baseline are compiled only under their LNP_ARCH_* guard, with
+ * the LNP_TARGET_* attribute on that one function (or in a file of their
+ * own with the ISA flag, as SVE needs), and are reached only after
+ * detection set the bit. Do not build with -march=native. In the kernel
+ * the compiler may not emit SIMD at all: entries there are assembly,
+ * called between lnp_simd_begin() and lnp_simd_end(), and LNP_TARGET_* is
+ * not defined.
+ *
+ * The kernel side must stay loadable from modules that are not GPL (the
+ * arch init modules are Apache-2.0): lnp_cpu_detect() uses only symbols
+ * exported without _GPL. lnp_simd_begin()/lnp_simd_end() call
+ * kernel_fpu_begin()/kernel_neon_begin(), which are GPL-only: call them
+ * only from modules with a GPL-compatible MODULE_LICENSE.
+ *
+ * Cores are counted as distinct physical cores among the online CPUs, not
+ * as threads divided by the SMT width, which is wrong on hybrid parts
+ * (P-cores with SMT next to E-cores without).
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef LNP_CPU_H
+#define LNP_CPU_H
+
+#ifdef __KERNEL__
+#include <linux/kernel.h>
+#include <linux/types.h>
+#include <linux/string.h>
+#include <linux/cpumask.h>
+#include <linux/topology.h>
+#include <linux/cpufreq.h>
+#include <linux/slab.h>
+#include <linux/smp.h>
+#include <asm/simd.h>
+#if defined(CONFIG_X86)
+#include <asm/processor.h>
+#include <asm/cpufeature.h>
+#include <asm/fpu/api.h>
+#include <asm/fpu/xcr.h>
+#include <asm/tsc.h>
+#elif defined(CONFIG_ARM64)
+#include <asm/cputype.h>
+#include <asm/sysreg.h>
+#include <asm/neon.h>
+#endif
+#else
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#elif defined(__aarch64__)
+#include <sys/auxv.h>
+#endif
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LNP_ARCH_X86 1
+#elif defined(__aarch64__)
+#define LNP_ARCH_ARM64 1
+#endif
+
+#if !defined(__KERNEL__) && defined(LNP_ARCH_X86)
+#define LNP_TARGET_SSE42  __attribute__((target("sse4.2")))
+#define LNP_TARGET_AVX2   __attribute__((target("avx2")))
+#define LNP_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#endif
+
+enum lnp_isa {
+    LNP_ISA_SCALAR,
+    LNP_ISA_SSE42,
+    LNP_ISA_AVX2,
+    LNP_ISA_AVX512,     /* F + BW */
+    LNP_ISA_NEON,
+    LNP_ISA_SVE,
+    LNP_ISA_COUNT
+};
+
+#define LNP_ISA_BIT(isa) (1U << (isa))
+
+struct lnp_cpu_info {
+    char vendor[16];
+    char model[64];
+    unsigned int cores;
+    unsigned int threads;   /* online logical CPUs */
+    unsigned int mhz;       /* maximum, 0 if unknown */
+    uint32_t isa;           /* LNP_ISA_BIT() of the ISAs usable here */
+};
+
+typedef void (*lnp_fn)(void);
+
+struct lnp_impl {
+    enum lnp_isa isa;
+    lnp_fn fn;
+};
+
+#define LNP_IMPL(isa, fn) { (isa), (lnp_fn)(fn) }
+
+static inline const char *lnp_isa_name(enum lnp_isa isa)
+{
+    static const char *const names[LNP_ISA_COUNT] = {
+        "scalar", "sse4.2", "avx2", "avx512", "neon", "sve",
+    };
+
+    return (unsigned int)isa < LNP_ISA_COUNT ? names[isa] : "?";
+}
+
+/* LNP_ISA_COUNT if name is not an ISA */
+static inline enum lnp_isa lnp_isa_from_name(const char *name)
+{
+    int i;
+
+    for (i = 0; i < LNP_ISA_COUNT; i++)
+        if (!strcmp(name, lnp_isa_name((enum lnp_isa)i)))
+            return (enum lnp_isa)i;
+    return LNP_ISA_COUNT;
+}
+
+/* Best ISA in mask, as a dispatch with every entry present would pick */
+static inline enum lnp_isa lnp_isa_best(uint32_t mask)
+{
+    int i;
+
+    for (i = LNP_ISA_COUNT - 1; i > 0; i--)
+        if (mask & LNP_ISA_BIT(i))
+            return (enum lnp_isa)i;
+    return LNP_ISA_SCALAR;
+}
+
+/* mask without the ISAs above max (same architecture), for testing the lower paths */
+static inline uint32_t lnp_isa_upto(uint32_t mask, enum lnp_isa max)
+{
+    return mask & (LNP_ISA_BIT(max) | (LNP_ISA_BIT(max) - 1));
+}
+
+/* Entry of the best ISA in mask; NULL only for a table without a scalar entry */
+static inline const struct lnp_impl *lnp_dispatch(const struct lnp_impl *impl, size_t n,
+                                                  uint32_t mask)
+{
+    const struct lnp_impl *best = NULL;
+    size_t i;
+
+    mask |= LNP_ISA_BIT(LNP_ISA_SCALAR);
+    for (i = 0; i < n; i++)
+        if ((mask & LNP_ISA_BIT(impl[i].isa)) && (!best || impl[i].isa > best->isa))
+            best = &impl[i];
+    return best;
+}
+
+#if defined(LNP_ARCH_ARM64)
+/* MIDR_EL1 -> vendor and core name; the parts shipping in boards we target */
+static inline void lnp_cpu_arm_name(struct lnp_cpu_info *ci, uint64_t midr)
+{
+    static const struct { uint16_t part; const char *name; } arm_parts[] = {
+        { 0xd03, "Cortex-A53" }, { 0xd05, "Cortex-A55" }, { 0xd07, "Cortex-A57" },
+        { 0xd08, "Cortex-A72" }, { 0xd09, "Cortex-A73" }, { 0xd0a, "Cortex-A75" },
+        { 0xd0b, "Cortex-A76" }, { 0xd0c, "Neoverse-N1" }, { 0xd0d, "Cortex-A77" },
+        { 0xd40, "Neoverse-V1" }, { 0xd41, "Cortex-A78" }, { 0xd44, "Cortex-X1" },
+        { 0xd46, "Cortex-A510" }, { 0xd47, "Cortex-A710" }, { 0xd48, "Cortex-X2" },
+        { 0xd49, "Neoverse-N2" }, { 0xd4d, "Cortex-A715" }, { 0xd4e, "Cortex-X3" },
+        { 0xd4f, "Neoverse-V2" },
+    };
+    unsigned int impl = (midr >> 24) & 0xff, part = (midr >> 4) & 0xfff;
+    unsigned int var = (midr >> 20) & 0xf, rev = midr & 0xf;
+    const char *vendor = NULL, *name = NULL;
+    size_t i;
+
+    switch (impl) {
+    case 0x41: vendor = "ARM"; break;
+    case 0x46: vendor = "Fujitsu"; break;
+    case 0x48: vendor = "HiSilicon"; break;
+    case 0x51: vendor = "Qualcomm"; break;
+    case 0x61: vendor = "Apple"; break;
+    case 0xc0: vendor = "Ampere"; break;
+    }
+    if (vendor)
+        snprintf(ci->vendor, sizeof(ci->vendor), "%s", vendor);
+    else
+        snprintf(ci->vendor, sizeof(ci->vendor), "0x%02x", impl);
+
+    for (i = 0; impl == 0x41 && i < sizeof(arm_parts) / sizeof(arm_parts[0]); i++)
+        if (arm_parts[i].part == part)
+            name = arm_parts[i].name;
+    if (name)
+        snprintf(ci->model, sizeof(ci->model), "%s r%up%u", name, var, rev);
+    else
+        snprintf(ci->model, sizeof(ci->model), "part 0x%03x r%up%u", part, var, rev);
+}
+#endif
+
+#ifdef __KERNEL__
+
+/* Where kernel code may not touch SIMD registers (some IRQ contexts) */
+static inline bool lnp_simd_usable(void)
+{
+    return may_use_simd();
+}
+
+/* Around calls of a dispatched entry; nothing to do for the scalar one */
+static inline void lnp_simd_begin(enum lnp_isa isa)
+{
+    if (isa == LNP_ISA_SCALAR)
+        return;
+#if defined(CONFIG_X86)
+    kernel_fpu_begin();
+#elif defined(CONFIG_ARM64)
+    kernel_neon_begin();
+#endif
+}
+
+static inline void lnp_simd_end(enum lnp_isa isa)
+{
+    if (isa == LNP_ISA_SCALAR)
+        return;
+#if defined(CONFIG_X86)
+    kernel_fpu_end();
+#elif defined(CONFIG_ARM64)
+    kernel_neon_end();
+#endif
+}
+
+#if defined(CONFIG_ARM64)
+static inline void lnp_cpu_read_mpidr(void *arg)
+{
+    *(u64 *)arg = read_cpuid_mpidr();
+}
+#endif
+
+/*
+ * Physical cores among the online CPUs. x86: distinct (package, core) pairs
+ * from cpu_data. arm64: without MPIDR_EL1.MT every CPU is a core; with it,
+ * Aff0 is the thread and the cores are the distinct Aff3..Aff1, read on each
+ * CPU (MPIDR is per CPU). The topology masks are not used: arm64 exports
+ * cpu_topology GPL-only.
+ */
+static inline unsigned int lnp_cpu_count_cores(unsigned int threads)
+{
+#if defined(CONFIG_X86)
+    unsigned int cores = 0, cpu, prev;
+
+    for_each_online_cpu(cpu) {
+        bool seen = false;
+
+        for_each_online_cpu(prev) {
+            if (prev >= cpu)
+                break;
+            if (topology_physical_package_id(prev) == topology_physical_package_id(cpu) &&
+                topology_core_id(prev) == topology_core_id(cpu)) {
+                seen = true;
+                break;
+            }
+        }
+        cores += !seen;
+    }
+    return cores ? cores : threads;
+#elif defined(CONFIG_ARM64)
+    unsigned int cores = 0, cpu, n = 0, i;
+    u64 *core_id;
+
+    if (!(read_cpuid_mpidr() & MPIDR_MT_BITMASK))
+        return threads;
+    core_id = kmalloc_array(nr_cpu_ids, sizeof(*core_id), GFP_KERNEL);
+    if (!core_id)
+        return threads;
+    for_each_online_cpu(cpu) {
+        u64 mpidr;
+
+        if (smp_call_function_single(cpu, lnp_cpu_read_mpidr, &mpidr, 1))
+            continue;
+        mpidr = (mpidr & MPIDR_HWID_BITMASK) >> MPIDR_LEVEL_BITS;
+        for (i = 0; i < n && core_id[i] != mpidr; i++)
+            ;
+        if (i == n) {
+            core_id[n++] = mpidr;
+            cores++;
+        }
+    }
+    kfree(core_id);
+    return cores ? cores : threads;
+#else
+    return threads;
+#endif
+}
+
+static inline void lnp_cpu_detect(struct lnp_cpu_info *ci)
+{
+    unsigned int khz;
+
+    memset(ci, 0, sizeof(*ci));
+    ci->isa = LNP_ISA_BIT(LNP_ISA_SCALAR);
+    ci->threads = num_online_cpus();
+    ci->cores = lnp_cpu_count_cores(ci->threads);
+    khz = cpufreq_quick_get_max(0);
+
+#if defined(CONFIG_X86)
+    {
+        u64 xcr0 = 0;
+
+        strscpy(ci->vendor, boot_cpu_data.x86_vendor_id, sizeof(ci->vendor));
+        strscpy(ci->model, boot_cpu_data.x86_model_id, sizeof(ci->model));
+        if (!khz)
+            khz = cpu_khz;
+        if (boot_cpu_has(X86_FEATURE_OSXSAVE))
+            xcr0 = xgetbv(XCR_XFEATURE_ENABLED_MASK);
+        if (boot_cpu_has(X86_FEATURE_XMM4_2))
+            ci->isa |= LNP_ISA_BIT(LNP_ISA_SSE42);
+        /* XCR0: 0x06 = SSE + YMM; 0xe6 also opmask, ZMM_Hi256, Hi16_ZMM */
+        if (boot_cpu_has(X86_FEATURE_AVX2) && (xcr0 & 0x06) == 0x06)
+            ci->isa |= LNP_ISA_BIT(LNP_ISA_AVX2);
+        if (boot_cpu_has(X86_FEATURE_AVX512F) && boot_cpu_has(X86_FEATURE_AVX512BW) &&
+            (xcr0 & 0xe6) == 0xe6)
+            ci->isa |= LNP_ISA_BIT(LNP_ISA_AVX512);
+    }
+#elif defined(CONFIG_ARM64)
+    lnp_cpu_arm_name(ci, read_cpuid_id());
+    /* AdvSIMD, bits 23:20: 0xf = not implemented */
+    if (((read_sysreg_s(SYS_ID_AA64PFR0_EL1) >> 20) & 0xf) != 0xf)
+        ci->isa |= LNP_ISA_BIT(LNP_ISA_NEON);
+#endif
+    ci->mhz = khz / 1000;
+}
+
+#else /* !__KERNEL__ */
+
+static inline bool lnp_simd_usable(void)
+{
+    return true;
+}
+
+static inline void lnp_simd_begin(enum lnp_isa isa)
+{
+    (void)isa;
+}
+
+static inline void lnp_simd_end(enum lnp_isa isa)
+{
+    (void)isa;
+}
+
+/* First number in a sysfs/procfs file, 0 if it cannot be read */
+static inline unsigned long long lnp_cpu_read_ull(const char *path, int base)
+{
+    unsigned long long v = 0;
+    char buf[64];
+    FILE *f = fopen(path, "r");
+
+    if (!f)
+        return 0;
+    if (fgets(buf, sizeof(buf), f))
+        v = strtoull(buf, NULL, base);
+    fclose(f);
+    return v;
+}
+
+/*
+ * Physical cores among the online CPUs: a CPU is counted when it is the
+ * lowest of its thread_siblings_list. threads if sysfs has no topology.
+ */
+static inline unsigned int lnp_cpu_count_cores(unsigned int threads)
+{
+    long conf = sysconf(_SC_NPROCESSORS_CONF);
+    unsigned int cores = 0;
+    char path[96];
+    long cpu;
+
+    for (cpu = 0; cpu < conf; cpu++) {
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%ld/online", cpu);
+        if (!access(path, R_OK) && !lnp_cpu_read_ull(path, 10))
+            continue;
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu%ld/topology/thread_siblings_list", cpu);
+        if (access(path, R_OK))
+            continue;
+        if (lnp_cpu_read_ull(path, 10) == (unsigned long long)cpu)
+            cores++;
+    }
+    return cores ? cores : threads;
+}
+
+#if defined(LNP_ARCH_X86)
+static inline uint64_t lnp_cpu_xgetbv0(void)
+{
+    uint32_t lo, hi;
+
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t)hi << 32) | lo;
+}
+#endif
+
+static inline void lnp_cpu_detect(struct lnp_cpu_info *ci)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    memset(ci, 0, sizeof(*ci));
+    ci->isa = LNP_ISA_BIT(LNP_ISA_SCALAR);
+    ci->threads = n > 0 ? (unsigned int)n : 1;
+    ci->mhz = (unsigned int)(lnp_cpu_read_ull(
+        "/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq", 10) / 1000);
+
+#if defined(LNP_ARCH_X86)
+    {
+        unsigned int max, a, b, c, d, i;
+        uint64_t xcr0 = 0;
+
+        __cpuid(0, max, b, c, d);
+        memcpy(ci->vendor, &b, 4);
+        memcpy(ci->vendor + 4, &d, 4);
+        memcpy(ci->vendor + 8, &c, 4);
+
+        if (__get_cpuid_max(0x80000000, NULL) >= 0x80000004) {
+            unsigned int brand[13] = { 0 };
+            const char *p = (const char *)brand;
+
+            for (i = 0; i < 3; i++)
+                __cpuid(0x80000002 + i, brand[4 * i], brand[4 * i + 1],
+                        brand[4 * i + 2], brand[4 * i + 3]);
+            while (*p == ' ')
+                p++;
+            snprintf(ci->model, sizeof(ci->model), "%s", p);
+        }
+
+        __cpuid(1, a, b, c, d);
+        if (c & (1U << 20))
+            ci->isa |= LNP_ISA_BIT(LNP_ISA_SSE42);
+        if (c & (1U << 27))                     /* OSXSAVE */
+            xcr0 = lnp_cpu_xgetbv0();
+        if (max >= 7) {
+            __cpuid_count(7, 0, a, b, c, d);
+            if ((b & (1U << 5)) && (xcr0 & 0x06) == 0x06)
+                ci->isa |= LNP_ISA_BIT(LNP_ISA_AVX2);
+            if ((b & (1U << 16)) && (b & (1U << 30)) && (xcr0 & 0xe6) == 0xe6)
+                ci->isa |= LNP_ISA_BIT(LNP_ISA_AVX512);
+        }
+        if (!ci->mhz && max >= 0x16) {
+            __cpuid(0x16, a, b, c, d);
+            ci->mhz = a & 0xffff;                           /* base frequency */
+        }
+    }
+#elif defined(LNP_ARCH_ARM64)
+    {
+#ifndef HWCAP_ASIMD
+#define HWCAP_ASIMD (1UL << 1)
+#endif
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1UL << 22)
+#endif
+        unsigned long hwcap = getauxval(AT_HWCAP);
+
+        lnp_cpu_arm_name(ci, lnp_cpu_read_ull(
+            "/sys/devices/system/cpu/cpu0/regs/identification/midr_el1", 16));
+        if (hwcap & HWCAP_ASIMD)
+            ci->isa |= LNP_ISA_BIT(LNP_ISA_NEON);
+        if (hwcap & HWCAP_SVE)
+            ci->isa |= LNP_ISA_BIT(LNP_ISA_SVE);
+    }
+#endif
+    ci->cores = lnp_cpu_count_cores(ci->threads);
+}
+
+#endif /* __KERNEL__ */
+
+#endif /* LNP_CPU_H */
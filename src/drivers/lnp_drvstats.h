@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-2.0 OR MIT
+/*
+ * lnp_drvstats.h - Per-CPU driver statistics for the Linus Neural drivers
+ *
+ * Counters are bumped with this_cpu ops (no shared cache lines, no locks)
+ * and summed over all CPUs only when the debugfs files are read:
+ *   /sys/kernel/debug/<driver>/stats         totals
+ *   /sys/kernel/debug/<driver>/read_latency  log2 histogram of read() time
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef LNP_DRVSTATS_H
+#define LNP_DRVSTATS_H
+
+#include <linux/percpu.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/log2.h>
+#include <linux/string.h>
+
+#define LNP_LAT_BUCKETS 32      /* bucket i counts reads of [2^i, 2^(i+1)) ns */
+
+struct lnp_drv_stats {
+    u64 samples;                /* samples generated */
+    u64 bytes;                  /* bytes copied to user space */
+    u64 copy_failures;          /* failed copy_to_user / copy_from_user */
+    u64 busy;                   /* requests rejected with -EBUSY / -EAGAIN */
+    u64 dropped;                /* samples lost to queue overflow or missed periods */
+    u64 read_lat[LNP_LAT_BUCKETS];
+};
+
+static inline void lnp_stats_read_latency(struct lnp_drv_stats __percpu *s, u64 ns)
+{
+    unsigned int b = ns ? ilog2(ns) : 0;
+
+    if (b >= LNP_LAT_BUCKETS)
+        b = LNP_LAT_BUCKETS - 1;
+    this_cpu_inc(s->read_lat[b]);
+}
+
+static inline void lnp_stats_sum(struct lnp_drv_stats __percpu *s, struct lnp_drv_stats *sum)
+{
+    int cpu, i;
+
+    memset(sum, 0, sizeof(*sum));
+    for_each_possible_cpu(cpu) {
+        const struct lnp_drv_stats *c = per_cpu_ptr(s, cpu);
+
+        sum->samples += READ_ONCE(c->samples);
+        sum->bytes += READ_ONCE(c->bytes);
+        sum->copy_failures += READ_ONCE(c->copy_failures);
+        sum->busy += READ_ONCE(c->busy);
+        sum->dropped += READ_ONCE(c->dropped);
+        for (i = 0; i < LNP_LAT_BUCKETS; i++)
+            sum->read_lat[i] += READ_ONCE(c->read_lat[i]);
+    }
+}
+
+static int lnp_stats_show(struct seq_file *m, void *v)
+{
+    struct lnp_drv_stats sum;
+
+    lnp_stats_sum((struct lnp_drv_stats __percpu *)m->private, &sum);
+    seq_printf(m, "samples %llu\n", sum.samples);
+    seq_printf(m, "bytes %llu\n", sum.bytes);
+    seq_printf(m, "copy_failures %llu\n", sum.copy_failures);
+    seq_printf(m, "busy %llu\n", sum.busy);
+    seq_printf(m, "dropped %llu\n", sum.dropped);
+    return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(lnp_stats);
+
+static int lnp_read_latency_show(struct seq_file *m, void *v)
+{
+    struct lnp_drv_stats sum;
+    int i;
+
+    lnp_stats_sum((struct lnp_drv_stats __percpu *)m->private, &sum);
+    seq_puts(m, "ns_from ns_to count\n");
+    for (i = 0; i < LNP_LAT_BUCKETS; i++) {
+        if (sum.read_lat[i])
+            seq_printf(m, "%llu %llu %llu\n", 1ULL << i, (1ULL << (i + 1)) - 1, sum.read_lat[i]);
+    }
+    return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(lnp_read_latency);
+
+/* Creates /sys/kernel/debug/<name>/{stats,read_latency}; debugfs errors are not fatal */
+static inline struct dentry *lnp_stats_debugfs_create(const char *name, struct lnp_drv_stats __percpu *s)
+{
+    struct dentry *dir = debugfs_create_dir(name, NULL);
+
+    debugfs_create_file("stats", 0444, dir, (void __force *)s, &lnp_stats_fops);
+    debugfs_create_file("read_latency", 0444, dir, (void __force *)s, &lnp_read_latency_fops);
+    return dir;
+}
+
+#endif /* LNP_DRVSTATS_H */
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_kshim.h - Userspace stand-ins for the kernel API used by the driver cores
+ *
+ * neural_core.h, eyes_core.h and touch_core.h include this header instead
+ * of <linux/...> when __KERNEL__ is not defined, so the sample generation,
+ * ring and formatting code builds unchanged into a userspace library
+ * (src/drivers/user) for benchmarking without loading modules.
+ *
+ * Only what the cores need is provided:
+ *   copy_to_user/copy_from_user  memcpy, never fault
+ *   get_random_bytes             per-thread xorshift64*, seeded from getrandom()
+ *                                (cheaper than the kernel's ChaCha; compare
+ *                                relative, not absolute, numbers)
+ *   ktime_get/ktime_get_ns       CLOCK_MONOTONIC
+ *   mutex, spinlock              pthread mutex / spinlock
+ *   atomic64, READ_ONCE, smp_*mb C11 atomics and fences
+ *   div_u64/div_s64, max_t       plain C division and comparison
+ *   le16_to_cpu/le32_to_cpu      <endian.h>
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef LNP_KSHIM_H
+#define LNP_KSHIM_H
+
+#ifdef __KERNEL__
+#error "lnp_kshim.h is for userspace builds only"
+#endif
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <endian.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/types.h>
+#include <sys/random.h>
+#include <linux/types.h>
+
+typedef __u8  u8;
+typedef __u16 u16;
+typedef __u32 u32;
+typedef __u64 u64;
+typedef __s32 s32;
+typedef __s64 s64;
+typedef s64 ktime_t;
+
+#define __user
+#define __percpu
+
+#ifndef PAGE_SIZE
+#define PAGE_SIZE 4096UL
+#endif
+
+#define READ_ONCE(x)     (*(const volatile __typeof__(x) *)&(x))
+#define WRITE_ONCE(x, v) (*(volatile __typeof__(x) *)&(x) = (v))
+
+#define smp_wmb() atomic_thread_fence(memory_order_release)
+#define smp_rmb() atomic_thread_fence(memory_order_acquire)
+
+typedef struct { _Atomic u64 counter; } atomic64_t;
+#define ATOMIC64_INIT(i) { (i) }
+
+static inline u64 atomic64_read(atomic64_t *v)
+{
+    return atomic_load_explicit(&v->counter, memory_order_relaxed);
+}
+
+static inline void atomic64_set(atomic64_t *v, u64 i)
+{
+    atomic_store_explicit(&v->counter, i, memory_order_relaxed);
+}
+
+static inline u64 atomic64_read_acquire(atomic64_t *v)
+{
+    return atomic_load_explicit(&v->counter, memory_order_acquire);
+}
+
+static inline void atomic64_set_release(atomic64_t *v, u64 i)
+{
+    atomic_store_explicit(&v->counter, i, memory_order_release);
+}
+
+typedef pthread_spinlock_t spinlock_t;
+#define spin_lock_init(l)               pthread_spin_init((l), PTHREAD_PROCESS_PRIVATE)
+#define spin_lock_irqsave(l, flags)     do { (flags) = 0; pthread_spin_lock(l); } while (0)
+#define spin_unlock_irqrestore(l, flags) do { (void)(flags); pthread_spin_unlock(l); } while (0)
+
+struct mutex { pthread_mutex_t m; };
+#define DEFINE_MUTEX(name) struct mutex name = { PTHREAD_MUTEX_INITIALIZER }
+#define mutex_init(l)                   pthread_mutex_init(&(l)->m, NULL)
+#define mutex_destroy(l)                pthread_mutex_destroy(&(l)->m)
+#define mutex_lock(l)                   pthread_mutex_lock(&(l)->m)
+#define mutex_lock_interruptible(l)     (pthread_mutex_lock(&(l)->m), 0)
+#define mutex_trylock(l)                (pthread_mutex_trylock(&(l)->m) == 0)
+#define mutex_unlock(l)                 pthread_mutex_unlock(&(l)->m)
+
+static inline unsigned long copy_to_user(void __user *to, const void *from, unsigned long n)
+{
+    memcpy(to, from, n);
+    return 0;
+}
+
+static inline unsigned long copy_from_user(void *to, const void __user *from, unsigned long n)
+{
+    memcpy(to, from, n);
+    return 0;
+}
+
+static inline void get_random_bytes(void *buf, int len)
+{
+    static __thread u64 state;
+    unsigned char *p = buf;
+    u64 x;
+
+    if (!state) {
+        if (getrandom(&state, sizeof(state), 0) != sizeof(state) || !state)
+            state = 0x9e3779b97f4a7c15ULL ^ (u64)(uintptr_t)&state;
+    }
+    while (len > 0) {
+        int n = len < 8 ? len : 8;
+
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        x = state * 0x2545f4914f6cdd1dULL;
+        memcpy(p, &x, n);
+        p += n;
+        len -= n;
+    }
+}
+
+static inline u64 ktime_get_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#define ktime_get()      ((ktime_t)ktime_get_ns())
+#define ktime_to_ns(kt)  ((s64)(kt))
+#define ns_to_ktime(ns)  ((ktime_t)(ns))
+
+static inline u64 div_u64(u64 dividend, u32 divisor) { return dividend / divisor; }
+static inline s64 div_s64(s64 dividend, s32 divisor) { return dividend / divisor; }
+static inline u64 div64_u64(u64 dividend, u64 divisor) { return dividend / divisor; }
+
+#define le16_to_cpu(x) le16toh(x)
+#define le32_to_cpu(x) le32toh(x)
+
+#define max_t(type, a, b) ((type)(a) > (type)(b) ? (type)(a) : (type)(b))
+#define min_t(type, a, b) ((type)(a) < (type)(b) ? (type)(a) : (type)(b))
+
+static inline int scnprintf(char *buf, size_t size, const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    if (size == 0)
+        return 0;
+    va_start(ap, fmt);
+    n = vsnprintf(buf, size, fmt, ap);
+    va_end(ap);
+    if (n < 0)
+        return 0;
+    return (size_t)n >= size ? (int)size - 1 : n;
+}
+
+#endif /* LNP_KSHIM_H */
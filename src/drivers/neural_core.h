@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: GPL-2.0 OR MIT
+/*
+ * neural_core.h - Núcleo portátil do /dev/neural
+ *
+ * Anel de amostras, produtor, leitura por cursor e formatação de texto,
+ * sem dependência de file_operations. O mesmo código compila no módulo
+ * (neural_driver.c) e, via lnp_kshim.h, na biblioteca user-space de
+ * src/drivers/user usada pelos benchmarks e pelo dispositivo CUSE.
+ *
+ * Estatísticas por CPU e tracepoints ficam no driver, em volta destas
+ * funções.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef LNP_NEURAL_CORE_H
+#define LNP_NEURAL_CORE_H
+
+#ifdef __KERNEL__
+#include <linux/kernel.h>
+#include <linux/types.h>
+#include <linux/errno.h>
+#include <linux/atomic.h>
+#include <linux/spinlock.h>
+#include <linux/random.h>
+#include <linux/uaccess.h>
+#else
+#include "lnp_kshim.h"
+#endif
+
+#include "neural_driver.h"
+
+#define NEURAL_RING_SIZE 4096           /* amostras; potência de 2 */
+#define NEURAL_RING_MASK (NEURAL_RING_SIZE - 1)
+#define NEURAL_RING_BYTES (NEURAL_RING_SIZE * sizeof(struct neural_sample))
+#define NEURAL_LINE_MAX  96
+
+/* Anel compartilhado: um produtor por vez, leitores sem trava */
+struct neural_core {
+    struct neural_ring_ctrl *ctrl;      /* espelho de head/tail para mmap */
+    struct neural_sample *ring;
+    atomic64_t head;                    /* próxima sequência a gravar */
+    spinlock_t lock;                    /* serializa produtores */
+};
+
+// Posição de um leitor no anel e suas contagens
+struct neural_cursor {
+    u64 pos;
+    u64 delivered;
+    u64 dropped;
+};
+
+/*
+ * base aponta para a página de controle; o anel começa em data_offset.
+ * No módulo é o buffer de vmalloc_user(), em user-space um malloc comum.
+ */
+static inline void neural_core_init(struct neural_core *c, void *base, u32 data_offset)
+{
+    c->ctrl = base;
+    c->ring = (struct neural_sample *)((char *)base + data_offset);
+    atomic64_set(&c->head, 0);
+    spin_lock_init(&c->lock);
+
+    c->ctrl->version = NEURAL_ABI_VERSION;
+    c->ctrl->record_size = sizeof(struct neural_sample);
+    c->ctrl->ring_size = NEURAL_RING_SIZE;
+    c->ctrl->data_offset = data_offset;
+}
+
+/* Produz uma amostra simulada; devolve a sequência gravada e o valor em *uv */
+static inline u64 neural_core_produce(struct neural_core *c, u64 ts_ns, s32 *uv)
+{
+    struct neural_sample *slot;
+    unsigned long flags;
+    u32 noise;
+    u64 seq;
+
+    get_random_bytes(&noise, sizeof(noise));
+
+    spin_lock_irqsave(&c->lock, flags);
+    seq = atomic64_read(&c->head);
+    slot = &c->ring[seq & NEURAL_RING_MASK];
+
+    /* marca o slot como instável enquanto é reescrito */
+    WRITE_ONCE(slot->seq, NEURAL_SEQ_BUSY);
+    smp_wmb();
+    slot->ts_ns = ts_ns;
+    slot->uv = (s32)(noise % 200) - 100;    /* -100..99 µV */
+    slot->flags = 0;
+    smp_wmb();
+    WRITE_ONCE(slot->seq, seq);
+    if (uv)
+        *uv = slot->uv;
+
+    atomic64_set_release(&c->head, seq + 1);
+    /* espelho para consumidores via mmap: slot visível antes do head */
+    smp_wmb();
+    WRITE_ONCE(c->ctrl->head, seq + 1);
+    WRITE_ONCE(c->ctrl->tail, seq + 1 > NEURAL_RING_SIZE ? seq + 1 - NEURAL_RING_SIZE : 0);
+    spin_unlock_irqrestore(&c->lock, flags);
+    return seq;
+}
+
+static inline bool neural_core_pending(struct neural_core *c, const struct neural_cursor *cur)
+{
+    return atomic64_read_acquire(&c->head) != READ_ONCE(cur->pos);
+}
+
+/*
+ * Copia a próxima amostra do leitor. Retorna -EAGAIN quando o leitor já
+ * está em dia com o produtor. Amostras sobrescritas antes da leitura são
+ * contadas em cur->dropped.
+ */
+static inline int neural_core_fetch(struct neural_core *c, struct neural_cursor *cur,
+                                    struct neural_sample *out)
+{
+    const struct neural_sample *slot;
+    u64 head, seq;
+
+    for (;;) {
+        head = atomic64_read_acquire(&c->head);
+        if (cur->pos == head)
+            return -EAGAIN;
+        if (head - cur->pos > NEURAL_RING_SIZE) {
+            cur->dropped += head - cur->pos - NEURAL_RING_SIZE;
+            cur->pos = head - NEURAL_RING_SIZE;
+        }
+
+        slot = &c->ring[cur->pos & NEURAL_RING_MASK];
+        seq = READ_ONCE(slot->seq);
+        smp_rmb();
+        out->ts_ns = slot->ts_ns;
+        out->uv = slot->uv;
+        out->flags = slot->flags;
+        smp_rmb();
+        if (seq == cur->pos && READ_ONCE(slot->seq) == seq) {
+            out->seq = seq;
+            cur->pos++;
+            return 0;
+        }
+        /* o produtor deu a volta durante a cópia: recomeça do mais antigo */
+        cur->dropped++;
+        cur->pos++;
+    }
+}
+
+static inline int neural_core_format(char *buf, size_t size, const struct neural_sample *s)
+{
+    return scnprintf(buf, size, "[neural_driver] Atividade cerebral detectada: %d µV\n", s->uv);
+}
+
+/*
+ * Entrega tantas linhas do atraso do leitor quantas couberem em len.
+ * Sem nenhuma amostra pendente retorna -EAGAIN (o chamador decide entre
+ * produzir, bloquear ou desistir); se nem a primeira linha couber,
+ * -EINVAL. Uma amostra que não pôde ser entregue volta para o cursor.
+ */
+static inline ssize_t neural_core_read_text(struct neural_core *c, struct neural_cursor *cur,
+                                            char __user *buffer, size_t len)
+{
+    struct neural_sample s;
+    char line[NEURAL_LINE_MAX];
+    size_t done = 0, n;
+    ssize_t ret = 0;
+
+    while (done < len) {
+        if (neural_core_fetch(c, cur, &s)) {
+            if (!done)
+                ret = -EAGAIN;
+            break;
+        }
+
+        n = neural_core_format(line, sizeof(line), &s);
+        if (n > len - done) {
+            /* não cabe: devolve a amostra para a próxima leitura */
+            cur->pos--;
+            ret = -EINVAL;
+            break;
+        }
+        if (copy_to_user(buffer + done, line, n)) {
+            cur->pos--;
+            ret = -EFAULT;
+            break;
+        }
+        done += n;
+        cur->delivered++;
+    }
+    return done ? (ssize_t)done : ret;
+}
+
+#endif /* LNP_NEURAL_CORE_H */
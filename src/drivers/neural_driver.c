@@ -1,10 +1,27 @@
-// SPDX-License-Identifier: Apache-2.0
+// SPDX-License-Identifier: GPL-2.0 OR MIT
 /*
  * neural_driver.c - Experimental Neural Interface Kernel Module
  *
  * Este módulo demonstra um driver de interface neural em nível de kernel.
  * Simula leitura e escrita de “sinais neurais”, apenas para estudo.
  *
+ * Vários processos podem abrir /dev/neural ao mesmo tempo: as amostras
+ * ficam num anel compartilhado e cada open() tem seu próprio cursor, de
+ * modo que um gravador e um visualizador consomem a mesma fonte de forma
+ * independente. O caminho de leitura não usa trava global.
+ *
+ * O anel também pode ser mapeado em user-space (mmap somente leitura):
+ * uma página de controle com head/tail seguida dos registros binários
+ * struct neural_sample, sem cópias nem syscalls para consumir amostras.
+ *
+ * Com uma taxa configurada ("rate=N" via write ou NEURAL_IOC_SET_RATE) um
+ * hrtimer produz as amostras em ritmo fixo, com o instante ideal de cada
+ * período como timestamp; read() bloqueia até haver dados e poll()/epoll
+ * acordam os consumidores. Com taxa 0 a amostra é gerada na leitura.
+ *
+ * Contadores por CPU ficam em /sys/kernel/debug/neural/ e os eventos por
+ * operação são tracepoints (events/neural/), sem printk no caminho quente.
+ *
  * Copyright (c) 2025 Linus Neural Project
  */
 
@@ -15,44 +32,197 @@
 #include <linux/uaccess.h>
 #include <linux/device.h>
 #include <linux/mutex.h>
+#include <linux/spinlock.h>
+#include <linux/atomic.h>
+#include <linux/list.h>
+#include <linux/slab.h>
+#include <linux/sched.h>
+#include <linux/ktime.h>
 #include <linux/random.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
+#include <linux/version.h>
+#include <linux/hrtimer.h>
+#include <linux/wait.h>
+#include <linux/poll.h>
+
+#include "neural_core.h"
+#include "lnp_drvstats.h"
+
+#define CREATE_TRACE_POINTS
+#include "neural_trace.h"
 
 #define DEVICE_NAME "neural"
 #define CLASS_NAME  "neuralnet"
 
+#define NEURAL_MMAP_BYTES (PAGE_SIZE + PAGE_ALIGN(NEURAL_RING_BYTES))
+#define NEURAL_MAX_CATCHUP 64           /* períodos perdidos repostos por disparo */
+#define NEURAL_BATCH_CHUNK 16           /* registros por copy_to_user no lote */
+
 static int    major_number;
 static struct class*  neural_class  = NULL;
 static struct device* neural_device = NULL;
-static DEFINE_MUTEX(neural_mutex);
+static struct lnp_drv_stats __percpu *neural_stats;
+static struct dentry *neural_debugfs;
+
+/*
+ * Anel compartilhado de amostras (neural_core.h). Página de controle e
+ * registros vêm de um único vmalloc_user() para que o mesmo buffer sirva
+ * read() e mmap().
+ */
+static struct neural_core neural_core;
+static void *neural_mem;
+
+// Produtor por hrtimer e fila de espera dos leitores bloqueados
+static struct hrtimer neural_timer;
+static ktime_t neural_period;
+static unsigned int neural_rate_hz;     /* 0 = sob demanda */
+static DEFINE_MUTEX(neural_rate_lock);  /* serializa mudanças de taxa */
+static DECLARE_WAIT_QUEUE_HEAD(neural_wq);
 
-static char neural_buffer[256] = "Neural driver ativo.\n";
+// Estado por open(): cada leitor anda no anel com seu próprio cursor
+struct neural_reader {
+    struct mutex lock;          /* serializa threads que compartilham o mesmo fd */
+    struct neural_cursor cur;
+    pid_t pid;
+    struct list_head node;
+};
+
+/* lista de leitores só para estatística; nunca tocada no caminho de leitura */
+static LIST_HEAD(neural_readers);
+static DEFINE_MUTEX(neural_readers_lock);
 
 // Protótipos
 static int     neural_open(struct inode*, struct file*);
+static int     neural_mmap(struct file*, struct vm_area_struct*);
 static int     neural_release(struct inode*, struct file*);
-static ssize_t neural_read(struct file*, char*, size_t, loff_t*);
-static ssize_t neural_write(struct file*, const char*, size_t, loff_t*);
+static ssize_t neural_read(struct file*, char __user*, size_t, loff_t*);
+static ssize_t neural_write(struct file*, const char __user*, size_t, loff_t*);
+static long    neural_ioctl(struct file*, unsigned int, unsigned long);
+static __poll_t neural_poll(struct file*, poll_table*);
 
 static struct file_operations fops = {
+    .owner = THIS_MODULE,
     .open = neural_open,
     .read = neural_read,
     .write = neural_write,
+    .unlocked_ioctl = neural_ioctl,
+    .mmap = neural_mmap,
+    .poll = neural_poll,
     .release = neural_release,
 };
 
+// Produz uma amostra simulada no anel compartilhado
+static void neural_produce(u64 ts_ns)
+{
+    s32 uv;
+    u64 seq = neural_core_produce(&neural_core, ts_ns, &uv);
+
+    this_cpu_inc(neural_stats->samples);
+    trace_neural_sample(seq, ts_ns, uv);
+}
+
+/*
+ * Disparo periódico: repõe os períodos perdidos (até NEURAL_MAX_CATCHUP)
+ * com o instante ideal de cada um, mantendo a taxa média exata.
+ */
+static enum hrtimer_restart neural_timer_fn(struct hrtimer *t)
+{
+    ktime_t expires = hrtimer_get_expires(t);
+    u64 periods = hrtimer_forward_now(t, neural_period);
+    u64 i;
+
+    if (periods > NEURAL_MAX_CATCHUP) {
+        expires = ktime_add_ns(expires, (periods - NEURAL_MAX_CATCHUP) * ktime_to_ns(neural_period));
+        periods = NEURAL_MAX_CATCHUP;
+    }
+    for (i = 0; i < periods; i++)
+        neural_produce(ktime_to_ns(expires) + i * ktime_to_ns(neural_period));
+
+    wake_up_interruptible(&neural_wq);
+    return HRTIMER_RESTART;
+}
+
+// Troca a taxa do produtor; 0 volta ao modo sob demanda
+static int neural_set_rate(unsigned int hz)
+{
+    if (hz > NEURAL_RATE_MAX_HZ)
+        return -EINVAL;
+
+    mutex_lock(&neural_rate_lock);
+    hrtimer_cancel(&neural_timer);
+    WRITE_ONCE(neural_rate_hz, hz);
+    if (hz) {
+        neural_period = ns_to_ktime(div_u64(NSEC_PER_SEC, hz));
+        hrtimer_start(&neural_timer, ktime_add(ktime_get(), neural_period), HRTIMER_MODE_ABS);
+    }
+    mutex_unlock(&neural_rate_lock);
+
+    /* leitores bloqueados reavaliam o modo */
+    wake_up_interruptible_all(&neural_wq);
+    printk(KERN_INFO "neural_driver: taxa do produtor = %u Hz%s\n", hz, hz ? "" : " (sob demanda)");
+    return 0;
+}
+
+// Atributo sysfs "readers": leitores abertos, entregas e perdas de cada um
+static ssize_t readers_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct neural_reader *r;
+    ssize_t n = 0;
+
+    n += scnprintf(buf + n, PAGE_SIZE - n, "pid cursor delivered dropped\n");
+    mutex_lock(&neural_readers_lock);
+    list_for_each_entry(r, &neural_readers, node) {
+        n += scnprintf(buf + n, PAGE_SIZE - n, "%d %llu %llu %llu\n",
+                       r->pid, READ_ONCE(r->cur.pos),
+                       READ_ONCE(r->cur.delivered), READ_ONCE(r->cur.dropped));
+    }
+    mutex_unlock(&neural_readers_lock);
+    return n;
+}
+static DEVICE_ATTR_RO(readers);
+
 // Inicialização
 static int __init neural_init(void) {
+    int ret;
+
     printk(KERN_INFO "neural_driver: inicializando...\n");
 
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 13, 0)
+    hrtimer_setup(&neural_timer, neural_timer_fn, CLOCK_MONOTONIC, HRTIMER_MODE_ABS);
+#else
+    hrtimer_init(&neural_timer, CLOCK_MONOTONIC, HRTIMER_MODE_ABS);
+    neural_timer.function = neural_timer_fn;
+#endif
+
+    /* o registro faz parte da ABI de mmap: tamanho não pode mudar */
+    BUILD_BUG_ON(sizeof(struct neural_sample) != 32);
+    BUILD_BUG_ON(!is_power_of_2(NEURAL_RING_SIZE));
+
+    neural_stats = alloc_percpu(struct lnp_drv_stats);
+    if (!neural_stats)
+        return -ENOMEM;
+
+    neural_mem = vmalloc_user(NEURAL_MMAP_BYTES);
+    if (!neural_mem) {
+        free_percpu(neural_stats);
+        return -ENOMEM;
+    }
+    neural_core_init(&neural_core, neural_mem, PAGE_SIZE);
+
     major_number = register_chrdev(0, DEVICE_NAME, &fops);
     if (major_number < 0) {
         printk(KERN_ALERT "neural_driver: falha ao registrar número de dispositivo\n");
+        vfree(neural_mem);
+        free_percpu(neural_stats);
         return major_number;
     }
 
     neural_class = class_create(THIS_MODULE, CLASS_NAME);
     if (IS_ERR(neural_class)) {
         unregister_chrdev(major_number, DEVICE_NAME);
+        vfree(neural_mem);
+        free_percpu(neural_stats);
         return PTR_ERR(neural_class);
     }
 
@@ -60,72 +230,284 @@ static int __init neural_init(void) {
     if (IS_ERR(neural_device)) {
         class_destroy(neural_class);
         unregister_chrdev(major_number, DEVICE_NAME);
+        vfree(neural_mem);
+        free_percpu(neural_stats);
         return PTR_ERR(neural_device);
     }
 
-    mutex_init(&neural_mutex);
+    ret = device_create_file(neural_device, &dev_attr_readers);
+    if (ret) {
+        device_destroy(neural_class, MKDEV(major_number, 0));
+        class_destroy(neural_class);
+        unregister_chrdev(major_number, DEVICE_NAME);
+        vfree(neural_mem);
+        free_percpu(neural_stats);
+        return ret;
+    }
+
+    neural_debugfs = lnp_stats_debugfs_create(DEVICE_NAME, neural_stats);
     printk(KERN_INFO "neural_driver: módulo carregado! Major=%d\n", major_number);
     return 0;
 }
 
 static void __exit neural_exit(void) {
-    mutex_destroy(&neural_mutex);
+    hrtimer_cancel(&neural_timer);
+    device_remove_file(neural_device, &dev_attr_readers);
     device_destroy(neural_class, MKDEV(major_number, 0));
-    class_unregister(neural_class);
     class_destroy(neural_class);
     unregister_chrdev(major_number, DEVICE_NAME);
+    debugfs_remove_recursive(neural_debugfs);
+    vfree(neural_mem);
+    free_percpu(neural_stats);
     printk(KERN_INFO "neural_driver: módulo removido.\n");
 }
 
 // Operações
 static int neural_open(struct inode *inodep, struct file *filep) {
-    if (!mutex_trylock(&neural_mutex)) {
-        printk(KERN_ALERT "neural_driver: dispositivo em uso\n");
-        return -EBUSY;
+    struct neural_reader *r = kzalloc(sizeof(*r), GFP_KERNEL);
+    if (!r)
+        return -ENOMEM;
+
+    mutex_init(&r->lock);
+    /* um leitor novo só vê amostras produzidas a partir de agora */
+    r->cur.pos = atomic64_read_acquire(&neural_core.head);
+    r->pid = task_tgid_nr(current);
+    filep->private_data = r;
+
+    mutex_lock(&neural_readers_lock);
+    list_add_tail(&r->node, &neural_readers);
+    mutex_unlock(&neural_readers_lock);
+
+    trace_neural_open(r->pid);
+    return 0;
+}
+
+static bool neural_reader_ready(struct neural_reader *r) {
+    return neural_core_pending(&neural_core, &r->cur) || !READ_ONCE(neural_rate_hz);
+}
+
+/*
+ * Leitor em dia com o produtor: no modo sob demanda produz uma amostra
+ * nova na fonte compartilhada; com o produtor por hrtimer, bloqueia até a
+ * próxima (ou -EAGAIN com O_NONBLOCK). Chamada com r->lock tomado.
+ */
+static int neural_wait_data(struct file *filep, struct neural_reader *r) {
+    if (!READ_ONCE(neural_rate_hz)) {
+        neural_produce(ktime_get_ns());
+        return 0;
+    }
+    if (filep->f_flags & O_NONBLOCK) {
+        this_cpu_inc(neural_stats->busy);
+        return -EAGAIN;
     }
-    printk(KERN_INFO "neural_driver: dispositivo aberto\n");
+    if (wait_event_interruptible(neural_wq, neural_reader_ready(r)))
+        return -ERESTARTSYS;
     return 0;
 }
 
-static ssize_t neural_read(struct file *filep, char *buffer, size_t len, loff_t *offset) {
-    int noise;
-    get_random_bytes(&noise, sizeof(noise));
-    snprintf(neural_buffer, sizeof(neural_buffer),
-             "[neural_driver] Atividade cerebral detectada: %d µV\n",
-             (noise % 200) - 100);
+// Entrega ao leitor tantas linhas do seu atraso quantas couberem em len
+static ssize_t neural_read(struct file *filep, char __user *buffer, size_t len, loff_t *offset) {
+    struct neural_reader *r = filep->private_data;
+    ssize_t ret;
+    u64 t0 = ktime_get_ns();
 
-    if (copy_to_user(buffer, neural_buffer, strlen(neural_buffer)) == 0) {
-        printk(KERN_INFO "neural_driver: leitura enviada ao user-space\n");
-        return strlen(neural_buffer);
-    } else {
-        printk(KERN_WARNING "neural_driver: falha ao enviar dados\n");
-        return -EFAULT;
+    if (mutex_lock_interruptible(&r->lock))
+        return -ERESTARTSYS;
+
+    for (;;) {
+        ret = neural_core_read_text(&neural_core, &r->cur, buffer, len);
+        if (ret != -EAGAIN)
+            break;
+        ret = neural_wait_data(filep, r);
+        if (ret)
+            break;
     }
+
+    trace_neural_read(r->pid, r->cur.pos, ret > 0 ? ret : 0, ret > 0 ? 0 : ret);
+    mutex_unlock(&r->lock);
+
+    if (ret == -EFAULT)
+        this_cpu_inc(neural_stats->copy_failures);
+    if (ret > 0)
+        this_cpu_add(neural_stats->bytes, ret);
+    lnp_stats_read_latency(neural_stats, ktime_get_ns() - t0);
+    return ret;
+}
+
+static __poll_t neural_poll(struct file *filep, poll_table *wait) {
+    struct neural_reader *r = filep->private_data;
+
+    poll_wait(filep, &neural_wq, wait);
+    if (neural_reader_ready(r))
+        return EPOLLIN | EPOLLRDNORM;
+    return 0;
 }
 
-static ssize_t neural_write(struct file *filep, const char *buffer, size_t len, loff_t *offset) {
+/* Comandos de texto: "rate=N" ajusta o produtor (Hz, 0 = sob demanda) */
+static ssize_t neural_write(struct file *filep, const char __user *buffer, size_t len, loff_t *offset) {
     char input[64];
+    unsigned int hz;
+    int ret;
     size_t copy_len = min(len, sizeof(input) - 1);
-    if (copy_from_user(input, buffer, copy_len))
+    if (copy_from_user(input, buffer, copy_len)) {
+        this_cpu_inc(neural_stats->copy_failures);
         return -EFAULT;
+    }
     input[copy_len] = '\0';
 
-    printk(KERN_INFO "neural_driver: comando recebido: %s\n", input);
-    snprintf(neural_buffer, sizeof(neural_buffer),
-             "[neural_driver] Comando neural processado: %s\n", input);
+    trace_neural_command(input);
+    if (sscanf(input, "rate=%u", &hz) == 1) {
+        ret = neural_set_rate(hz);
+        if (ret)
+            return ret;
+    }
     return len;
 }
 
+/*
+ * Mapeia página de controle + anel, somente leitura. O módulo não pode
+ * sair enquanto houver mapeamentos: o fd aberto segura a referência.
+ */
+static int neural_mmap(struct file *filep, struct vm_area_struct *vma) {
+    unsigned long size = vma->vm_end - vma->vm_start;
+
+    if (vma->vm_flags & VM_WRITE)
+        return -EPERM;
+    if ((vma->vm_pgoff << PAGE_SHIFT) + size > NEURAL_MMAP_BYTES)
+        return -EINVAL;
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 3, 0)
+    vm_flags_clear(vma, VM_MAYWRITE);
+#else
+    vma->vm_flags &= ~VM_MAYWRITE;
+#endif
+    return remap_vmalloc_range(vma, neural_mem, vma->vm_pgoff);
+}
+
+/*
+ * NEURAL_IOC_READ_BATCH: copia até b->max registros binários de uma vez,
+ * em blocos de NEURAL_BATCH_CHUNK para amortizar o custo de copy_to_user.
+ */
+static long neural_read_batch(struct file *filep, struct neural_reader *r, struct neural_batch __user *ub) {
+    struct neural_sample chunk[NEURAL_BATCH_CHUNK];
+    struct neural_sample __user *dst;
+    struct neural_batch b;
+    u32 n = 0, fill;
+    long ret = 0;
+    u64 t0 = ktime_get_ns(), dropped_first = 0;
+
+    if (copy_from_user(&b, ub, sizeof(b)))
+        return -EFAULT;
+    if (b.max == 0 || b.max > NEURAL_BATCH_MAX)
+        return -EINVAL;
+    dst = u64_to_user_ptr(b.samples);
+
+    if (mutex_lock_interruptible(&r->lock))
+        return -ERESTARTSYS;
+
+    while (n < b.max) {
+        fill = 0;
+        while (fill < NEURAL_BATCH_CHUNK && n + fill < b.max) {
+            if (neural_core_fetch(&neural_core, &r->cur, &chunk[fill]))
+                break;
+            if (fill++ == 0)
+                dropped_first = r->cur.dropped;
+        }
+        if (fill == 0) {
+            if (n)
+                break;
+            ret = neural_wait_data(filep, r);
+            if (ret)
+                break;
+            continue;
+        }
+        if (copy_to_user(dst + n, chunk, fill * sizeof(chunk[0]))) {
+            this_cpu_inc(neural_stats->copy_failures);
+            /*
+             * volta para a primeira amostra do bloco: o fetch pode ter
+             * pulado posições (volta do produtor) dentro dele, e elas não
+             * contam como perdidas até serem relidas
+             */
+            r->cur.pos = chunk[0].seq;
+            r->cur.dropped = dropped_first;
+            ret = -EFAULT;
+            break;
+        }
+        n += fill;
+        r->cur.delivered += fill;
+    }
+
+    b.count = n;
+    b.dropped = r->cur.dropped;
+    trace_neural_read(r->pid, r->cur.pos, (size_t)n * sizeof(struct neural_sample), ret);
+    mutex_unlock(&r->lock);
+
+    this_cpu_add(neural_stats->bytes, (u64)n * sizeof(struct neural_sample));
+    lnp_stats_read_latency(neural_stats, ktime_get_ns() - t0);
+
+    if (n == 0 && ret)
+        return ret;
+    if (copy_to_user(ub, &b, sizeof(b)))
+        return -EFAULT;
+    return 0;
+}
+
+static long neural_ioctl(struct file *filep, unsigned int cmd, unsigned long arg) {
+    struct neural_reader *r = filep->private_data;
+    struct neural_reader_stats st;
+    u32 count;
+
+    switch (cmd) {
+    case NEURAL_IOC_READER_STATS:
+        mutex_lock(&r->lock);
+        st.delivered = r->cur.delivered;
+        st.dropped = r->cur.dropped;
+        st.cursor = r->cur.pos;
+        mutex_unlock(&r->lock);
+        st.head = atomic64_read_acquire(&neural_core.head);
+        if (copy_to_user((void __user *)arg, &st, sizeof(st)))
+            return -EFAULT;
+        return 0;
+    case NEURAL_IOC_GENERATE:
+        if (get_user(count, (u32 __user *)arg))
+            return -EFAULT;
+        if (count == 0 || count > NEURAL_RING_SIZE)
+            return -EINVAL;
+        while (count--)
+            neural_produce(ktime_get_ns());
+        wake_up_interruptible(&neural_wq);
+        return 0;
+    case NEURAL_IOC_SET_RATE:
+        if (get_user(count, (u32 __user *)arg))
+            return -EFAULT;
+        return neural_set_rate(count);
+    case NEURAL_IOC_GET_RATE:
+        return put_user(READ_ONCE(neural_rate_hz), (u32 __user *)arg);
+    case NEURAL_IOC_READ_BATCH:
+        return neural_read_batch(filep, r, (struct neural_batch __user *)arg);
+    default:
+        return -ENOTTY;
+    }
+}
+
 static int neural_release(struct inode *inodep, struct file *filep) {
-    mutex_unlock(&neural_mutex);
-    printk(KERN_INFO "neural_driver: dispositivo fechado\n");
+    struct neural_reader *r = filep->private_data;
+
+    mutex_lock(&neural_readers_lock);
+    list_del(&r->node);
+    mutex_unlock(&neural_readers_lock);
+
+    trace_neural_release(r->pid, r->cur.delivered, r->cur.dropped);
+    mutex_destroy(&r->lock);
+    kfree(r);
     return 0;
 }
 
-MODULE_LICENSE("Apache-2.0");
+/* hrtimer, debugfs, alloc_percpu e tracepoints só funcionam em módulos GPL */
+MODULE_LICENSE("Dual MIT/GPL");
 MODULE_AUTHOR("Linus Neural Project");
 MODULE_DESCRIPTION("Driver experimental de interface neural com sinais simulados");
-MODULE_VERSION("0.2");
+MODULE_VERSION("0.3");
 
 module_init(neural_init);
 module_exit(neural_exit);
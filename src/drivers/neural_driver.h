@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-2.0 OR MIT
+/*
+ * neural_driver.h - Interface de usuário do /dev/neural
+ *
+ * Definições compartilhadas entre o módulo neural_driver e os programas
+ * em user-space: registro binário de amostra, página de controle do anel
+ * mapeável via mmap(), ioctls e estruturas de estatística.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef LNP_NEURAL_DRIVER_H
+#define LNP_NEURAL_DRIVER_H
+
+#include <linux/types.h>
+#include <linux/ioctl.h>
+
+#define NEURAL_IOC_MAGIC 'N'
+#define NEURAL_ABI_VERSION 1
+
+/* Registro binário de amostra (tamanho fixo, estável entre versões da ABI) */
+struct neural_sample {
+    __u64 seq;          /* sequência global; ~0 enquanto o slot é reescrito */
+    __s64 ts_ns;        /* instante da amostra, CLOCK_MONOTONIC */
+    __s32 uv;           /* atividade simulada em µV */
+    __u32 flags;
+    __u64 reserved;
+};
+
+#define NEURAL_SEQ_BUSY (~0ULL)
+
+/*
+ * Layout do mmap() de /dev/neural (somente leitura):
+ *   offset 0            struct neural_ring_ctrl (uma página)
+ *   offset data_offset  ring_size registros struct neural_sample
+ *
+ * O kernel grava o slot head % ring_size e só então publica head + 1.
+ * Cada consumidor guarda o próprio cursor:
+ *
+ *   head = __atomic_load_n(&ctrl->head, __ATOMIC_ACQUIRE);
+ *   if (head - cursor > ctrl->ring_size)   // perdeu amostras
+ *       cursor = head - ctrl->ring_size;
+ *   while (cursor < head) {
+ *       s = ring[cursor & (ctrl->ring_size - 1)];   // cópia
+ *       __atomic_thread_fence(__ATOMIC_ACQUIRE);
+ *       if (s.seq == cursor && ring[...].seq == cursor) usa(s);
+ *       cursor++;
+ *   }
+ *
+ * Um seq diferente do cursor significa que o produtor deu a volta no anel
+ * durante a cópia; o registro deve ser descartado.
+ */
+struct neural_ring_ctrl {
+    __u32 version;      /* NEURAL_ABI_VERSION */
+    __u32 record_size;  /* sizeof(struct neural_sample) */
+    __u32 ring_size;    /* número de registros, potência de 2 */
+    __u32 data_offset;  /* início do anel no mapeamento, em bytes */
+    __u64 head;         /* próxima sequência a gravar */
+    __u64 tail;         /* sequência mais antiga ainda presente no anel */
+};
+
+/* Estatísticas de um leitor (um open() de /dev/neural) */
+struct neural_reader_stats {
+    __u64 delivered;    /* amostras entregues a este leitor */
+    __u64 dropped;      /* amostras sobrescritas antes de serem lidas */
+    __u64 cursor;       /* próxima sequência que este leitor vai ler */
+    __u64 head;         /* próxima sequência que o produtor vai gravar */
+};
+
+#define NEURAL_IOC_READER_STATS _IOR(NEURAL_IOC_MAGIC, 1, struct neural_reader_stats)
+/* Produz N amostras de uma vez (útil para consumidores via mmap) */
+#define NEURAL_IOC_GENERATE     _IOW(NEURAL_IOC_MAGIC, 2, __u32)
+/* Taxa do produtor por hrtimer em Hz; 0 = amostras sob demanda na leitura */
+#define NEURAL_IOC_SET_RATE     _IOW(NEURAL_IOC_MAGIC, 3, __u32)
+#define NEURAL_IOC_GET_RATE     _IOR(NEURAL_IOC_MAGIC, 4, __u32)
+
+#define NEURAL_RATE_MAX_HZ      100000
+
+/*
+ * Leitura em lote: até max registros struct neural_sample a partir do
+ * cursor deste open(), com timestamp CLOCK_MONOTONIC e sequência global,
+ * de modo que lacunas aparecem como saltos em seq. Bloqueia como read()
+ * enquanto não houver amostras (exceto com O_NONBLOCK).
+ */
+struct neural_batch {
+    __u64 samples;      /* entrada: ponteiro user para struct neural_sample[max] */
+    __u32 max;          /* entrada: capacidade do vetor (até NEURAL_BATCH_MAX) */
+    __u32 count;        /* saída: registros copiados */
+    __u64 dropped;      /* saída: total de perdas deste leitor até agora */
+};
+
+#define NEURAL_BATCH_MAX        4096
+#define NEURAL_IOC_READ_BATCH   _IOWR(NEURAL_IOC_MAGIC, 5, struct neural_batch)
+
+#endif /* LNP_NEURAL_DRIVER_H */
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-2.0 OR MIT
+/*
+ * neural_trace.h - Tracepoints do neural_driver
+ *
+ * Substituem o printk por operação: custo zero quando desligados.
+ *   echo 1 > /sys/kernel/tracing/events/neural/enable
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM neural
+
+#if !defined(_NEURAL_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _NEURAL_TRACE_H
+
+#include <linux/tracepoint.h>
+
+TRACE_EVENT(neural_open,
+    TP_PROTO(pid_t pid),
+    TP_ARGS(pid),
+    TP_STRUCT__entry(
+        __field(pid_t, pid)
+    ),
+    TP_fast_assign(
+        __entry->pid = pid;
+    ),
+    TP_printk("pid=%d", __entry->pid)
+);
+
+TRACE_EVENT(neural_release,
+    TP_PROTO(pid_t pid, u64 delivered, u64 dropped),
+    TP_ARGS(pid, delivered, dropped),
+    TP_STRUCT__entry(
+        __field(pid_t, pid)
+        __field(u64, delivered)
+        __field(u64, dropped)
+    ),
+    TP_fast_assign(
+        __entry->pid = pid;
+        __entry->delivered = delivered;
+        __entry->dropped = dropped;
+    ),
+    TP_printk("pid=%d delivered=%llu dropped=%llu",
+              __entry->pid, __entry->delivered, __entry->dropped)
+);
+
+TRACE_EVENT(neural_read,
+    TP_PROTO(pid_t pid, u64 cursor, size_t bytes, long ret),
+    TP_ARGS(pid, cursor, bytes, ret),
+    TP_STRUCT__entry(
+        __field(pid_t, pid)
+        __field(u64, cursor)
+        __field(size_t, bytes)
+        __field(long, ret)
+    ),
+    TP_fast_assign(
+        __entry->pid = pid;
+        __entry->cursor = cursor;
+        __entry->bytes = bytes;
+        __entry->ret = ret;
+    ),
+    TP_printk("pid=%d cursor=%llu bytes=%zu ret=%ld",
+              __entry->pid, __entry->cursor, __entry->bytes, __entry->ret)
+);
+
+TRACE_EVENT(neural_sample,
+    TP_PROTO(u64 seq, s64 ts_ns, s32 uv),
+    TP_ARGS(seq, ts_ns, uv),
+    TP_STRUCT__entry(
+        __field(u64, seq)
+        __field(s64, ts_ns)
+        __field(s32, uv)
+    ),
+    TP_fast_assign(
+        __entry->seq = seq;
+        __entry->ts_ns = ts_ns;
+        __entry->uv = uv;
+    ),
+    TP_printk("seq=%llu ts=%lld uv=%d", __entry->seq, __entry->ts_ns, __entry->uv)
+);
+
+TRACE_EVENT(neural_command,
+    TP_PROTO(const char *cmd),
+    TP_ARGS(cmd),
+    TP_STRUCT__entry(
+        __array(char, cmd, 64)
+    ),
+    TP_fast_assign(
+        strscpy(__entry->cmd, cmd, sizeof(__entry->cmd));
+    ),
+    TP_printk("cmd=%s", __entry->cmd)
+);
+
+#endif /* _NEURAL_TRACE_H */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE neural_trace
+#include <trace/define_trace.h>
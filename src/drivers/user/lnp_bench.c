@@ -0,0 +1,442 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_bench.c - Benchmarks for the driver cores without loading modules
+ *
+ * Runs neural_read, the batch read, eyes_read, generate_sample, the eyes
+ * filter stages, the ln_touch_event frame and replay logic and, for
+ * each ISA the CPU has, the dispatched SIMD kernels from liblnpdrv.a.
+ * Results go to stdout as NDJSON in the same format as
+ * `TestingSystem --bench`, and as a table on stderr:
+ *   ./lnp_bench [-n ITER] [-t READERS] > run.ndjson
+ *
+ * Before timing anything the cores are checked for the invariants the
+ * drivers rely on (contiguous seq, drop accounting on overrun, -EINVAL
+ * for short buffers, fixation start/end on a synthetic gaze trace, every
+ * SIMD entry equal to the scalar one); a failure aborts with exit code 1.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lnp_user.h"
+
+#define RING_SIZE 4096          /* NEURAL_RING_SIZE */
+#define EV_FIX_START 1          /* EYES_EV_* */
+#define EV_FIX_END   2
+#define EV_BLINK     3
+#define BATCH     256
+
+static long iterations = 1000000;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void bench_record(const char *name, int threads, double value, const char *unit) {
+    printf("{\"bench\":\"%s\",\"threads\":%d,\"value\":%.3f,\"unit\":\"%s\",\"better\":\"lower\"}\n",
+           name, threads, value, unit);
+    fflush(stdout);
+    fprintf(stderr, "  %-16s x%-3d %12.3f %s\n", name, threads, value, unit);
+}
+
+#define CHECK(cond, msg) do { if (!(cond)) { fprintf(stderr, "check failed: %s\n", msg); return 1; } } while (0)
+
+/* Fixation at (500,500) for 300 ms, saccade to (1500,900), blink: 100 Hz trace */
+static int check_eyes_filter(void) {
+    struct lnp_eyes_filter *f = lnp_eyes_filter_create();
+    struct lnp_eyes_out out[2];
+    int i, k, got, start = -1, end = -1, blink = -1;
+
+    CHECK(f, "lnp_eyes_filter_create");
+    CHECK(lnp_eyes_filter_command(f, "output=events") == 0, "output=events");
+    CHECK(lnp_eyes_filter_command(f, "fixation=200") == 0, "fixation=");
+    CHECK(lnp_eyes_filter_command(f, "smooth=bogus") == -EINVAL, "bad value");
+    CHECK(lnp_eyes_filter_command(f, "blink=1") == -ENOENT, "not a filter command");
+
+    for (i = 0; i < 40; i++) {
+        int x = i < 30 ? 500 : 1500, y = i < 30 ? 500 : 900;
+        got = lnp_eyes_filter_feed(f, x, y, i == 35, i * 10000000LL, out);
+        for (k = 0; k < got; k++) {
+            if (out[k].event == EV_FIX_START && start < 0)
+                start = i;
+            if (out[k].event == EV_FIX_END) {
+                end = i;
+                CHECK(out[k].x == 500 && out[k].y == 500 && out[k].ts_ns == 290000000LL, "fixation centroid/end time");
+            }
+            if (out[k].event == EV_BLINK)
+                blink = i;
+        }
+    }
+    CHECK(start == 10 && end == 30 && blink == 35, "fixation start/end and blink events");
+    lnp_eyes_filter_destroy(f);
+    return 0;
+}
+
+/*
+ * 10 s synthetic trace at 240 Hz: validation, frame times, end of trace and
+ * looping. Touches spawn about 3 times per second, so only frames with a
+ * contact down or lifting are in the trace; 10 s keeps at least a second
+ * of them. The seed is fixed so every run checks the same trace.
+ */
+static int check_touch_replay(void) {
+    struct lnp_touch *t = lnp_touch_create();
+    struct lnp_touch_point pt[LNP_TOUCH_MAX_CONTACTS];
+    size_t size;
+    unsigned char *trace = lnp_touch_trace_synth(10, 240, LNP_TOUCH_MAX_CONTACTS, 0x2025, &size);
+    long long t_us, prev = -1;
+    int frames = 0, looped = 0;
+
+    CHECK(t && trace, "lnp_touch_trace_synth");
+    CHECK(lnp_touch_replay_load(t, trace, size - 1) == -EINVAL, "truncated trace");
+    trace[0] ^= 1;
+    CHECK(lnp_touch_replay_load(t, trace, size) == -EINVAL, "bad magic");
+    trace[0] ^= 1;
+    CHECK(lnp_touch_replay_load(t, trace, size) == 0, "valid trace");
+
+    while (lnp_touch_replay_step(t, false, pt, &t_us) >= 0) {
+        CHECK(t_us > prev && t_us < 10000000 && (t_us * 240 + 999999) / 1000000 * 1000000 / 240 == t_us,
+              "frame times on the 240 Hz grid");
+        prev = t_us;
+        frames++;
+    }
+    CHECK(frames > 240, "frames replayed");
+
+    CHECK(lnp_touch_replay_load(t, trace, size) == 0, "reload");
+    while (frames-- > 0)
+        lnp_touch_replay_step(t, true, pt, &t_us);
+    for (prev = t_us; lnp_touch_replay_step(t, true, pt, &t_us) >= 0 && !looped; prev = t_us)
+        looped = t_us >= 10000000;
+    CHECK(looped && t_us > prev, "loop continues the timeline");
+
+    free(trace);
+    lnp_touch_destroy(t);
+    return 0;
+}
+
+/* 60 s at 480 Hz with every slot allowed: contacts stay on the panel */
+static int check_touch(void) {
+    struct lnp_touch *t = lnp_touch_create();
+    struct lnp_touch_point pt[LNP_TOUCH_MAX_CONTACTS];
+    int i, k, got, peak = 0;
+
+    CHECK(t, "lnp_touch_create");
+    for (i = 0; i < 60 * 480; i++) {
+        got = lnp_touch_step(t, 480, i < 30 * 480 ? LNP_TOUCH_MAX_CONTACTS : 2, pt);
+        if (got > peak)
+            peak = got;
+        for (k = 0; k < got; k++)
+            CHECK(pt[k].x >= 0 && pt[k].x <= 1080 && pt[k].y >= 0 && pt[k].y <= 2400 &&
+                  pt[k].pressure >= 10 && pt[k].pressure <= 100, "contact out of range");
+    }
+    CHECK(peak > 1 && got <= 2, "multiple contacts, then max_contacts respected");
+    lnp_touch_destroy(t);
+    return check_touch_replay();
+}
+
+#define DOT_MAX 300000          /* 300000 * 128 * 128 wraps int32: checks the modulo 2^32 sum */
+#define DOT_BENCH_N 4096
+
+static struct lnp_cpu_info cpu;
+static int8_t dot_a[DOT_MAX], dot_b[DOT_MAX];
+
+/* Every dispatched entry the CPU can run against the scalar one, at odd lengths */
+static int check_simd(void) {
+    static const size_t lens[] = { 0, 1, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 1000, 4099 };
+    lnp_dot_s8_fn ref = lnp_dot_s8_select(0, NULL), fn;
+    enum lnp_isa isa, got;
+    size_t i, k;
+
+    CHECK(lnp_dot_s8_select(cpu.isa, &got) && got == lnp_isa_best(cpu.isa),
+          "dispatch picks the best detected ISA");
+    for (isa = LNP_ISA_SCALAR; isa < LNP_ISA_COUNT; isa++) {
+        if (!(cpu.isa & LNP_ISA_BIT(isa)))
+            continue;
+        fn = lnp_dot_s8_select(lnp_isa_upto(cpu.isa, isa), &got);
+        CHECK(got == isa, "an entry per detected ISA");
+        for (i = 0; i < DOT_MAX; i++) {
+            dot_a[i] = (int8_t)(i * 7919 + 13);
+            dot_b[i] = (int8_t)(i * 104729 + 7);
+        }
+        for (k = 0; k < sizeof(lens) / sizeof(lens[0]); k++)
+            for (i = 0; i < 3; i++)     /* misaligned starts */
+                CHECK(fn(dot_a + i, dot_b + i, lens[k]) == ref(dot_a + i, dot_b + i, lens[k]),
+                      "dot_s8 matches scalar");
+        memset(dot_a, -128, sizeof(dot_a));
+        memset(dot_b, -128, sizeof(dot_b));
+        CHECK(fn(dot_a, dot_b, DOT_MAX) == ref(dot_a, dot_b, DOT_MAX), "dot_s8 wraps as scalar");
+    }
+    return 0;
+}
+
+static int check_cores(void) {
+    struct lnp_neural *n = lnp_neural_create();
+    struct lnp_neural_reader *r;
+    struct neural_sample s[BATCH];
+    struct neural_reader_stats st;
+    char buf[256];
+    ssize_t got;
+    int i, cnt;
+
+    CHECK(n, "lnp_neural_create");
+    CHECK(lnp_neural_ctrl(n)->record_size == sizeof(struct neural_sample), "ctrl record_size");
+    lnp_neural_generate(n, 10);
+    r = lnp_neural_open(n);
+    CHECK(r, "lnp_neural_open");
+    CHECK(lnp_neural_read_batch(r, s, BATCH) == 0, "new reader must start at head");
+    lnp_neural_generate(n, 10);
+    cnt = lnp_neural_read_batch(r, s, BATCH);
+    CHECK(cnt == 10, "batch count");
+    for (i = 0; i < cnt; i++)
+        CHECK(s[i].seq == (unsigned long long)(10 + i) && s[i].uv >= -100 && s[i].uv < 100, "seq/uv");
+
+    lnp_neural_generate(n, RING_SIZE + 100);
+    cnt = lnp_neural_read_batch(r, s, 1);
+    lnp_neural_reader_stats(r, &st);
+    CHECK(cnt == 1 && st.dropped == 100 && s[0].seq == 120, "drop accounting on overrun");
+    CHECK(lnp_neural_ctrl(n)->head == st.head, "ctrl head mirror");
+
+    got = lnp_neural_read(r, buf, 4);
+    CHECK(got == -EINVAL, "short text buffer");
+    got = lnp_neural_read(r, buf, sizeof(buf));
+    CHECK(got > 0 && buf[got - 1] == '\n', "text line");
+
+    got = lnp_eyes_read(buf, sizeof(buf), true);
+    CHECK(got > 0 && buf[got - 1] == '\n', "eyes line");
+    CHECK(lnp_eyes_read(buf, 4, true) == -EINVAL, "eyes short buffer");
+
+    lnp_neural_close(r);
+    lnp_neural_destroy(n);
+    return check_eyes_filter() || check_touch() || check_simd();
+}
+
+/* Filter cost per input sample on a 1 kHz trace of dwell-then-jump gaze */
+static void bench_filter(const char *name, const char *smooth, const char *output) {
+    struct lnp_eyes_filter *f = lnp_eyes_filter_create();
+    struct lnp_eyes_out out[2];
+    long i, emitted = 0;
+    int x = 960, y = 540;
+    double t0;
+
+    lnp_eyes_filter_command(f, smooth);
+    lnp_eyes_filter_command(f, output);
+    t0 = now_ns();
+    for (i = 0; i < iterations; i++) {
+        if (i % 300 == 0) {     /* saccade every 300 ms */
+            x = (int)(i * 7919 % 1921);
+            y = (int)(i * 104729 % 1081);
+        }
+        emitted += lnp_eyes_filter_feed(f, x + (int)(i & 3), y + (int)((i >> 2) & 3),
+                                        i % 4000 == 0, i * 1000000LL, out);
+    }
+    bench_record(name, 1, (now_ns() - t0) / iterations, "ns");
+    fprintf(stderr, "  %-16s      %ld in, %ld out\n", "", iterations, emitted);
+    lnp_eyes_filter_destroy(f);
+}
+
+static void bench_single(void) {
+    struct lnp_neural *n = lnp_neural_create();
+    struct lnp_neural_reader *r = lnp_neural_open(n);
+    struct neural_sample s[BATCH];
+    struct neural_reader_stats st;
+    char buf[4096];
+    unsigned long long target;
+    long i, recs = 0;
+    struct lnp_touch *t;
+    struct lnp_touch_point pt[LNP_TOUCH_MAX_CONTACTS];
+    void *trace;
+    size_t trace_size;
+    long long t_us;
+    double t0;
+
+    t0 = now_ns();
+    lnp_neural_generate(n, iterations);
+    bench_record("neural.produce", 1, (now_ns() - t0) / iterations, "ns");
+    lnp_neural_close(r);
+
+    /* on-demand: every read() produces and formats one line */
+    r = lnp_neural_open(n);
+    t0 = now_ns();
+    for (i = 0; i < iterations; i++)
+        lnp_neural_read(r, buf, 128);
+    bench_record("neural.read", 1, (now_ns() - t0) / iterations, "ns");
+
+    /* backlog drained with 4 KiB reads: per-line cost of the text path */
+    lnp_neural_close(r);
+    r = lnp_neural_open(n);
+    t0 = 0;
+    for (i = 0; i < iterations; i += RING_SIZE) {
+        lnp_neural_generate(n, RING_SIZE);
+        lnp_neural_reader_stats(r, &st);
+        target = st.head;
+        double t1 = now_ns();
+        do {
+            lnp_neural_read(r, buf, sizeof(buf));
+            lnp_neural_reader_stats(r, &st);
+        } while (st.cursor < target);
+        t0 += now_ns() - t1;
+    }
+    bench_record("neural.read_4k", 1, st.delivered ? t0 / st.delivered : 0, "ns/line");
+    lnp_neural_close(r);
+
+    r = lnp_neural_open(n);
+    t0 = 0;
+    for (i = 0; i < iterations; i += RING_SIZE) {
+        lnp_neural_generate(n, RING_SIZE);
+        double t1 = now_ns();
+        int got;
+        while ((got = lnp_neural_read_batch(r, s, BATCH)) > 0)
+            recs += got;
+        t0 += now_ns() - t1;
+    }
+    bench_record("neural.batch", 1, recs ? t0 / recs : 0, "ns/rec");
+    lnp_neural_close(r);
+    lnp_neural_destroy(n);
+
+    t0 = now_ns();
+    for (i = 0; i < iterations; i++)
+        lnp_eyes_read(buf, sizeof(buf), true);
+    bench_record("eyes.read", 1, (now_ns() - t0) / iterations, "ns");
+
+    bench_filter("eyes.filter_avg", "smooth=avg", "output=samples");
+    bench_filter("eyes.filter_euro", "smooth=euro", "output=samples");
+    bench_filter("eyes.filter_ev", "smooth=euro", "output=events");
+
+    t = lnp_touch_create();
+    t0 = now_ns();
+    for (i = 0; i < iterations; i++)
+        lnp_touch_step(t, 480, LNP_TOUCH_MAX_CONTACTS, pt);
+    bench_record("touch.frame", 1, (now_ns() - t0) / iterations, "ns");
+
+    trace = lnp_touch_trace_synth(60, 480, LNP_TOUCH_MAX_CONTACTS, 0x2025, &trace_size);
+    lnp_touch_replay_load(t, trace, trace_size);
+    t0 = now_ns();
+    for (i = 0; i < iterations; i++)
+        lnp_touch_replay_step(t, true, pt, &t_us);
+    bench_record("touch.replay", 1, (now_ns() - t0) / iterations, "ns");
+    free(trace);
+    lnp_touch_destroy(t);
+}
+
+/* One entry per detected ISA, on a vector that stays in L1 */
+static void bench_simd(void) {
+    char name[32];
+    enum lnp_isa isa, got;
+    lnp_dot_s8_fn fn;
+    long i, calls = iterations / 64;
+    volatile int32_t sink = 0;
+    double t0;
+
+    for (isa = LNP_ISA_SCALAR; isa < LNP_ISA_COUNT; isa++) {
+        if (!(cpu.isa & LNP_ISA_BIT(isa)))
+            continue;
+        fn = lnp_dot_s8_select(lnp_isa_upto(cpu.isa, isa), &got);
+        t0 = now_ns();
+        for (i = 0; i < calls; i++)
+            sink += fn(dot_a + (i & 1), dot_b, DOT_BENCH_N);
+        snprintf(name, sizeof(name), "simd.dot_s8.%s", lnp_isa_name(isa));
+        bench_record(name, 1, (now_ns() - t0) / calls, "ns");
+    }
+    (void)sink;
+}
+
+struct fanout {
+    struct lnp_neural *n;
+    pthread_barrier_t start;
+    atomic_int done;
+    atomic_llong delivered;
+    atomic_llong dropped;
+};
+
+static void *fanout_reader(void *arg) {
+    struct fanout *f = arg;
+    struct lnp_neural_reader *r = lnp_neural_open(f->n);
+    struct neural_sample s[BATCH];
+    struct neural_reader_stats st;
+
+    pthread_barrier_wait(&f->start);
+    while (!atomic_load(&f->done))
+        lnp_neural_read_batch(r, s, BATCH);
+    while (lnp_neural_read_batch(r, s, BATCH) > 0)
+        ;
+    lnp_neural_reader_stats(r, &st);
+    atomic_fetch_add(&f->delivered, st.delivered);
+    atomic_fetch_add(&f->dropped, st.dropped);
+    lnp_neural_close(r);
+    return NULL;
+}
+
+/* One producer, N lock-free readers on the shared ring: producer cost per sample */
+static void bench_fanout(int readers) {
+    struct fanout f = { .n = lnp_neural_create() };
+    pthread_t tid[64];
+    double t0;
+    int i;
+
+    pthread_barrier_init(&f.start, NULL, readers + 1);
+    for (i = 0; i < readers; i++)
+        pthread_create(&tid[i], NULL, fanout_reader, &f);
+    pthread_barrier_wait(&f.start);
+    t0 = now_ns();
+    lnp_neural_generate(f.n, iterations);
+    t0 = now_ns() - t0;
+    atomic_store(&f.done, 1);
+    for (i = 0; i < readers; i++)
+        pthread_join(tid[i], NULL);
+
+    bench_record("neural.fanout", readers, t0 / iterations, "ns");
+    fprintf(stderr, "  %-16s      delivered %lld dropped %lld\n", "",
+            (long long)atomic_load(&f.delivered), (long long)atomic_load(&f.dropped));
+    pthread_barrier_destroy(&f.start);
+    lnp_neural_destroy(f.n);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n ITERATIONS] [-t READERS]\n"
+                    "       %s -c    self-checks only (make check)\n", prog, prog);
+}
+
+int main(int argc, char **argv) {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    int readers = ncpu > 1 ? (int)(ncpu - 1 < 8 ? ncpu - 1 : 8) : 1;
+    int opt, check_only = 0;
+
+    while ((opt = getopt(argc, argv, "cn:t:h")) != -1) {
+        switch (opt) {
+        case 'c': check_only = 1; break;
+        case 'n': iterations = atol(optarg); break;
+        case 't': readers = atoi(optarg); break;
+        default: usage(argv[0]); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (iterations < RING_SIZE || readers < 1 || readers > 64) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    lnp_cpu_detect(&cpu);
+    if (check_cores())
+        return 1;
+    if (check_only) {
+        fprintf(stderr, "lnp_bench: checks passed (dispatch %s)\n", lnp_isa_name(lnp_isa_best(cpu.isa)));
+        return 0;
+    }
+
+    fprintf(stderr, "lnp_bench: %ld iterations on %s (%uC/%uT, dispatch %s)\n", iterations,
+            cpu.model[0] ? cpu.model : cpu.vendor, cpu.cores, cpu.threads,
+            lnp_isa_name(lnp_isa_best(cpu.isa)));
+    bench_single();
+    bench_simd();
+    bench_fanout(readers);
+    return 0;
+}
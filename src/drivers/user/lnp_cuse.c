@@ -0,0 +1,224 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_cuse.c - CUSE stand-in for /dev/neural and /dev/eyes
+ *
+ * Serves the userspace build of the driver cores (liblnpdrv.a) as a real
+ * character device, so the apps, TestingSystem --devbench and strace can
+ * be pointed at it on hosts where the modules cannot be loaded:
+ *   sudo modprobe cuse
+ *   sudo ./lnp_cuse --dev=neural -f      # creates /dev/neural
+ *   sudo ./lnp_cuse --dev=eyes -f        # creates /dev/eyes
+ *
+ * Differences from the modules: /dev/neural only runs in on-demand mode
+ * ("rate=0"; other rates get EOPNOTSUPP), and ioctl and mmap are not
+ * served. Reads and text commands behave like the drivers.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#define FUSE_USE_VERSION 31
+
+#include <cuse_lowlevel.h>
+#include <fuse_opt.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lnp_user.h"
+
+#define LNP_CUSE_READ_MAX 65536
+
+static struct lnp_neural *neural;
+static atomic_int eyes_busy;            /* /dev/eyes allows a single open */
+static atomic_bool eyes_blink = true;
+
+static void neural_cuse_open(fuse_req_t req, struct fuse_file_info *fi)
+{
+    struct lnp_neural_reader *r = lnp_neural_open(neural);
+
+    if (!r) {
+        fuse_reply_err(req, ENOMEM);
+        return;
+    }
+    fi->fh = (uintptr_t)r;
+    fi->direct_io = 1;
+    fi->nonseekable = 1;
+    fuse_reply_open(req, fi);
+}
+
+static void neural_cuse_read(fuse_req_t req, size_t size, off_t off, struct fuse_file_info *fi)
+{
+    struct lnp_neural_reader *r = (struct lnp_neural_reader *)(uintptr_t)fi->fh;
+    char *buf;
+    ssize_t n;
+
+    (void)off;
+    if (size > LNP_CUSE_READ_MAX)
+        size = LNP_CUSE_READ_MAX;
+    buf = malloc(size ? size : 1);
+    if (!buf) {
+        fuse_reply_err(req, ENOMEM);
+        return;
+    }
+    n = lnp_neural_read(r, buf, size);
+    if (n < 0)
+        fuse_reply_err(req, (int)-n);
+    else
+        fuse_reply_buf(req, buf, n);
+    free(buf);
+}
+
+static void neural_cuse_write(fuse_req_t req, const char *buf, size_t size, off_t off,
+                              struct fuse_file_info *fi)
+{
+    char input[64];
+    size_t len = size < sizeof(input) - 1 ? size : sizeof(input) - 1;
+    unsigned int hz;
+
+    (void)off;
+    (void)fi;
+    memcpy(input, buf, len);
+    input[len] = '\0';
+    if (sscanf(input, "rate=%u", &hz) == 1 && hz != 0) {
+        fuse_reply_err(req, EOPNOTSUPP);
+        return;
+    }
+    fuse_reply_write(req, size);
+}
+
+static void neural_cuse_release(fuse_req_t req, struct fuse_file_info *fi)
+{
+    lnp_neural_close((struct lnp_neural_reader *)(uintptr_t)fi->fh);
+    fuse_reply_err(req, 0);
+}
+
+static void eyes_cuse_open(fuse_req_t req, struct fuse_file_info *fi)
+{
+    int expected = 0;
+
+    if (!atomic_compare_exchange_strong(&eyes_busy, &expected, 1)) {
+        fuse_reply_err(req, EBUSY);
+        return;
+    }
+    fi->direct_io = 1;
+    fi->nonseekable = 1;
+    fuse_reply_open(req, fi);
+}
+
+static void eyes_cuse_read(fuse_req_t req, size_t size, off_t off, struct fuse_file_info *fi)
+{
+    char buf[256];
+    ssize_t n;
+
+    (void)off;
+    (void)fi;
+    n = lnp_eyes_read(buf, size < sizeof(buf) ? size : sizeof(buf), atomic_load(&eyes_blink));
+    if (n < 0)
+        fuse_reply_err(req, (int)-n);
+    else
+        fuse_reply_buf(req, buf, n);
+}
+
+static void eyes_cuse_write(fuse_req_t req, const char *buf, size_t size, off_t off,
+                            struct fuse_file_info *fi)
+{
+    char input[64];
+    size_t len = size < sizeof(input) - 1 ? size : sizeof(input) - 1;
+    unsigned int v;
+
+    (void)off;
+    (void)fi;
+    memcpy(input, buf, len);
+    input[len] = '\0';
+    if (sscanf(input, "blink=%u", &v) == 1)
+        atomic_store(&eyes_blink, v != 0);
+    fuse_reply_write(req, size);
+}
+
+static void eyes_cuse_release(fuse_req_t req, struct fuse_file_info *fi)
+{
+    (void)fi;
+    atomic_store(&eyes_busy, 0);
+    fuse_reply_err(req, 0);
+}
+
+static const struct cuse_lowlevel_ops neural_ops = {
+    .open = neural_cuse_open,
+    .read = neural_cuse_read,
+    .write = neural_cuse_write,
+    .release = neural_cuse_release,
+};
+
+static const struct cuse_lowlevel_ops eyes_ops = {
+    .open = eyes_cuse_open,
+    .read = eyes_cuse_read,
+    .write = eyes_cuse_write,
+    .release = eyes_cuse_release,
+};
+
+struct lnp_cuse_param {
+    char *dev;
+    int is_help;
+};
+
+#define LNP_CUSE_OPT(t, p) { t, offsetof(struct lnp_cuse_param, p), 1 }
+
+static const struct fuse_opt lnp_cuse_opts[] = {
+    LNP_CUSE_OPT("--dev=%s", dev),
+    FUSE_OPT_KEY("-h", 0),
+    FUSE_OPT_KEY("--help", 0),
+    FUSE_OPT_END
+};
+
+static int lnp_cuse_process_arg(void *data, const char *arg, int key, struct fuse_args *outargs)
+{
+    struct lnp_cuse_param *param = data;
+
+    (void)arg;
+    if (key == 0) {
+        param->is_help = 1;
+        fprintf(stderr, "usage: lnp_cuse --dev=neural|eyes [-f] [-s] [-d]\n");
+        return fuse_opt_add_arg(outargs, "-ho");
+    }
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    struct fuse_args args = FUSE_ARGS_INIT(argc, argv);
+    struct lnp_cuse_param param = { 0 };
+    const struct cuse_lowlevel_ops *ops;
+    char dev_name[64];
+    const char *dev_info_argv[] = { dev_name };
+    struct cuse_info ci;
+    int ret;
+
+    if (fuse_opt_parse(&args, &param, lnp_cuse_opts, lnp_cuse_process_arg))
+        return 1;
+
+    if (!param.is_help) {
+        if (!param.dev || (strcmp(param.dev, "neural") && strcmp(param.dev, "eyes"))) {
+            fprintf(stderr, "lnp_cuse: --dev=neural or --dev=eyes is required\n");
+            return 1;
+        }
+        if (!strcmp(param.dev, "neural")) {
+            neural = lnp_neural_create();
+            if (!neural)
+                return 1;
+        }
+    }
+    ops = param.dev && !strcmp(param.dev, "eyes") ? &eyes_ops : &neural_ops;
+
+    snprintf(dev_name, sizeof(dev_name), "DEVNAME=%s", param.dev ? param.dev : "neural");
+    memset(&ci, 0, sizeof(ci));
+    ci.dev_info_argc = 1;
+    ci.dev_info_argv = dev_info_argv;
+
+    ret = cuse_lowlevel_main(args.argc, args.argv, &ci, ops, NULL);
+    lnp_neural_destroy(neural);
+    fuse_opt_free_args(&args);
+    return ret;
+}
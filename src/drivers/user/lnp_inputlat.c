@@ -0,0 +1,352 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_inputlat.c - Touch latency from frame generation to an evdev reader
+ *
+ * Reads the Linus Neural Touchscreen (BUS_VIRTUAL, vendor 0x2025) loaded
+ * with timestamp=1, which stamps each frame with MSC_TIMESTAMP at the
+ * start of ln_touch_event. Every frame is split into:
+ *   gen_sync   MSC_TIMESTAMP -> evdev event time (input_sync in the core)
+ *   sync_read  evdev event time -> read() returning in this process
+ *   total      MSC_TIMESTAMP -> read()
+ * all on CLOCK_MONOTONIC (EVIOCSCLOCKID), reported as percentiles.
+ *
+ *   sudo insmod touchscreen.ko timestamp=1 rate_hz=480
+ *   sudo ./lnp_inputlat -t 30 -l 4 -p fifo:50 > lat.ndjson
+ *
+ * Load threads spin over a private 1 MiB buffer to compete for the CPU
+ * and caches; -c/-C pin the reader and the load, -p/-P set their
+ * scheduling policy ("fifo:N", "rr:N", or "other:NICE"). Results go to
+ * stdout as NDJSON in the lnp_bench format, and as a table on stderr.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <linux/input.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LN_TOUCH_VENDOR  0x2025
+#define LN_TOUCH_PRODUCT 0x0001
+#define LOAD_BUF         (1 << 20)
+
+struct sched_opt {
+    int policy;
+    int prio;           /* rt priority, or nice for SCHED_OTHER */
+    int set;
+};
+
+struct lat {
+    uint32_t *ns;
+    size_t count, cap;
+};
+
+static atomic_int stop;
+
+static long long mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* Whole string as a decimal integer within [min, max]; -1 otherwise */
+static int parse_int(const char *arg, long min, long max, int *out) {
+    char *end;
+    long v;
+
+    errno = 0;
+    v = strtol(arg, &end, 10);
+    if (end == arg || *end || errno || v < min || v > max)
+        return -1;
+    *out = (int)v;
+    return 0;
+}
+
+/* A CPU that exists on this machine and fits in a cpu_set_t */
+static int parse_cpu(const char *arg, int *cpu) {
+    long n = sysconf(_SC_NPROCESSORS_CONF);
+
+    if (n < 1 || n > CPU_SETSIZE)
+        n = CPU_SETSIZE;
+    return parse_int(arg, 0, n - 1, cpu);
+}
+
+static int parse_sched(const char *arg, struct sched_opt *s) {
+    const char *colon = strchr(arg, ':');
+    size_t len = colon ? (size_t)(colon - arg) : strlen(arg);
+    long min, max;
+
+    if (!strncmp(arg, "fifo", len) && len == 4)
+        s->policy = SCHED_FIFO;
+    else if (!strncmp(arg, "rr", len) && len == 2)
+        s->policy = SCHED_RR;
+    else if (!strncmp(arg, "other", len) && len == 5)
+        s->policy = SCHED_OTHER;
+    else
+        return -1;
+    if (s->policy == SCHED_OTHER) {
+        min = -20;                      /* nice */
+        max = 19;
+    } else {
+        min = sched_get_priority_min(s->policy);
+        max = sched_get_priority_max(s->policy);
+    }
+    s->prio = 0;
+    if (colon && parse_int(colon + 1, min, max, &s->prio))
+        return -1;
+    if (!colon && s->policy != SCHED_OTHER)
+        s->prio = (int)min;
+    s->set = 1;
+    return 0;
+}
+
+/* Applies policy and CPU to the calling thread; reports but tolerates EPERM */
+static void apply_thread(const char *who, const struct sched_opt *s, int cpu) {
+    if (s->set) {
+        struct sched_param sp = { .sched_priority = s->policy == SCHED_OTHER ? 0 : s->prio };
+        int err = pthread_setschedparam(pthread_self(), s->policy, &sp);
+
+        if (!err && s->policy == SCHED_OTHER)
+            err = setpriority(PRIO_PROCESS, 0, s->prio) ? errno : 0;
+        if (err)
+            fprintf(stderr, "lnp_inputlat: %s scheduling: %s\n", who, strerror(err));
+    }
+    if (cpu >= 0) {
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+            fprintf(stderr, "lnp_inputlat: %s cannot run on CPU %d\n", who, cpu);
+    }
+}
+
+struct load_arg {
+    struct sched_opt sched;
+    int cpu;
+};
+
+static void *load_thread(void *p) {
+    const struct load_arg *a = p;
+    volatile unsigned char *buf = malloc(LOAD_BUF);
+    unsigned int i = 0;
+
+    apply_thread("load", &a->sched, a->cpu);
+    if (!buf)
+        return NULL;
+    while (!atomic_load_explicit(&stop, memory_order_relaxed)) {
+        buf[i] += (unsigned char)i;
+        i = (i + 64) & (LOAD_BUF - 1);
+    }
+    free((void *)buf);
+    return NULL;
+}
+
+/* First event device with the driver's id, unless one was given */
+static int open_device(const char *path, char *found, size_t len) {
+    struct input_id id;
+    struct dirent *de;
+    DIR *dir;
+    int fd;
+
+    if (path) {
+        snprintf(found, len, "%s", path);
+        return open(path, O_RDONLY);
+    }
+    dir = opendir("/dev/input");
+    if (!dir)
+        return -1;
+    while ((de = readdir(dir))) {
+        if (strncmp(de->d_name, "event", 5))
+            continue;
+        snprintf(found, len, "/dev/input/%s", de->d_name);
+        fd = open(found, O_RDONLY);
+        if (fd < 0)
+            continue;
+        if (!ioctl(fd, EVIOCGID, &id) && id.bustype == BUS_VIRTUAL &&
+            id.vendor == LN_TOUCH_VENDOR && id.product == LN_TOUCH_PRODUCT) {
+            closedir(dir);
+            return fd;
+        }
+        close(fd);
+    }
+    closedir(dir);
+    errno = ENODEV;
+    return -1;
+}
+
+static void lat_add(struct lat *l, long long ns) {
+    if (l->count == l->cap) {
+        size_t cap = l->cap ? l->cap * 2 : 65536;
+        uint32_t *grown = realloc(l->ns, cap * sizeof(*grown));
+
+        if (!grown)
+            return;
+        l->ns = grown;
+        l->cap = cap;
+    }
+    l->ns[l->count++] = ns < 0 ? 0 : ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void bench_record(const char *name, int threads, double value, const char *unit) {
+    printf("{\"bench\":\"%s\",\"threads\":%d,\"value\":%.3f,\"unit\":\"%s\",\"better\":\"lower\"}\n",
+           name, threads, value, unit);
+    fflush(stdout);
+    fprintf(stderr, "  %-24s x%-3d %12.3f %s\n", name, threads, value, unit);
+}
+
+static void report(const char *stage, struct lat *l, int load) {
+    static const struct { const char *name; int per_mille; } pct[] = {
+        { "p50", 500 }, { "p90", 900 }, { "p99", 990 }, { "p999", 999 }, { "max", 1000 },
+    };
+    char name[64];
+    size_t i;
+
+    if (!l->count)
+        return;
+    qsort(l->ns, l->count, sizeof(*l->ns), cmp_u32);
+    for (i = 0; i < sizeof(pct) / sizeof(pct[0]); i++) {
+        size_t k = (l->count * pct[i].per_mille + 999) / 1000;
+
+        snprintf(name, sizeof(name), "touch.lat_%s_%s", stage, pct[i].name);
+        bench_record(name, load, l->ns[k ? k - 1 : 0] / 1000.0, "us");
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [-d /dev/input/eventN] [-t SECONDS] [-l LOAD_THREADS]\n"
+            "          [-p READER_SCHED] [-P LOAD_SCHED] [-c READER_CPU] [-C LOAD_CPU]\n"
+            "  SCHED is fifo:PRIO, rr:PRIO (1-99) or other:NICE (-20-19)\n", prog);
+}
+
+int main(int argc, char **argv) {
+    struct sched_opt reader = { 0 };
+    struct load_arg load = { .cpu = -1 };
+    struct lat gen_sync = { 0 }, sync_read = { 0 }, total = { 0 };
+    struct input_event ev[64];
+    pthread_t tid[256];
+    const char *dev = NULL;
+    char path[280];
+    long long end, msc_ns = -1;
+    uint32_t msc = 0;
+    int seconds = 10, nload = 0, reader_cpu = -1, clk = CLOCK_MONOTONIC;
+    int fd, opt, i, err, frames = 0, have_msc = 0, started = 0;
+
+    while ((opt = getopt(argc, argv, "d:t:l:p:P:c:C:h")) != -1) {
+        switch (opt) {
+        case 'd': dev = optarg; break;
+        case 't': if (parse_int(optarg, 1, 86400, &seconds)) goto bad; break;
+        case 'l': if (parse_int(optarg, 0, 256, &nload)) goto bad; break;
+        case 'p': if (parse_sched(optarg, &reader)) goto bad; break;
+        case 'P': if (parse_sched(optarg, &load.sched)) goto bad; break;
+        case 'c': if (parse_cpu(optarg, &reader_cpu)) goto bad; break;
+        case 'C': if (parse_cpu(optarg, &load.cpu)) goto bad; break;
+        default: goto bad;
+        }
+    }
+
+    fd = open_device(dev, path, sizeof(path));
+    if (fd < 0) {
+        fprintf(stderr, "lnp_inputlat: %s: %s\n", dev ? dev : "touchscreen not found",
+                strerror(errno));
+        return 1;
+    }
+    if (ioctl(fd, EVIOCSCLOCKID, &clk)) {
+        perror("EVIOCSCLOCKID");
+        return 1;
+    }
+
+    apply_thread("reader", &reader, reader_cpu);
+    /* run with the load threads that did start; the report shows how many */
+    for (; started < nload; started++) {
+        err = pthread_create(&tid[started], NULL, load_thread, &load);
+        if (err) {
+            fprintf(stderr, "lnp_inputlat: load thread %d: %s\n", started + 1, strerror(err));
+            break;
+        }
+    }
+    fprintf(stderr, "lnp_inputlat: %s for %d s, %d load threads\n", path, seconds, started);
+
+    end = mono_ns() + seconds * 1000000000LL;
+    while (mono_ns() < end) {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        ssize_t n;
+        long long now;
+
+        /* idle frames carry no events without timestamp=1 */
+        if (poll(&pfd, 1, 100) <= 0)
+            continue;
+        n = read(fd, ev, sizeof(ev));
+        now = mono_ns();
+        if (n < (ssize_t)sizeof(ev[0]))
+            break;
+        for (i = 0; i < n / (ssize_t)sizeof(ev[0]); i++) {
+            long long t = ev[i].input_event_sec * 1000000000LL + ev[i].input_event_usec * 1000LL;
+
+            if (ev[i].type == EV_MSC && ev[i].code == MSC_TIMESTAMP) {
+                msc = ev[i].value;
+                have_msc = 1;
+                continue;
+            }
+            if (ev[i].type != EV_SYN || ev[i].code != SYN_REPORT)
+                continue;
+
+            /* the 32-bit µs stamp wraps every ~71 min: extend it using the event time */
+            if (have_msc) {
+                uint32_t back_us = (uint32_t)(t / 1000) - msc;
+
+                msc_ns = t - (long long)back_us * 1000;
+                lat_add(&gen_sync, t - msc_ns);
+                lat_add(&total, now - msc_ns);
+                have_msc = 0;
+            }
+            lat_add(&sync_read, now - t);
+            frames++;
+        }
+    }
+    atomic_store(&stop, 1);
+    for (i = 0; i < started; i++)
+        pthread_join(tid[i], NULL);
+    close(fd);
+
+    fprintf(stderr, "lnp_inputlat: %d frames\n", frames);
+    if (!frames) {
+        fprintf(stderr, "lnp_inputlat: no input; is the module loaded?\n");
+        return 1;
+    }
+    if (msc_ns < 0)
+        fprintf(stderr, "lnp_inputlat: no MSC_TIMESTAMP, load the module with timestamp=1 "
+                        "for gen_sync and total\n");
+    report("gen_sync", &gen_sync, started);
+    report("sync_read", &sync_read, started);
+    report("total", &total, started);
+    free(gen_sync.ns);
+    free(sync_read.ns);
+    free(total.ns);
+    return 0;
+
+bad:
+    usage(argv[0]);
+    return opt == 'h' ? 0 : 2;
+}
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_simd.c - Runtime-dispatched SIMD kernels of liblnpdrv
+ *
+ * Each kernel has a scalar reference and one entry per ISA in an
+ * lnp_impl table (lnp_cpu.h); *_select() returns the best one the mask
+ * allows. x86 entries carry their LNP_TARGET_* attribute, so the rest of
+ * the library stays at the build baseline; NEON is baseline on arm64; the
+ * SVE entries live in lnp_simd_sve.c, the only file built with +sve.
+ *
+ * lnp_dot_s8: sum of a[i] * b[i] over int8 vectors, accumulated modulo
+ * 2^32 so every entry returns the same bits as the scalar one for any n.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include "lnp_user.h"
+
+#if defined(LNP_ARCH_X86)
+#include <immintrin.h>
+#elif defined(LNP_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+static int32_t dot_s8_scalar(const int8_t *a, const int8_t *b, size_t n)
+{
+    uint32_t acc = 0;
+    size_t i;
+
+    for (i = 0; i < n; i++)
+        acc += (uint32_t)(a[i] * b[i]);
+    return (int32_t)acc;
+}
+
+#if defined(LNP_ARCH_X86)
+/* Two int8 products summed per int32 lane by pmaddwd: never above 2 * 128 * 128 */
+LNP_TARGET_SSE42
+static int32_t dot_s8_sse42(const int8_t *a, const int8_t *b, size_t n)
+{
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m128i va = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i *)(a + i)));
+        __m128i vb = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i *)(b + i)));
+
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(va, vb));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4e));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xb1));
+    return (int32_t)((uint32_t)_mm_cvtsi128_si32(acc) + (uint32_t)dot_s8_scalar(a + i, b + i, n - i));
+}
+
+LNP_TARGET_AVX2
+static int32_t dot_s8_avx2(const int8_t *a, const int8_t *b, size_t n)
+{
+    __m256i acc = _mm256_setzero_si256();
+    __m128i r;
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(a + i)));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(b + i)));
+
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    r = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    r = _mm_add_epi32(r, _mm_shuffle_epi32(r, 0x4e));
+    r = _mm_add_epi32(r, _mm_shuffle_epi32(r, 0xb1));
+    return (int32_t)((uint32_t)_mm_cvtsi128_si32(r) + (uint32_t)dot_s8_scalar(a + i, b + i, n - i));
+}
+
+LNP_TARGET_AVX512
+static int32_t dot_s8_avx512(const int8_t *a, const int8_t *b, size_t n)
+{
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m512i va = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i *)(a + i)));
+        __m512i vb = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i *)(b + i)));
+
+        acc = _mm512_add_epi32(acc, _mm512_madd_epi16(va, vb));
+    }
+    return (int32_t)((uint32_t)_mm512_reduce_add_epi32(acc) +
+                     (uint32_t)dot_s8_scalar(a + i, b + i, n - i));
+}
+#endif
+
+#if defined(LNP_ARCH_ARM64)
+static int32_t dot_s8_neon(const int8_t *a, const int8_t *b, size_t n)
+{
+    int32x4_t acc = vdupq_n_s32(0);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        int8x16_t va = vld1q_s8(a + i), vb = vld1q_s8(b + i);
+
+        acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(va), vget_low_s8(vb)));
+        acc = vpadalq_s16(acc, vmull_high_s8(va, vb));
+    }
+    return (int32_t)((uint32_t)vaddvq_s32(acc) + (uint32_t)dot_s8_scalar(a + i, b + i, n - i));
+}
+#endif
+
+static const struct lnp_impl dot_s8_impls[] = {
+    LNP_IMPL(LNP_ISA_SCALAR, dot_s8_scalar),
+#if defined(LNP_ARCH_X86)
+    LNP_IMPL(LNP_ISA_SSE42, dot_s8_sse42),
+    LNP_IMPL(LNP_ISA_AVX2, dot_s8_avx2),
+    LNP_IMPL(LNP_ISA_AVX512, dot_s8_avx512),
+#elif defined(LNP_ARCH_ARM64)
+    LNP_IMPL(LNP_ISA_NEON, dot_s8_neon),
+#ifdef LNP_HAVE_SVE
+    LNP_IMPL(LNP_ISA_SVE, lnp_dot_s8_sve),
+#endif
+#endif
+};
+
+lnp_dot_s8_fn lnp_dot_s8_select(uint32_t isa_mask, enum lnp_isa *isa)
+{
+    const struct lnp_impl *impl = lnp_dispatch(dot_s8_impls,
+                                               sizeof(dot_s8_impls) / sizeof(dot_s8_impls[0]),
+                                               isa_mask);
+
+    if (isa)
+        *isa = impl->isa;
+    return (lnp_dot_s8_fn)impl->fn;
+}
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_simd_sve.c - SVE entries of the lnp_simd.c kernels
+ *
+ * Built only on arm64 and only this file with -march=armv8.2-a+sve (see
+ * the Makefile), so nothing else in liblnpdrv can pick up SVE code; the
+ * entries are reached only when getauxval() reports HWCAP_SVE. Vector
+ * length agnostic: the tail is a predicated iteration, not scalar code.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include <arm_sve.h>
+
+#include "lnp_user.h"
+
+int32_t lnp_dot_s8_sve(const int8_t *a, const int8_t *b, size_t n)
+{
+    svint32_t acc = svdup_n_s32(0);
+    size_t i;
+
+    /* inactive lanes load as zero and add nothing to SDOT */
+    for (i = 0; i < n; i += svcntb()) {
+        svbool_t pg = svwhilelt_b8_u64(i, n);
+
+        acc = svdot_s32(acc, svld1_s8(pg, a + i), svld1_s8(pg, b + i));
+    }
+    return (int32_t)(uint32_t)svaddv_s32(svptrue_b32(), acc);
+}
@@ -0,0 +1,301 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_trace.c - Create and inspect touchscreen traces for driver replay
+ *
+ * The touchscreen module replays .lntt traces (format in touch_core.h)
+ * loaded with request_firmware:
+ *   ./lnp_trace synth swipe.lntt 10 480 5      # 10 s simulated, 480 Hz, 5 fingers
+ *   ./lnp_trace synth swipe.lntt 10 480 5 42   # same, reproducible from seed 42
+ *   ./lnp_trace record /dev/input/event3 real.lntt 30
+ *   ./lnp_trace dump real.lntt
+ *   sudo cp real.lntt /lib/firmware/
+ *   echo real.lntt | sudo tee /sys/class/input/inputN/replay
+ *
+ * record reads any multitouch type-B evdev device and rescales its axes
+ * to the driver's panel; contacts beyond slot 9 are ignored. Events are
+ * stamped on CLOCK_MONOTONIC (EVIOCSCLOCKID), so a wall-clock step while
+ * recording cannot make the trace go backwards.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "touch_core.h"
+#include "lnp_user.h"
+
+static int write_file(const char *path, const void *data, size_t size)
+{
+    FILE *f = fopen(path, "wb");
+
+    if (!f || fwrite(data, 1, size, f) != size || fclose(f)) {
+        perror(path);
+        return 1;
+    }
+    return 0;
+}
+
+static void *read_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    void *data = NULL;
+    long len;
+
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+    if (fseek(f, 0, SEEK_END) == 0 && (len = ftell(f)) >= 0 && fseek(f, 0, SEEK_SET) == 0 &&
+        (data = malloc(len ? len : 1)) && fread(data, 1, len, f) == (size_t)len) {
+        *size = len;
+    } else {
+        perror(path);
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+static int cmd_synth(int argc, char **argv)
+{
+    unsigned int seconds = atoi(argv[3]);
+    unsigned int rate = argc > 4 ? atoi(argv[4]) : 240;
+    unsigned int contacts = argc > 5 ? atoi(argv[5]) : LN_TOUCH_MAX_CONTACTS;
+    unsigned int seed = argc > 6 ? strtoul(argv[6], NULL, 0) : 0;
+    size_t size;
+    void *trace;
+    int ret;
+
+    if (!seconds || seconds > 3600 || rate < LN_TOUCH_RATE_MIN || rate > LN_TOUCH_RATE_MAX ||
+        !contacts || contacts > LN_TOUCH_MAX_CONTACTS) {
+        fprintf(stderr, "synth: 1-3600 s, %d-%d Hz, 1-%d contacts\n",
+                LN_TOUCH_RATE_MIN, LN_TOUCH_RATE_MAX, LN_TOUCH_MAX_CONTACTS);
+        return 2;
+    }
+    trace = lnp_touch_trace_synth(seconds, rate, contacts, seed, &size);
+    if (!trace) {
+        fprintf(stderr, "synth: out of memory\n");
+        return 1;
+    }
+    ret = write_file(argv[2], trace, size);
+    free(trace);
+    return ret;
+}
+
+struct rec_axis {
+    int min, max, out_max;
+};
+
+static int axis_scale(const struct rec_axis *a, int v)
+{
+    if (a->max <= a->min)
+        return 0;
+    if (v < a->min)
+        v = a->min;
+    if (v > a->max)
+        v = a->max;
+    return (long long)(v - a->min) * a->out_max / (a->max - a->min);
+}
+
+static int axis_get(int fd, int code, struct rec_axis *a, int out_max)
+{
+    struct input_absinfo abs;
+
+    if (ioctl(fd, EVIOCGABS(code), &abs) < 0)
+        return -1;
+    a->min = abs.minimum;
+    a->max = abs.maximum;
+    a->out_max = out_max;
+    return 0;
+}
+
+static long long event_us(const struct input_event *ev)
+{
+    return (long long)ev->input_event_sec * 1000000 + ev->input_event_usec;
+}
+
+/* Follows the type-B slot protocol; every SYN_REPORT writes the slots that changed */
+static int cmd_record(char **argv)
+{
+    struct rec_axis ax, ay, ap = { 0, 0, 0 };
+    struct {
+        int down, x, y, p, dirty;
+    } slot[LN_TOUCH_MAX_CONTACTS] = { { 0 } };
+    struct ln_touch_trace_hdr h;
+    struct ln_touch_trace_rec *rec = NULL;
+    size_t count = 0, cap = 0;
+    long long start = -1, t_us = 0, limit_us = atoll(argv[4]) * 1000000LL;
+    struct input_event ev;
+    FILE *f;
+    int fd, cur = 0, i, have_p, ret, clk = CLOCK_MONOTONIC;
+
+    fd = open(argv[2], O_RDONLY);
+    if (fd < 0) {
+        perror(argv[2]);
+        return 1;
+    }
+    /* t_us is 32-bit in the trace */
+    if (limit_us <= 0 || limit_us > 3600000000LL ||
+        axis_get(fd, ABS_MT_POSITION_X, &ax, LN_TOUCH_MAX_X) ||
+        axis_get(fd, ABS_MT_POSITION_Y, &ay, LN_TOUCH_MAX_Y)) {
+        fprintf(stderr, "record: %s is not a multitouch device, or duration not 1-3600 s\n", argv[2]);
+        close(fd);
+        return 2;
+    }
+    if (ioctl(fd, EVIOCSCLOCKID, &clk)) {
+        perror("EVIOCSCLOCKID");
+        close(fd);
+        return 1;
+    }
+    have_p = !axis_get(fd, ABS_MT_PRESSURE, &ap, LN_TOUCH_MAX_PRESSURE);
+    fprintf(stderr, "record: %s for %s s, touch the panel\n", argv[2], argv[4]);
+
+    while (t_us < limit_us) {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+
+        if (start >= 0) {
+            struct timespec now;
+
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            t_us = (long long)now.tv_sec * 1000000 + now.tv_nsec / 1000 - start;
+        }
+        if (poll(&pfd, 1, 100) <= 0)
+            continue;
+        if (read(fd, &ev, sizeof(ev)) != sizeof(ev))
+            break;
+
+        if (ev.type == EV_ABS) {
+            if (ev.code == ABS_MT_SLOT) {
+                cur = ev.value;
+                continue;
+            }
+            if (cur < 0 || cur >= LN_TOUCH_MAX_CONTACTS)
+                continue;
+            switch (ev.code) {
+            case ABS_MT_TRACKING_ID:
+                slot[cur].down = ev.value >= 0;
+                if (!have_p)
+                    slot[cur].p = LN_TOUCH_MAX_PRESSURE / 2;
+                break;
+            case ABS_MT_POSITION_X: slot[cur].x = axis_scale(&ax, ev.value); break;
+            case ABS_MT_POSITION_Y: slot[cur].y = axis_scale(&ay, ev.value); break;
+            case ABS_MT_PRESSURE:   slot[cur].p = axis_scale(&ap, ev.value); break;
+            default: continue;
+            }
+            slot[cur].dirty = 1;
+            continue;
+        }
+        if (ev.type != EV_SYN || ev.code != SYN_REPORT)
+            continue;
+
+        if (start < 0)
+            start = event_us(&ev);
+        t_us = event_us(&ev) - start;
+        for (i = 0; i < LN_TOUCH_MAX_CONTACTS; i++) {
+            if (!slot[i].dirty)
+                continue;
+            if (count == cap) {
+                void *grown = realloc(rec, (cap ? cap * 2 : 4096) * sizeof(*rec));
+
+                if (!grown) {
+                    fprintf(stderr, "record: out of memory\n");
+                    free(rec);
+                    close(fd);
+                    return 1;
+                }
+                rec = grown;
+                cap = cap ? cap * 2 : 4096;
+            }
+            rec[count].t_us = htole32((u32)t_us);
+            rec[count].slot = i;
+            rec[count].flags = slot[i].down ? LN_TOUCH_REC_DOWN : 0;
+            rec[count].x = htole16(slot[i].x);
+            rec[count].y = htole16(slot[i].y);
+            rec[count].pressure = htole16(slot[i].p);
+            slot[i].dirty = 0;
+            count++;
+        }
+    }
+    close(fd);
+
+    if (!count) {
+        fprintf(stderr, "record: no touches seen\n");
+        free(rec);
+        return 1;
+    }
+    h.magic = htole32(LN_TOUCH_TRACE_MAGIC);
+    h.version = htole16(LN_TOUCH_TRACE_VERSION);
+    h.rec_size = htole16(sizeof(*rec));
+    h.count = htole32(count);
+    h.duration_us = htole32(le32toh(rec[count - 1].t_us) + 1);
+
+    f = fopen(argv[3], "wb");
+    ret = !f || fwrite(&h, sizeof(h), 1, f) != 1 ||
+          fwrite(rec, sizeof(*rec), count, f) != count || fclose(f);
+    if (ret)
+        perror(argv[3]);
+    fprintf(stderr, "record: %zu records\n", count);
+    free(rec);
+    return ret;
+}
+
+static int cmd_dump(int argc, char **argv)
+{
+    struct ln_touch_replay r;
+    size_t size;
+    void *data = read_file(argv[2], &size);
+    u32 i, frames = 0, prev = 0;
+
+    (void)argc;
+    if (!data)
+        return 1;
+    if (ln_touch_trace_parse(data, size, &r)) {
+        fprintf(stderr, "%s: not a valid v%d trace\n", argv[2], LN_TOUCH_TRACE_VERSION);
+        free(data);
+        return 1;
+    }
+    for (i = 0; i < r.count; i++) {
+        const struct ln_touch_trace_rec *e = &r.rec[i];
+        u32 t = le32toh(e->t_us);
+
+        if (!i || t != prev)
+            frames++;
+        prev = t;
+        printf("%u %u %s %u %u %u\n", t, e->slot, e->flags & LN_TOUCH_REC_DOWN ? "down" : "up",
+               le16toh(e->x), le16toh(e->y), le16toh(e->pressure));
+    }
+    fprintf(stderr, "%s: %u records, %u frames, %u us per loop\n",
+            argv[2], r.count, frames, r.duration_us);
+    free(data);
+    return 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s synth OUT SECONDS [RATE_HZ [CONTACTS [SEED]]]\n"
+            "       %s record /dev/input/eventN OUT SECONDS\n"
+            "       %s dump FILE\n", prog, prog, prog);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 4 && !strcmp(argv[1], "synth"))
+        return cmd_synth(argc, argv);
+    if (argc == 5 && !strcmp(argv[1], "record"))
+        return cmd_record(argv);
+    if (argc == 3 && !strcmp(argv[1], "dump"))
+        return cmd_dump(argc, argv);
+    usage(argv[0]);
+    return 2;
+}
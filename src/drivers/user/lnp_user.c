@@ -0,0 +1,286 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_user.c - Driver cores built as a userspace library (liblnpdrv.a)
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "neural_core.h"
+#include "eyes_core.h"
+#include "touch_core.h"
+#include "lnp_user.h"
+
+struct lnp_neural {
+    struct neural_core core;
+    void *mem;
+};
+
+struct lnp_neural_reader {
+    struct lnp_neural *n;
+    struct mutex lock;
+    struct neural_cursor cur;
+};
+
+struct lnp_neural *lnp_neural_create(void)
+{
+    struct lnp_neural *n = calloc(1, sizeof(*n));
+
+    if (!n)
+        return NULL;
+    /* same layout as the module's vmalloc_user(): control page + ring */
+    if (posix_memalign(&n->mem, PAGE_SIZE, PAGE_SIZE + NEURAL_RING_BYTES)) {
+        free(n);
+        return NULL;
+    }
+    memset(n->mem, 0, PAGE_SIZE + NEURAL_RING_BYTES);
+    neural_core_init(&n->core, n->mem, PAGE_SIZE);
+    return n;
+}
+
+void lnp_neural_destroy(struct lnp_neural *n)
+{
+    if (!n)
+        return;
+    pthread_spin_destroy(&n->core.lock);
+    free(n->mem);
+    free(n);
+}
+
+void lnp_neural_generate(struct lnp_neural *n, unsigned int count)
+{
+    while (count--)
+        neural_core_produce(&n->core, ktime_get_ns(), NULL);
+}
+
+const struct neural_ring_ctrl *lnp_neural_ctrl(const struct lnp_neural *n)
+{
+    return n->core.ctrl;
+}
+
+struct lnp_neural_reader *lnp_neural_open(struct lnp_neural *n)
+{
+    struct lnp_neural_reader *r = calloc(1, sizeof(*r));
+
+    if (!r)
+        return NULL;
+    r->n = n;
+    mutex_init(&r->lock);
+    r->cur.pos = atomic64_read_acquire(&n->core.head);
+    return r;
+}
+
+void lnp_neural_close(struct lnp_neural_reader *r)
+{
+    if (!r)
+        return;
+    mutex_destroy(&r->lock);
+    free(r);
+}
+
+ssize_t lnp_neural_read(struct lnp_neural_reader *r, char *buf, size_t len)
+{
+    ssize_t ret;
+
+    mutex_lock(&r->lock);
+    ret = neural_core_read_text(&r->n->core, &r->cur, buf, len);
+    if (ret == -EAGAIN) {
+        neural_core_produce(&r->n->core, ktime_get_ns(), NULL);
+        ret = neural_core_read_text(&r->n->core, &r->cur, buf, len);
+    }
+    mutex_unlock(&r->lock);
+    return ret;
+}
+
+int lnp_neural_read_batch(struct lnp_neural_reader *r, struct neural_sample *out, unsigned int max)
+{
+    unsigned int n = 0;
+
+    mutex_lock(&r->lock);
+    while (n < max && !neural_core_fetch(&r->n->core, &r->cur, &out[n]))
+        n++;
+    r->cur.delivered += n;
+    mutex_unlock(&r->lock);
+    return n;
+}
+
+void lnp_neural_reader_stats(struct lnp_neural_reader *r, struct neural_reader_stats *st)
+{
+    mutex_lock(&r->lock);
+    st->delivered = r->cur.delivered;
+    st->dropped = r->cur.dropped;
+    st->cursor = r->cur.pos;
+    mutex_unlock(&r->lock);
+    st->head = atomic64_read_acquire(&r->n->core.head);
+}
+
+ssize_t lnp_eyes_read(char *buf, size_t len, bool blink)
+{
+    struct eyes_sample s;
+    char line[EYES_BUF_SZ];
+    size_t n;
+
+    eyes_core_generate(&s, blink);
+    n = eyes_core_format(line, sizeof(line), &s);
+    if (len < n)
+        return -EINVAL;
+    copy_to_user(buf, line, n);
+    return n;
+}
+
+struct lnp_eyes_filter {
+    struct eyes_filter f;
+};
+
+struct lnp_eyes_filter *lnp_eyes_filter_create(void)
+{
+    struct lnp_eyes_filter *ef = calloc(1, sizeof(*ef));
+
+    if (ef)
+        eyes_filter_default(&ef->f.cfg);
+    return ef;
+}
+
+void lnp_eyes_filter_destroy(struct lnp_eyes_filter *ef)
+{
+    free(ef);
+}
+
+int lnp_eyes_filter_command(struct lnp_eyes_filter *ef, const char *cmd)
+{
+    int err = eyes_filter_command(&ef->f.cfg, cmd);
+
+    if (!err)
+        eyes_filter_reset(&ef->f);
+    return err;
+}
+
+int lnp_eyes_filter_feed(struct lnp_eyes_filter *ef, int x, int y, bool blink, long long ts_ns,
+                         struct lnp_eyes_out *out)
+{
+    struct eyes_sample in = { .x = x, .y = y, .blink = blink, .ts = ns_to_ktime(ts_ns) };
+    struct eyes_sample res[EYES_FILTER_MAX_OUT];
+    unsigned int n = eyes_filter_run(&ef->f, &in, res), i;
+
+    for (i = 0; i < n; i++) {
+        out[i].x = res[i].x;
+        out[i].y = res[i].y;
+        out[i].event = res[i].event;
+        out[i].ts_ns = ktime_to_ns(res[i].ts);
+    }
+    return n;
+}
+
+struct lnp_touch {
+    struct ln_touch_sim sim;
+    struct ln_touch_replay replay;
+};
+
+struct lnp_touch *lnp_touch_create(void)
+{
+    struct lnp_touch *t = calloc(1, sizeof(*t));
+
+    if (t)
+        ln_touch_sim_init(&t->sim);
+    return t;
+}
+
+void lnp_touch_destroy(struct lnp_touch *t)
+{
+    free(t);
+}
+
+static int lnp_touch_points(const struct lnp_touch *t, struct lnp_touch_point *out)
+{
+    int i, n = 0;
+
+    for (i = 0; i < LN_TOUCH_MAX_CONTACTS; i++) {
+        const struct ln_touch_contact *c = &t->sim.c[i];
+
+        if (!c->active)
+            continue;
+        out[n].slot = i;
+        out[n].x = c->x >> 8;
+        out[n].y = c->y >> 8;
+        out[n].pressure = c->pressure;
+        n++;
+    }
+    return n;
+}
+
+int lnp_touch_step(struct lnp_touch *t, unsigned int rate_hz, unsigned int max_contacts,
+                   struct lnp_touch_point *out)
+{
+    ln_touch_sim_step(&t->sim, rate_hz, max_contacts);
+    return lnp_touch_points(t, out);
+}
+
+void *lnp_touch_trace_synth(unsigned int seconds, unsigned int rate_hz, unsigned int max_contacts,
+                            unsigned int seed, size_t *size)
+{
+    u32 frames = seconds * rate_hz, f, i, count = 0;
+    struct ln_touch_trace_hdr *h;
+    struct ln_touch_trace_rec *rec;
+    struct ln_touch_sim sim;
+    bool was[LN_TOUCH_MAX_CONTACTS] = { false };
+    void *shrunk;
+
+    h = malloc(sizeof(*h) + (size_t)frames * LN_TOUCH_MAX_CONTACTS * sizeof(*rec));
+    if (!h)
+        return NULL;
+    rec = (struct ln_touch_trace_rec *)(h + 1);
+
+    ln_touch_sim_init(&sim);
+    if (seed)
+        sim.rng = seed;
+    for (f = 0; f < frames; f++) {
+        u32 t_us = (u32)((u64)f * 1000000 / rate_hz);
+
+        ln_touch_sim_step(&sim, rate_hz, max_contacts);
+        for (i = 0; i < LN_TOUCH_MAX_CONTACTS; i++) {
+            const struct ln_touch_contact *c = &sim.c[i];
+
+            /* moving contacts every frame, plus the frame where one lifts */
+            if (!c->active && !was[i])
+                continue;
+            rec[count].t_us = htole32(t_us);
+            rec[count].slot = i;
+            rec[count].flags = c->active ? LN_TOUCH_REC_DOWN : 0;
+            rec[count].x = htole16(c->x >> 8);
+            rec[count].y = htole16(c->y >> 8);
+            rec[count].pressure = htole16(c->pressure);
+            was[i] = c->active;
+            count++;
+        }
+    }
+
+    h->magic = htole32(LN_TOUCH_TRACE_MAGIC);
+    h->version = htole16(LN_TOUCH_TRACE_VERSION);
+    h->rec_size = htole16(sizeof(*rec));
+    h->count = htole32(count);
+    h->duration_us = htole32(seconds * 1000000U);
+    *size = sizeof(*h) + (size_t)count * sizeof(*rec);
+    shrunk = realloc(h, *size);
+    return shrunk ? shrunk : h;
+}
+
+int lnp_touch_replay_load(struct lnp_touch *t, const void *data, size_t size)
+{
+    int ret = ln_touch_trace_parse(data, size, &t->replay);
+
+    if (!ret)
+        memset(t->sim.c, 0, sizeof(t->sim.c));
+    return ret;
+}
+
+int lnp_touch_replay_step(struct lnp_touch *t, bool loop, struct lnp_touch_point *out,
+                          long long *t_us)
+{
+    if (!t->replay.rec || ln_touch_replay_done(&t->replay))
+        return -1;
+    *t_us = ln_touch_replay_next_us(&t->replay);
+    ln_touch_replay_frame(&t->replay, t->sim.c, loop);
+    return lnp_touch_points(t, out);
+}
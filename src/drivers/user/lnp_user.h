@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_user.h - Userspace build of the Linus Neural driver cores
+ *
+ * liblnpdrv.a runs the same code as the modules (neural_core.h,
+ * eyes_core.h, touch_core.h) on top of lnp_kshim.h, with the read()
+ * semantics of /dev/neural and /dev/eyes in on-demand mode, plus the
+ * runtime-dispatched SIMD kernels (lnp_simd.c). Used by lnp_bench and by
+ * the lnp_cuse stand-in device.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef LNP_USER_H
+#define LNP_USER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "lnp_cpu.h"
+#include "neural_driver.h"
+
+struct lnp_neural;
+struct lnp_neural_reader;
+
+/* One simulated /dev/neural: shared ring plus control page */
+struct lnp_neural *lnp_neural_create(void);
+void lnp_neural_destroy(struct lnp_neural *n);
+/* Produces count samples at once, as NEURAL_IOC_GENERATE */
+void lnp_neural_generate(struct lnp_neural *n, unsigned int count);
+const struct neural_ring_ctrl *lnp_neural_ctrl(const struct lnp_neural *n);
+
+/* One open() of /dev/neural; starts at the current head */
+struct lnp_neural_reader *lnp_neural_open(struct lnp_neural *n);
+void lnp_neural_close(struct lnp_neural_reader *r);
+/* Text lines as neural_read(); produces one sample when the reader is caught up */
+ssize_t lnp_neural_read(struct lnp_neural_reader *r, char *buf, size_t len);
+/* Binary records as NEURAL_IOC_READ_BATCH; returns count, never blocks */
+int lnp_neural_read_batch(struct lnp_neural_reader *r, struct neural_sample *out, unsigned int max);
+void lnp_neural_reader_stats(struct lnp_neural_reader *r, struct neural_reader_stats *st);
+
+/* One eyes_read(): fresh sample formatted into buf, -EINVAL if it does not fit */
+ssize_t lnp_eyes_read(char *buf, size_t len, bool blink);
+
+/* eyes processing stages (eyes_core.h) on caller-supplied samples */
+struct lnp_eyes_filter;
+
+struct lnp_eyes_out {
+    int x, y;
+    int event;              /* EYES_EV_* from eyes_core.h; 0 = sample */
+    long long ts_ns;
+};
+
+struct lnp_eyes_filter *lnp_eyes_filter_create(void);
+void lnp_eyes_filter_destroy(struct lnp_eyes_filter *f);
+/* Same commands as /dev/eyes ("smooth=euro", "output=events", ...); 0, -EINVAL or -ENOENT */
+int lnp_eyes_filter_command(struct lnp_eyes_filter *f, const char *cmd);
+/* Feeds one sample; fills out[2] and returns how many were emitted */
+int lnp_eyes_filter_feed(struct lnp_eyes_filter *f, int x, int y, bool blink, long long ts_ns,
+                         struct lnp_eyes_out *out);
+
+/* Touchscreen contact simulation, one ln_touch_event() frame per step */
+#define LNP_TOUCH_MAX_CONTACTS 10
+
+struct lnp_touch;
+
+struct lnp_touch_point {
+    int slot;
+    int x, y;
+    int pressure;
+};
+
+struct lnp_touch *lnp_touch_create(void);
+void lnp_touch_destroy(struct lnp_touch *t);
+/* Advances one 1/rate_hz frame; fills out[] with the active contacts and returns their count */
+int lnp_touch_step(struct lnp_touch *t, unsigned int rate_hz, unsigned int max_contacts,
+                   struct lnp_touch_point *out);
+
+/* Recorded traces (.lntt, format in touch_core.h), as replayed by the driver */
+/* Simulates seconds of input at rate_hz into a malloc()ed trace; NULL on ENOMEM.
+ * The same nonzero seed gives the same trace; 0 seeds from get_random_bytes */
+void *lnp_touch_trace_synth(unsigned int seconds, unsigned int rate_hz, unsigned int max_contacts,
+                            unsigned int seed, size_t *size);
+/* Validates and selects a trace (data must outlive the replay); 0 or -EINVAL */
+int lnp_touch_replay_load(struct lnp_touch *t, const void *data, size_t size);
+/* Applies the next frame; returns the active contacts, or -1 once a non-looping trace ended.
+ * *t_us receives the frame time, counting earlier loops */
+int lnp_touch_replay_step(struct lnp_touch *t, bool loop, struct lnp_touch_point *out,
+                          long long *t_us);
+
+/* Runtime-dispatched SIMD kernels (lnp_simd.c); pick once with the mask from lnp_cpu_detect() */
+typedef int32_t (*lnp_dot_s8_fn)(const int8_t *a, const int8_t *b, size_t n);
+/* Best implementation within isa_mask; *isa (may be NULL) receives the one chosen */
+lnp_dot_s8_fn lnp_dot_s8_select(uint32_t isa_mask, enum lnp_isa *isa);
+#ifdef LNP_HAVE_SVE
+int32_t lnp_dot_s8_sve(const int8_t *a, const int8_t *b, size_t n);
+#endif
+
+#endif /* LNP_USER_H */
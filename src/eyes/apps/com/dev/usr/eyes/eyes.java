@@ -1,46 +1,64 @@
 // SPDX-License-Identifier: Apache-2.0
 package com.dev.usr.eyes;
 
+import java.nio.ByteBuffer;
 import java.util.Random;
 
 /**
  * Classe principal do sistema de visão do Linus Neural Project.
- * Simula captura de imagem e envia dados brutos para a IA interpretar.
+ * Simula captura de imagem e envia os pixels para a IA interpretar, num
+ * ByteBuffer direto reaproveitado a cada quadro (a IA nativa lê sem cópia).
+ * A IA vive só durante startVision: close() libera o motor e suas threads.
  */
 public class eyes {
+    private static final int LARGURA = 320;
+    private static final int ALTURA = 240;
+
     private boolean active;
     private final Random rand;
-    private final ia neuralIA;
     private final lux lightSensor;
+    private final ByteBuffer pixels = ByteBuffer.allocateDirect(LARGURA * ALTURA * ia.FORMATO_RGB);
 
     public eyes() {
         this.active = false;
         this.rand = new Random();
-        this.neuralIA = new ia();
         this.lightSensor = new lux();
     }
 
     public void startVision() {
         System.out.println("[EYES] Inicializando visão neural...");
         active = true;
-        for (int i = 0; i < 5; i++) {
-            captureFrame();
-            try { Thread.sleep(1000); } catch (InterruptedException ignored) {}
+        try (ia neuralIA = new ia()) {
+            for (int i = 0; i < 5; i++) {
+                captureFrame(neuralIA);
+                try { Thread.sleep(1000); } catch (InterruptedException ignored) {}
+            }
+            System.out.println("[EYES] IA: " + neuralIA.stats());
         }
         System.out.println("[EYES] Encerrando visão neural.");
     }
 
-    private void captureFrame() {
+    private void captureFrame(ia neuralIA) {
         if (!active) return;
         int light = lightSensor.measureLight();
         String frame = "[EYES] Captura de quadro #" + (rand.nextInt(9000) + 1000)
                 + " | Luminosidade=" + light + " lux";
         System.out.println(frame);
 
-        String analysis = neuralIA.processFrame(frame, light);
+        simularQuadro(light);
+        String analysis = neuralIA.processFrame(pixels, LARGURA, ALTURA, ia.FORMATO_RGB, light);
         System.out.println("[EYES] Interpretação IA → " + analysis);
     }
 
+    /** Preenche o quadro RGB com ruído cuja média acompanha a luminosidade */
+    private void simularQuadro(int light) {
+        int base = Math.min(255, light / 4);
+        pixels.clear();
+        for (int i = 0; i < LARGURA * ALTURA * ia.FORMATO_RGB; i++)
+            pixels.put((byte) Math.min(255, base + rand.nextInt(32)));
+        pixels.clear();
+    }
+
     public void stopVision() {
         this.active = false;
     }
@@ -1,24 +1,108 @@
 // SPDX-License-Identifier: Apache-2.0
 package com.dev.usr.eyes;
 
+import java.io.IOException;
+import java.nio.ByteBuffer;
 import java.util.Random;
 
 /**
  * Classe responsável por processar quadros e interpretar padrões visuais.
- * Usa simulação de IA neural para "reconhecer" objetos.
+ * Classifica cada quadro na CPU com o motor int8 nativo (src/eyes/native,
+ * liblnpeyes.so) por JNI. O quadro vai num ByteBuffer direto, lido pelo
+ * C++ sem cópia; cada resposta traz a latência do quadro, e stats() dá
+ * média, p99 e vazão. Os rótulos vêm do arquivo do modelo.
+ *
+ * Sem a biblioteca ou sem o modelo (make install em src/eyes/native grava
+ * o sintético em MODELO_PADRAO), volta à simulação antiga: um rótulo
+ * sorteado, marcado como simulado e com o motivo.
  */
-public class ia {
-    private final Random rand = new Random();
+public class ia implements AutoCloseable {
+    /** Formatos de pixel (bytes por pixel), como PixelFormat em lnp_infer.h */
+    public static final int FORMATO_CINZA = 1;
+    public static final int FORMATO_RGB = 3;
+    public static final int FORMATO_RGBA = 4;
+
+    /** Modelo padrão; outro caminho pela propriedade lnp.eyes.model */
+    public static final String MODELO_PADRAO = "/system/etc/lnp/eyes.lnm";
+
+    private static final boolean NATIVO = carregarNativo();
 
-    private final String[] objects = {
+    /** Rótulos da simulação, usados quando o motor nativo não carrega */
+    private static final String[] SIMULADOS = {
         "humano", "cachorro", "computador", "árvore", "celular", "luz forte", "movimento rápido"
     };
 
-    public String processFrame(String frame, int lux) {
-        String obj = objects[rand.nextInt(objects.length)];
+    private final Random rand = new Random();
+    private long handle;
+    private String[] objects = {};
+    private String erro;
+    private final float[] saida = new float[2];     // confiança, latência (ms)
+
+    public ia() {
+        this(System.getProperty("lnp.eyes.model", MODELO_PADRAO), 0);
+    }
+
+    /** threads = 0: uma por CPU */
+    public ia(String modelo, int threads) {
+        if (!NATIVO) {
+            erro = "liblnpeyes não carregada";
+            return;
+        }
+        try {
+            handle = nativeCreate(modelo, threads);
+            objects = nativeLabels(handle);
+        } catch (IOException e) {
+            erro = e.getMessage();
+        }
+    }
+
+    /** frame: ByteBuffer.allocateDirect com width * height * format bytes, linhas contíguas */
+    public synchronized String processFrame(ByteBuffer frame, int width, int height, int format, int lux) {
         String clarity = (lux < 100) ? "baixa luz" :
                          (lux < 500) ? "luz moderada" : "alta luz";
 
-        return "Objeto: " + obj + " | Condição: " + clarity;
+        if (handle == 0)
+            return "Objeto: " + SIMULADOS[rand.nextInt(SIMULADOS.length)]
+                    + " (simulado: " + erro + ") | Condição: " + clarity;
+
+        int label = nativeClassify(handle, frame, width, height, width * format, format, saida);
+        return String.format("Objeto: %s (%.0f%%) | Condição: %s | %.2f ms",
+                             objects[label], saida[0] * 100, clarity, saida[1]);
     }
+
+    /** Latência e vazão desde a carga do modelo */
+    public synchronized String stats() {
+        if (handle == 0)
+            return "IA nativa indisponível: " + erro;
+
+        double[] s = nativeStats(handle);
+        return String.format("%d quadros | média %.2f ms | p50 %.2f ms | p99 %.2f ms | %.1f quadros/s | %s, %d threads",
+                             (long) s[0], s[2], s[3], s[4], s[5], nativeIsa(handle), (int) s[6]);
+    }
+
+    @Override
+    public synchronized void close() {
+        if (handle != 0) {
+            nativeDestroy(handle);
+            handle = 0;
+            erro = "fechada";
+        }
+    }
+
+    private static boolean carregarNativo() {
+        try {
+            System.loadLibrary("lnpeyes");
+            return true;
+        } catch (UnsatisfiedLinkError e) {
+            return false;
+        }
+    }
+
+    private static native long nativeCreate(String modelo, int threads) throws IOException;
+    private static native void nativeDestroy(long handle);
+    private static native String[] nativeLabels(long handle);
+    private static native int nativeClassify(long handle, ByteBuffer frame, int width, int height,
+                                             int stride, int format, float[] out);
+    private static native double[] nativeStats(long handle);
+    private static native String nativeIsa(long handle);
 }
@@ -3,7 +3,8 @@
  *
  * Contém as classes principais do sistema de visão do Linus Neural Project.
  * - eyes.java : captura e processa quadros de vídeo
- * - ia.java   : inteligência artificial visual (reconhecimento)
+ * - ia.java   : inteligência artificial visual (reconhecimento), com o
+ *               motor int8 nativo de src/eyes/native por JNI
  * - lux.java  : controle de brilho e percepção luminosa
  *
  * Licenciado sob Apache 2.0 — 2025 Linus Neural Project
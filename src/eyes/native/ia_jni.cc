@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * ia_jni.cc — Linus Neural Project
+ *
+ * Métodos nativos de com.dev.usr.eyes.ia (liblnpeyes.so). O quadro chega
+ * como ByteBuffer direto: GetDirectBufferAddress dá o endereço dos pixels
+ * e o motor lê dali, sem cópia para o heap Java nem de volta. Por quadro
+ * só cruzam a fronteira o índice do rótulo e dois floats (confiança e
+ * latência); os rótulos são lidos uma vez, em nativeLabels.
+ *
+ * O handle é o Engine* convertido para long; ia.close() o libera.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include <jni.h>
+
+#include <new>
+#include <string>
+
+#include "lnp_infer.h"
+
+using namespace std;
+using namespace lnp_eyes;
+
+namespace {
+
+void throwJava(JNIEnv *env, const char *cls, const string &msg) {
+    jclass c = env->FindClass(cls);
+
+    if (c)
+        env->ThrowNew(c, msg.c_str());
+}
+
+Engine *engine(JNIEnv *env, jlong handle) {
+    Engine *eng = reinterpret_cast<Engine *>(static_cast<intptr_t>(handle));
+
+    if (!eng)
+        throwJava(env, "java/lang/IllegalStateException", "ia já foi fechada");
+    return eng;
+}
+
+} // namespace
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_dev_usr_eyes_ia_nativeCreate(JNIEnv *env, jclass, jstring model, jint threads) {
+    const char *path = env->GetStringUTFChars(model, nullptr);
+    string err, p;
+    Engine *eng;
+
+    if (!path)
+        return 0;
+    p = path;
+    env->ReleaseStringUTFChars(model, path);
+
+    eng = new (nothrow) Engine(threads > 0 ? (unsigned)threads : 0);
+    if (!eng) {
+        throwJava(env, "java/lang/OutOfMemoryError", "motor de inferência");
+        return 0;
+    }
+    if (!eng->load(p, err)) {
+        delete eng;
+        throwJava(env, "java/io/IOException", p + ": " + err);
+        return 0;
+    }
+    return static_cast<jlong>(reinterpret_cast<intptr_t>(eng));
+}
+
+JNIEXPORT void JNICALL
+Java_com_dev_usr_eyes_ia_nativeDestroy(JNIEnv *, jclass, jlong handle) {
+    delete reinterpret_cast<Engine *>(static_cast<intptr_t>(handle));
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_com_dev_usr_eyes_ia_nativeLabels(JNIEnv *env, jclass, jlong handle) {
+    Engine *eng = engine(env, handle);
+    jclass str = env->FindClass("java/lang/String");
+    jobjectArray out;
+
+    if (!eng || !str)
+        return nullptr;
+    const vector<string> &labels = eng->model().labels();
+    out = env->NewObjectArray((jsize)labels.size(), str, nullptr);
+    for (size_t i = 0; out && i < labels.size(); i++) {
+        jstring s = env->NewStringUTF(labels[i].c_str());
+
+        if (!s)
+            return nullptr;
+        env->SetObjectArrayElement(out, (jsize)i, s);
+        env->DeleteLocalRef(s);
+    }
+    return out;
+}
+
+/* out[0] = confiança, out[1] = latência em ms; retorna o índice do rótulo */
+JNIEXPORT jint JNICALL
+Java_com_dev_usr_eyes_ia_nativeClassify(JNIEnv *env, jclass, jlong handle, jobject frame,
+                                        jint width, jint height, jint stride, jint format,
+                                        jfloatArray out) {
+    Engine *eng = engine(env, handle);
+    const uint8_t *px;
+    jlong cap;
+
+    if (!eng)
+        return -1;
+    px = static_cast<const uint8_t *>(env->GetDirectBufferAddress(frame));
+    cap = env->GetDirectBufferCapacity(frame);
+    if (!px || cap < 0) {
+        throwJava(env, "java/lang/IllegalArgumentException",
+                  "o quadro precisa ser um ByteBuffer direto (allocateDirect)");
+        return -1;
+    }
+    if ((format != PIXEL_GRAY8 && format != PIXEL_RGB888 && format != PIXEL_RGBA8888) ||
+        width <= 0 || height <= 0 || stride < (jlong)width * format ||
+        (jlong)(height - 1) * stride + (jlong)width * format > cap) {
+        throwJava(env, "java/lang/IllegalArgumentException",
+                  "dimensões, stride ou formato não cabem no ByteBuffer");
+        return -1;
+    }
+
+    Result r = eng->classify(px, width, height, (size_t)stride, (PixelFormat)format);
+    jfloat v[2] = { r.confidence, (jfloat)r.latency_ms };
+
+    env->SetFloatArrayRegion(out, 0, 2, v);
+    return r.label;
+}
+
+/* [quadros, última, média, p50, p99 (ms), quadros/s, threads] */
+JNIEXPORT jdoubleArray JNICALL
+Java_com_dev_usr_eyes_ia_nativeStats(JNIEnv *env, jclass, jlong handle) {
+    Engine *eng = engine(env, handle);
+    jdoubleArray out;
+
+    if (!eng)
+        return nullptr;
+    Stats st = eng->stats();
+    jdouble v[7] = { (jdouble)st.frames, st.last_ms, st.mean_ms, st.p50_ms, st.p99_ms, st.fps,
+                     (jdouble)eng->threads() };
+    out = env->NewDoubleArray(7);
+    if (out)
+        env->SetDoubleArrayRegion(out, 0, 7, v);
+    return out;
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_dev_usr_eyes_ia_nativeIsa(JNIEnv *env, jclass, jlong handle) {
+    Engine *eng = engine(env, handle);
+
+    return eng ? env->NewStringUTF(lnp_isa_name(eng->isa())) : nullptr;
+}
+
+} // extern "C"
@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_gemm.cc — Linus Neural Project
+ *
+ * GEMM int8 por produtos escalares (lnp_gemm.h), em blocos:
+ *
+ *   - GEMM_MB linhas de A (pesos, até 64 x 576 bytes no modelo padrão)
+ *     ficam na L2 enquanto cada grupo de 4 linhas de B (L1) passa por elas;
+ *   - o micro-núcleo calcula 2 x 4 saídas de uma vez, reaproveitando cada
+ *     carga de A em 4 produtos e cada carga de B em 2;
+ *   - sobras em m ou n vão para o produto escalar 1 x 1.
+ *
+ * O laço de blocos é o mesmo nas três versões (GEMM_BLOCKED); ele fica
+ * dentro de cada função para que o micro-núcleo seja embutido com os
+ * mesmos atributos de alvo. Código AVX2 só existe nas funções marcadas com
+ * LNP_TARGET_AVX2: o resto da biblioteca é compilado para a base x86-64.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include "lnp_gemm.h"
+
+#if defined(LNP_ARCH_X86)
+#include <immintrin.h>
+#elif defined(LNP_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace lnp_eyes {
+
+#define GEMM_MB 64
+
+#define GEMM_BLOCKED(MICRO, DOT)                                                        \
+    for (size_t m0 = 0; m0 < m; m0 += GEMM_MB) {                                        \
+        size_t m1 = m - m0 < GEMM_MB ? m : m0 + GEMM_MB;                                \
+        size_t j = 0, i;                                                                \
+        for (; j + 4 <= n; j += 4) {                                                    \
+            for (i = m0; i + 2 <= m1; i += 2)                                           \
+                MICRO(a + i * lda, lda, b + j * ldb, ldb, c + j * ldc + i, ldc, k);     \
+            for (; i < m1; i++)                                                         \
+                for (size_t q = 0; q < 4; q++)                                          \
+                    c[(j + q) * ldc + i] = DOT(a + i * lda, b + (j + q) * ldb, k);      \
+        }                                                                               \
+        for (; j < n; j++)                                                              \
+            for (i = m0; i < m1; i++)                                                   \
+                c[j * ldc + i] = DOT(a + i * lda, b + j * ldb, k);                      \
+    }
+
+static inline int32_t dot_scalar(const int8_t *a, const int8_t *b, size_t k) {
+    uint32_t acc = 0;
+
+    for (size_t i = 0; i < k; i++)
+        acc += (uint32_t)(a[i] * b[i]);
+    return (int32_t)acc;
+}
+
+static inline void micro_scalar(const int8_t *a, size_t lda, const int8_t *b, size_t ldb,
+                                int32_t *c, size_t ldc, size_t k) {
+    for (size_t r = 0; r < 2; r++)
+        for (size_t q = 0; q < 4; q++)
+            c[q * ldc + r] = dot_scalar(a + r * lda, b + q * ldb, k);
+}
+
+static void gemm_scalar(const int8_t *a, size_t lda, const int8_t *b, size_t ldb,
+                        int32_t *c, size_t ldc, size_t m, size_t n, size_t k) {
+    GEMM_BLOCKED(micro_scalar, dot_scalar)
+}
+
+#if defined(LNP_ARCH_X86)
+/* 16 int8 -> 16 int16; pmaddwd soma pares de produtos em int32 sem estourar */
+LNP_TARGET_AVX2
+static inline __m256i load16_avx2(const int8_t *p) {
+    return _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)p));
+}
+
+/* Soma de cada um dos quatro acumuladores: [x, y, z, w] */
+LNP_TARGET_AVX2
+static inline __m128i hsum4_avx2(__m256i x, __m256i y, __m256i z, __m256i w) {
+    __m256i h = _mm256_hadd_epi32(_mm256_hadd_epi32(x, y), _mm256_hadd_epi32(z, w));
+
+    return _mm_add_epi32(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+}
+
+LNP_TARGET_AVX2
+static inline int32_t dot_avx2(const int8_t *a, const int8_t *b, size_t k) {
+    __m256i acc = _mm256_setzero_si256();
+    __m128i s;
+
+    for (size_t i = 0; i < k; i += 16)
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(load16_avx2(a + i), load16_avx2(b + i)));
+    s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4e));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xb1));
+    return _mm_cvtsi128_si32(s);
+}
+
+LNP_TARGET_AVX2
+static inline void micro_avx2(const int8_t *a, size_t lda, const int8_t *b, size_t ldb,
+                              int32_t *c, size_t ldc, size_t k) {
+    __m256i c00 = _mm256_setzero_si256(), c01 = c00, c02 = c00, c03 = c00;
+    __m256i c10 = c00, c11 = c00, c12 = c00, c13 = c00;
+    __m128i s0, s1;
+
+    for (size_t i = 0; i < k; i += 16) {
+        __m256i a0 = load16_avx2(a + i), a1 = load16_avx2(a + lda + i), bq;
+
+        bq = load16_avx2(b + i);
+        c00 = _mm256_add_epi32(c00, _mm256_madd_epi16(a0, bq));
+        c10 = _mm256_add_epi32(c10, _mm256_madd_epi16(a1, bq));
+        bq = load16_avx2(b + ldb + i);
+        c01 = _mm256_add_epi32(c01, _mm256_madd_epi16(a0, bq));
+        c11 = _mm256_add_epi32(c11, _mm256_madd_epi16(a1, bq));
+        bq = load16_avx2(b + 2 * ldb + i);
+        c02 = _mm256_add_epi32(c02, _mm256_madd_epi16(a0, bq));
+        c12 = _mm256_add_epi32(c12, _mm256_madd_epi16(a1, bq));
+        bq = load16_avx2(b + 3 * ldb + i);
+        c03 = _mm256_add_epi32(c03, _mm256_madd_epi16(a0, bq));
+        c13 = _mm256_add_epi32(c13, _mm256_madd_epi16(a1, bq));
+    }
+    s0 = hsum4_avx2(c00, c01, c02, c03);
+    s1 = hsum4_avx2(c10, c11, c12, c13);
+    c[0] = _mm_cvtsi128_si32(s0);
+    c[1] = _mm_cvtsi128_si32(s1);
+    c[ldc] = _mm_extract_epi32(s0, 1);
+    c[ldc + 1] = _mm_extract_epi32(s1, 1);
+    c[2 * ldc] = _mm_extract_epi32(s0, 2);
+    c[2 * ldc + 1] = _mm_extract_epi32(s1, 2);
+    c[3 * ldc] = _mm_extract_epi32(s0, 3);
+    c[3 * ldc + 1] = _mm_extract_epi32(s1, 3);
+}
+
+LNP_TARGET_AVX2
+static void gemm_avx2(const int8_t *a, size_t lda, const int8_t *b, size_t ldb,
+                      int32_t *c, size_t ldc, size_t m, size_t n, size_t k) {
+    GEMM_BLOCKED(micro_avx2, dot_avx2)
+}
+#endif
+
+#if defined(LNP_ARCH_ARM64)
+/* 16 produtos int8 -> int16 (vmull), somados aos pares em int32 (vpadal) */
+static inline int32x4_t mla16_neon(int32x4_t acc, int8x16_t x, int8x16_t y) {
+    acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(x), vget_low_s8(y)));
+    return vpadalq_s16(acc, vmull_high_s8(x, y));
+}
+
+static inline int32_t dot_neon(const int8_t *a, const int8_t *b, size_t k) {
+    int32x4_t acc = vdupq_n_s32(0);
+
+    for (size_t i = 0; i < k; i += 16)
+        acc = mla16_neon(acc, vld1q_s8(a + i), vld1q_s8(b + i));
+    return vaddvq_s32(acc);
+}
+
+static inline void micro_neon(const int8_t *a, size_t lda, const int8_t *b, size_t ldb,
+                              int32_t *c, size_t ldc, size_t k) {
+    int32x4_t c00 = vdupq_n_s32(0), c01 = c00, c02 = c00, c03 = c00;
+    int32x4_t c10 = c00, c11 = c00, c12 = c00, c13 = c00;
+
+    for (size_t i = 0; i < k; i += 16) {
+        int8x16_t a0 = vld1q_s8(a + i), a1 = vld1q_s8(a + lda + i), bq;
+
+        bq = vld1q_s8(b + i);
+        c00 = mla16_neon(c00, a0, bq);
+        c10 = mla16_neon(c10, a1, bq);
+        bq = vld1q_s8(b + ldb + i);
+        c01 = mla16_neon(c01, a0, bq);
+        c11 = mla16_neon(c11, a1, bq);
+        bq = vld1q_s8(b + 2 * ldb + i);
+        c02 = mla16_neon(c02, a0, bq);
+        c12 = mla16_neon(c12, a1, bq);
+        bq = vld1q_s8(b + 3 * ldb + i);
+        c03 = mla16_neon(c03, a0, bq);
+        c13 = mla16_neon(c13, a1, bq);
+    }
+    c[0] = vaddvq_s32(c00);
+    c[1] = vaddvq_s32(c10);
+    c[ldc] = vaddvq_s32(c01);
+    c[ldc + 1] = vaddvq_s32(c11);
+    c[2 * ldc] = vaddvq_s32(c02);
+    c[2 * ldc + 1] = vaddvq_s32(c12);
+    c[3 * ldc] = vaddvq_s32(c03);
+    c[3 * ldc + 1] = vaddvq_s32(c13);
+}
+
+static void gemm_neon(const int8_t *a, size_t lda, const int8_t *b, size_t ldb,
+                      int32_t *c, size_t ldc, size_t m, size_t n, size_t k) {
+    GEMM_BLOCKED(micro_neon, dot_neon)
+}
+#endif
+
+static const struct lnp_impl gemm_impls[] = {
+    LNP_IMPL(LNP_ISA_SCALAR, gemm_scalar),
+#if defined(LNP_ARCH_X86)
+    LNP_IMPL(LNP_ISA_AVX2, gemm_avx2),
+#elif defined(LNP_ARCH_ARM64)
+    LNP_IMPL(LNP_ISA_NEON, gemm_neon),
+#endif
+};
+
+GemmFn lnp_gemm_select(uint32_t isa_mask, enum lnp_isa *isa) {
+    const struct lnp_impl *impl =
+        lnp_dispatch(gemm_impls, sizeof(gemm_impls) / sizeof(gemm_impls[0]), isa_mask);
+
+    if (isa)
+        *isa = impl->isa;
+    return (GemmFn)impl->fn;
+}
+
+} // namespace lnp_eyes
@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_gemm.h — Linus Neural Project
+ *
+ * Núcleos int8 do motor de inferência (uso interno de lnp_infer.cc):
+ *
+ *   C[n * ldc + m] = sum_k A[m * lda + k] * B[n * ldb + k]
+ *
+ * A são os pesos (uma linha por canal de saída), B as linhas do im2col
+ * (uma por pixel de saída) ou o vetor de entrada da camada densa; as duas
+ * contíguas em k, então cada saída é um produto escalar. K, lda e ldb são
+ * múltiplos de LNP_GEMM_KALIGN (o modelo completa com zeros ao carregar),
+ * o que deixa os núcleos SIMD sem cauda em k.
+ *
+ * Implementações escalar, AVX2 e NEON numa tabela lnp_impl (lnp_cpu.h),
+ * escolhida uma vez por lnp_gemm_select(); em CPU com AVX-512 o despacho
+ * fica com a AVX2. Acumulação int32 módulo 2^32: todas dão os mesmos bits.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef LNP_GEMM_H
+#define LNP_GEMM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lnp_cpu.h"
+
+namespace lnp_eyes {
+
+#define LNP_GEMM_KALIGN 16
+
+typedef void (*GemmFn)(const int8_t *a, size_t lda, const int8_t *b, size_t ldb,
+                       int32_t *c, size_t ldc, size_t m, size_t n, size_t k);
+
+/* Melhor implementação dentro de isa_mask; *isa (pode ser NULL) recebe a escolhida */
+GemmFn lnp_gemm_select(uint32_t isa_mask, enum lnp_isa *isa);
+
+} // namespace lnp_eyes
+
+#endif // LNP_GEMM_H
@@ -0,0 +1,532 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_infer.cc — Linus Neural Project
+ *
+ * Carga do modelo .lnm, pool de threads e execução das camadas
+ * (lnp_infer.h). Os buffers de ativação e os rascunhos por thread são
+ * alocados uma vez em prepare(); classify() não aloca.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include "lnp_infer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+
+namespace lnp_eyes {
+
+/* Pixels de saída por bloco de convolução: 64 linhas de im2col de até 576 bytes na L1/L2 */
+#define CONV_TILE 64
+/* Camada densa dividida entre threads só acima disto (pesos em bytes) */
+#define DENSE_PARALLEL_MIN 65536
+#define DENSE_ROWS 64
+
+/* ---------- modelo ---------- */
+
+namespace {
+
+class Reader {
+public:
+    Reader(const uint8_t *data, size_t size) : p(data), left(size) {}
+
+    bool bytes(void *dst, size_t n) {
+        if (n > left)
+            return false;
+        memcpy(dst, p, n);
+        p += n;
+        left -= n;
+        return true;
+    }
+    bool u8(uint8_t &v) { return bytes(&v, 1); }
+    bool u16(uint16_t &v) {
+        uint8_t b[2];
+        if (!bytes(b, 2))
+            return false;
+        v = (uint16_t)(b[0] | b[1] << 8);
+        return true;
+    }
+    bool u32(uint32_t &v) {
+        uint8_t b[4];
+        if (!bytes(b, 4))
+            return false;
+        v = (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+        return true;
+    }
+    size_t remaining() const { return left; }
+
+private:
+    const uint8_t *p;
+    size_t left;
+};
+
+bool fail(string &err, const string &why) {
+    err = why;
+    return false;
+}
+
+} // namespace
+
+bool Model::load(const string &path, string &err) {
+    ifstream f(path, ios::binary);
+
+    if (!f)
+        return fail(err, "não foi possível abrir " + path);
+    vector<uint8_t> data((istreambuf_iterator<char>(f)), istreambuf_iterator<char>());
+    return parse(data.data(), data.size(), err);
+}
+
+bool Model::parse(const uint8_t *data, size_t size, string &err) {
+    Reader r(data, size);
+    char magic[4];
+    uint16_t version, count, w, h, c, classes;
+    uint32_t scale_bits, reserved;
+
+    if (!r.bytes(magic, 4) || memcmp(magic, "LNM1", 4))
+        return fail(err, "não é um modelo LNM1");
+    if (!r.u16(version) || !r.u16(count) || !r.u16(w) || !r.u16(h) || !r.u16(c) ||
+        !r.u16(classes) || !r.u32(scale_bits) || !r.u32(reserved))
+        return fail(err, "cabeçalho truncado");
+    if (version != 1)
+        return fail(err, "versão " + to_string(version) + " não suportada");
+    if (!count || count > 64 || !w || w > 1024 || !h || h > 1024 || (c != 1 && c != 3) ||
+        !classes || classes > 1000)
+        return fail(err, "cabeçalho inválido");
+    memcpy(&out_scale, &scale_bits, 4);
+    if (!(out_scale > 0) || !isfinite(out_scale))
+        return fail(err, "out_scale inválido");
+    in_w = w;
+    in_h = h;
+    in_c = c;
+
+    class_labels.clear();
+    for (unsigned i = 0; i < classes; i++) {
+        uint8_t len;
+        string s;
+
+        if (!r.u8(len))
+            return fail(err, "rótulos truncados");
+        s.resize(len);
+        if (!r.bytes(&s[0], len))
+            return fail(err, "rótulos truncados");
+        class_labels.push_back(s);
+    }
+
+    net.clear();
+    for (unsigned i = 0; i < count; i++) {
+        uint8_t hdr[8];
+        uint16_t cin, cout;
+        Layer l;
+        string at = "camada " + to_string(i) + ": ";
+
+        if (!r.bytes(hdr, 8) || !r.u16(cin) || !r.u16(cout))
+            return fail(err, at + "cabeçalho truncado");
+        l.type = (LayerType)hdr[0];
+        l.relu = hdr[1] & LNM_RELU;
+        l.k = hdr[2];
+        l.stride = hdr[3];
+        l.pad = hdr[4];
+        l.cin = cin;
+        l.cout = cout;
+        l.in_w = w;
+        l.in_h = h;
+        if (cin != c)
+            return fail(err, at + "cin não confere com a camada anterior");
+
+        switch (l.type) {
+        case LNM_CONV:
+            if (!l.k || l.k > 11 || !l.stride || l.stride > 4 || l.pad >= l.k || !cout ||
+                w + 2 * l.pad < l.k || h + 2 * l.pad < l.k)
+                return fail(err, at + "convolução inválida");
+            l.out_w = (w + 2 * l.pad - l.k) / l.stride + 1;
+            l.out_h = (h + 2 * l.pad - l.k) / l.stride + 1;
+            break;
+        case LNM_MAXPOOL2:
+            if (cout != cin || w < 2 || h < 2)
+                return fail(err, at + "maxpool inválido");
+            l.out_w = w / 2;
+            l.out_h = h / 2;
+            break;
+        case LNM_AVGPOOL:
+            if (cout != cin)
+                return fail(err, at + "avgpool inválido");
+            l.out_w = l.out_h = 1;
+            break;
+        case LNM_DENSE:
+            if (l.k != 1 || !cout || w != 1 || h != 1)
+                return fail(err, at + "densa inválida (entrada deve ser 1x1xC)");
+            l.out_w = l.out_h = 1;
+            break;
+        default:
+            return fail(err, at + "tipo " + to_string(hdr[0]) + " desconhecido");
+        }
+
+        if (l.type == LNM_CONV || l.type == LNM_DENSE) {
+            size_t kk = (size_t)l.k * l.k * cin;
+
+            l.kdim = (kk + LNP_GEMM_KALIGN - 1) / LNP_GEMM_KALIGN * LNP_GEMM_KALIGN;
+            l.weight.assign((size_t)cout * l.kdim, 0);
+            for (unsigned m = 0; m < cout; m++)
+                if (!r.bytes(&l.weight[m * l.kdim], kk))
+                    return fail(err, at + "pesos truncados");
+            l.bias.resize(cout);
+            l.mult.resize(cout);
+            l.shift.resize(cout);
+            for (unsigned m = 0; m < cout; m++)
+                if (!r.u32((uint32_t &)l.bias[m]))
+                    return fail(err, at + "bias truncado");
+            for (unsigned m = 0; m < cout; m++)
+                if (!r.u32((uint32_t &)l.mult[m]) || l.mult[m] < (1 << 30))
+                    return fail(err, at + "mult ausente ou fora de [2^30, 2^31)");
+            if (!r.bytes(l.shift.data(), cout))
+                return fail(err, at + "shift truncado");
+            for (unsigned m = 0; m < cout; m++)
+                if (l.shift[m] > 31)
+                    return fail(err, at + "shift acima de 31");
+        }
+        w = (uint16_t)l.out_w;
+        h = (uint16_t)l.out_h;
+        c = cout;
+        net.push_back(move(l));
+    }
+    if (w != 1 || h != 1 || c != classes)
+        return fail(err, "a última camada deve dar 1x1xclass_count");
+    if (r.remaining())
+        return fail(err, "bytes sobrando no fim do modelo");
+    return true;
+}
+
+/* ---------- threads ---------- */
+
+ThreadPool::ThreadPool(unsigned threads) {
+    for (unsigned i = 1; i < threads; i++)
+        workers.emplace_back(&ThreadPool::workerMain, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lk(lock);
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto &t : workers)
+        t.join();
+}
+
+void ThreadPool::runItems(unsigned id) {
+    for (;;) {
+        size_t i;
+        {
+            lock_guard<mutex> lk(lock);
+            if (next >= job_n)
+                return;
+            i = next++;
+        }
+        (*job)(i, id);
+    }
+}
+
+void ThreadPool::workerMain(unsigned id) {
+    uint64_t seen = 0;
+
+    for (;;) {
+        {
+            unique_lock<mutex> lk(lock);
+            wake.wait(lk, [&] { return stop || generation != seen; });
+            if (stop)
+                return;
+            seen = generation;
+        }
+        runItems(id);
+        lock_guard<mutex> lk(lock);
+        if (--busy == 0)
+            idle.notify_one();
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, const function<void(size_t, unsigned)> &fn) {
+    if (workers.empty() || n <= 1) {
+        for (size_t i = 0; i < n; i++)
+            fn(i, 0);
+        return;
+    }
+    {
+        lock_guard<mutex> lk(lock);
+        job = &fn;
+        job_n = n;
+        next = 0;
+        busy = (unsigned)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+    runItems(0);
+    unique_lock<mutex> lk(lock);
+    idle.wait(lk, [&] { return busy == 0; });
+    job = nullptr;
+}
+
+/* ---------- motor ---------- */
+
+static inline int8_t requant(int32_t acc, const Layer &l, unsigned m) {
+    int32_t x = (int32_t)((uint32_t)acc + (uint32_t)l.bias[m]);
+    int s = 31 + l.shift[m];
+    int64_t v = ((int64_t)x * l.mult[m] + ((int64_t)1 << (s - 1))) >> s;
+    int64_t lo = l.relu ? 0 : -128;
+
+    return (int8_t)(v < lo ? lo : v > 127 ? 127 : v);
+}
+
+static unsigned default_threads(unsigned threads) {
+    unsigned n = threads ? threads : thread::hardware_concurrency();
+
+    return n ? n : 1;
+}
+
+static uint32_t detected_isa(uint32_t mask) {
+    struct lnp_cpu_info ci;
+
+    lnp_cpu_detect(&ci);
+    return ci.isa & mask;
+}
+
+Engine::Engine(unsigned threads, uint32_t isa_mask)
+    : pool(default_threads(threads)) {
+    gemm = lnp_gemm_select(detected_isa(isa_mask), &gemm_isa);
+}
+
+bool Engine::load(const string &path, string &err) {
+    lock_guard<mutex> lk(run_lock);
+
+    if (!net.load(path, err))
+        return false;
+    prepare();
+    return true;
+}
+
+bool Engine::loadFromMemory(const uint8_t *data, size_t size, string &err) {
+    lock_guard<mutex> lk(run_lock);
+
+    if (!net.parse(data, size, err))
+        return false;
+    prepare();
+    return true;
+}
+
+void Engine::prepare() {
+    size_t act_max = (size_t)net.inWidth() * net.inHeight() * net.inChannels();
+    size_t kdim_max = LNP_GEMM_KALIGN, cout_max = 1;
+
+    for (const Layer &l : net.layers()) {
+        act_max = max(act_max, (size_t)l.out_w * l.out_h * l.cout);
+        if (l.type == LNM_CONV || l.type == LNM_DENSE) {
+            kdim_max = max(kdim_max, l.kdim);
+            cout_max = max(cout_max, (size_t)l.cout);
+        }
+    }
+    act[0].assign(act_max, 0);
+    act[1].assign(act_max, 0);
+    col.assign(pool.size(), vector<int8_t>(CONV_TILE * kdim_max));
+    acc.assign(pool.size(), vector<int32_t>(CONV_TILE * cout_max));
+    resetStats();
+}
+
+void Engine::resetStats() {
+    lock_guard<mutex> lk(stats_lock);
+
+    window.assign(STATS_WINDOW, 0);
+    frames = 0;
+    total_ms = last_ms = 0;
+}
+
+/* Média de área para in_w x in_h, convertendo canais; uma linha de saída por item */
+void Engine::resizeInput(const uint8_t *pixels, int w, int h, size_t stride, PixelFormat fmt) {
+    int ow = net.inWidth(), oh = net.inHeight(), oc = net.inChannels(), bpp = (int)fmt;
+    int8_t *out = act[0].data();
+
+    pool.parallelFor(oh, [&](size_t oy, unsigned) {
+        int y0 = (int)(oy * h / oh), y1 = max(y0 + 1, (int)((oy + 1) * h / oh));
+
+        for (int ox = 0; ox < ow; ox++) {
+            int x0 = ox * w / ow, x1 = max(x0 + 1, (ox + 1) * w / ow);
+            uint32_t sum[3] = { 0, 0, 0 }, n = (uint32_t)((x1 - x0) * (y1 - y0));
+
+            for (int y = y0; y < y1; y++) {
+                const uint8_t *p = pixels + y * stride + (size_t)x0 * bpp;
+
+                for (int x = x0; x < x1; x++, p += bpp) {
+                    if (bpp == 1) {
+                        sum[0] += p[0];
+                    } else if (oc == 1) {
+                        sum[0] += (p[0] * 77 + p[1] * 150 + p[2] * 29) >> 8;
+                    } else {
+                        sum[0] += p[0];
+                        sum[1] += p[1];
+                        sum[2] += p[2];
+                    }
+                }
+            }
+            for (int ch = 0; ch < oc; ch++) {
+                uint32_t v = (sum[bpp == 1 ? 0 : ch] + n / 2) / n;
+
+                out[(oy * ow + ox) * oc + ch] = (int8_t)((int)v - 128);
+            }
+        }
+    });
+}
+
+void Engine::runConv(const Layer &l, const int8_t *in, int8_t *out) {
+    size_t npix = (size_t)l.out_w * l.out_h, kk = (size_t)l.k * l.k * l.cin;
+    size_t tiles = (npix + CONV_TILE - 1) / CONV_TILE;
+
+    pool.parallelFor(tiles, [&](size_t t, unsigned worker) {
+        size_t n0 = t * CONV_TILE, nn = min((size_t)CONV_TILE, npix - n0);
+        int8_t *cb = col[worker].data();
+        int32_t *cacc = acc[worker].data();
+
+        for (size_t j = 0; j < nn; j++) {
+            int oy = (int)((n0 + j) / l.out_w), ox = (int)((n0 + j) % l.out_w);
+            int8_t *row = cb + j * l.kdim;
+
+            for (int ky = 0; ky < l.k; ky++) {
+                int iy = oy * l.stride - l.pad + ky;
+
+                for (int kx = 0; kx < l.k; kx++, row += l.cin) {
+                    int ix = ox * l.stride - l.pad + kx;
+
+                    if (iy < 0 || iy >= l.in_h || ix < 0 || ix >= l.in_w)
+                        memset(row, 0, l.cin);
+                    else
+                        memcpy(row, in + ((size_t)iy * l.in_w + ix) * l.cin, l.cin);
+                }
+            }
+            memset(row, 0, l.kdim - kk);
+        }
+        gemm(l.weight.data(), l.kdim, cb, l.kdim, cacc, l.cout, l.cout, nn, l.kdim);
+        for (size_t j = 0; j < nn; j++)
+            for (int m = 0; m < l.cout; m++)
+                out[(n0 + j) * l.cout + m] = requant(cacc[j * l.cout + m], l, m);
+    });
+}
+
+void Engine::runDense(const Layer &l, const int8_t *in, int8_t *out, unsigned worker) {
+    int8_t *x = col[worker].data();
+    int32_t *cacc = acc[worker].data();
+    size_t rows = (l.cout + DENSE_ROWS - 1) / DENSE_ROWS;
+
+    memcpy(x, in, l.cin);
+    memset(x + l.cin, 0, l.kdim - l.cin);
+    auto run = [&](size_t b, unsigned) {
+        size_t m0 = b * DENSE_ROWS, mm = min((size_t)DENSE_ROWS, (size_t)l.cout - m0);
+
+        gemm(l.weight.data() + m0 * l.kdim, l.kdim, x, l.kdim, cacc + m0, l.cout, mm, 1, l.kdim);
+    };
+    if ((size_t)l.cout * l.kdim >= DENSE_PARALLEL_MIN)
+        pool.parallelFor(rows, run);
+    else
+        for (size_t b = 0; b < rows; b++)
+            run(b, worker);
+    for (int m = 0; m < l.cout; m++)
+        out[m] = requant(cacc[m], l, m);
+}
+
+static void maxpool2(const Layer &l, const int8_t *in, int8_t *out) {
+    for (int oy = 0; oy < l.out_h; oy++)
+        for (int ox = 0; ox < l.out_w; ox++) {
+            const int8_t *p = in + ((size_t)2 * oy * l.in_w + 2 * ox) * l.cin;
+            const int8_t *q = p + (size_t)l.in_w * l.cin;
+            int8_t *o = out + ((size_t)oy * l.out_w + ox) * l.cout;
+
+            for (int ch = 0; ch < l.cin; ch++)
+                o[ch] = max(max(p[ch], p[ch + l.cin]), max(q[ch], q[ch + l.cin]));
+        }
+}
+
+static void avgpool(const Layer &l, const int8_t *in, int8_t *out) {
+    int32_t n = l.in_w * l.in_h;
+
+    for (int ch = 0; ch < l.cin; ch++) {
+        int32_t sum = 0;
+
+        for (int i = 0; i < n; i++)
+            sum += in[(size_t)i * l.cin + ch];
+        out[ch] = (int8_t)((sum + (sum >= 0 ? n / 2 : -n / 2)) / n);
+    }
+}
+
+Result Engine::classify(const uint8_t *pixels, int w, int h, size_t stride, PixelFormat fmt) {
+    lock_guard<mutex> lk(run_lock);
+    auto t0 = chrono::steady_clock::now();
+    unsigned cur = 0;
+    Result res = { -1, 0.0f, 0.0 };
+
+    if (net.layers().empty() || w <= 0 || h <= 0)
+        return res;
+    resizeInput(pixels, w, h, stride, fmt);
+    for (const Layer &l : net.layers()) {
+        const int8_t *in = act[cur].data();
+        int8_t *out = act[cur ^ 1].data();
+
+        switch (l.type) {
+        case LNM_CONV: runConv(l, in, out); break;
+        case LNM_MAXPOOL2: maxpool2(l, in, out); break;
+        case LNM_AVGPOOL: avgpool(l, in, out); break;
+        case LNM_DENSE: runDense(l, in, out, 0); break;
+        }
+        cur ^= 1;
+    }
+
+    /* softmax dos logits int8 na escala real; só a classe vencedora importa */
+    const int8_t *logit = act[cur].data();
+    int classes = (int)net.labels().size(), best = 0;
+    float denom = 0;
+
+    for (int i = 1; i < classes; i++)
+        if (logit[i] > logit[best])
+            best = i;
+    for (int i = 0; i < classes; i++)
+        denom += expf((logit[i] - logit[best]) * net.outScale());
+    res.label = best;
+    res.confidence = 1.0f / denom;
+    res.latency_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    record(res.latency_ms);
+    return res;
+}
+
+void Engine::record(double ms) {
+    lock_guard<mutex> lk(stats_lock);
+
+    if (!frames)
+        first_start = chrono::steady_clock::now() -
+                      chrono::duration_cast<chrono::steady_clock::duration>(
+                          chrono::duration<double, milli>(ms));
+    window[frames % STATS_WINDOW] = ms;
+    frames++;
+    total_ms += ms;
+    last_ms = ms;
+}
+
+Stats Engine::stats() const {
+    lock_guard<mutex> lk(stats_lock);
+    Stats st = { frames, last_ms, 0, 0, 0, 0 };
+    size_t n = min((size_t)frames, STATS_WINDOW);
+
+    if (!n)
+        return st;
+    vector<double> v(window.begin(), window.begin() + n);
+    sort(v.begin(), v.end());
+    st.mean_ms = total_ms / frames;
+    st.p50_ms = v[n / 2];
+    st.p99_ms = v[min(n - 1, n * 99 / 100)];
+    /* vazão real: inclui o tempo entre quadros, não só o de classify() */
+    double wall_s = chrono::duration<double>(chrono::steady_clock::now() - first_start).count();
+    st.fps = wall_s > 0 ? frames / wall_s : 0;
+    return st;
+}
+
+} // namespace lnp_eyes
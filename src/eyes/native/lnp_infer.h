@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_infer.h — Linus Neural Project
+ *
+ * Motor de inferência int8 para classificação de quadros na CPU, sem GPU.
+ * É o que ia.processFrame chama por JNI (ia_jni.cc); lnp_infer_bench mede
+ * e confere o mesmo código fora da JVM.
+ *
+ * Quantização simétrica, ponto zero 0: ativações int8 (pixel - 128 na
+ * entrada), pesos int8 por canal de saída e acumulação int32. Cada canal
+ * volta a int8 por (acc + bias) * mult / 2^(31 + shift), com arredondamento,
+ * saturação e ReLU opcional. Convolução = im2col + GEMM (lnp_gemm.h), com os
+ * pixels de saída repartidos entre as threads em blocos de CONV_TILE.
+ *
+ * Formato do modelo (.lnm), little-endian, sem alinhamento:
+ *
+ *   cabeçalho, 24 bytes
+ *     char     magic[4]        "LNM1"
+ *     u16      version         1
+ *     u16      layer_count
+ *     u16      in_w, in_h, in_c   entrada HWC; in_c = 1 (cinza) ou 3 (RGB)
+ *     u16      class_count
+ *     f32      out_scale       valor real de 1 unidade da saída int8 final
+ *     u32      reserved        0
+ *   class_count rótulos: u8 len, len bytes UTF-8
+ *   layer_count camadas, cada uma com 12 bytes de cabeçalho
+ *     u8       type            LNM_CONV, LNM_MAXPOOL2, LNM_AVGPOOL, LNM_DENSE
+ *     u8       flags           LNM_RELU
+ *     u8       k, stride, pad  só LNM_CONV; LNM_DENSE usa k = 1
+ *     u8       reserved[3]
+ *     u16      cin, cout       LNM_MAXPOOL2/LNM_AVGPOOL: cout = cin
+ *   e, para LNM_CONV e LNM_DENSE:
+ *     s8       weight[cout][k][k][cin]
+ *     s32      bias[cout]      na escala do acumulador
+ *     s32      mult[cout]      Q31, em [2^30, 2^31)
+ *     u8       shift[cout]     0..31
+ *
+ * A última camada deve ter cout = class_count; a confiança é o softmax da
+ * saída multiplicada por out_scale.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef LNP_INFER_H
+#define LNP_INFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lnp_gemm.h"
+
+namespace lnp_eyes {
+
+enum LayerType { LNM_CONV = 1, LNM_MAXPOOL2 = 2, LNM_AVGPOOL = 3, LNM_DENSE = 4 };
+
+#define LNM_RELU 0x01
+
+/* Formatos de pixel dos quadros; o valor é o número de bytes por pixel */
+enum PixelFormat { PIXEL_GRAY8 = 1, PIXEL_RGB888 = 3, PIXEL_RGBA8888 = 4 };
+
+struct Layer {
+    LayerType type;
+    bool relu;
+    int k, stride, pad;
+    int cin, cout;
+    int in_w, in_h, out_w, out_h;   // calculados ao carregar
+    size_t kdim;                    // k * k * cin, completado até LNP_GEMM_KALIGN
+    std::vector<int8_t> weight;     // [cout][kdim]
+    std::vector<int32_t> bias, mult;
+    std::vector<uint8_t> shift;
+};
+
+class Model {
+public:
+    /* false com a causa em err: arquivo ausente, truncado ou inconsistente */
+    bool load(const std::string &path, std::string &err);
+    bool parse(const uint8_t *data, size_t size, std::string &err);
+
+    int inWidth() const { return in_w; }
+    int inHeight() const { return in_h; }
+    int inChannels() const { return in_c; }
+    float outScale() const { return out_scale; }
+    const std::vector<std::string> &labels() const { return class_labels; }
+    const std::vector<Layer> &layers() const { return net; }
+
+private:
+    int in_w = 0, in_h = 0, in_c = 0;
+    float out_scale = 1.0f;
+    std::vector<std::string> class_labels;
+    std::vector<Layer> net;
+};
+
+/* Threads fixas; parallelFor reparte [0, n) e a thread que chama também trabalha */
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+    unsigned size() const { return (unsigned)workers.size() + 1; }
+    /* fn(i, worker), worker em [0, size()) identifica o rascunho da thread */
+    void parallelFor(size_t n, const std::function<void(size_t, unsigned)> &fn);
+
+private:
+    void workerMain(unsigned id);
+    void runItems(unsigned id);
+
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable wake, idle;
+    const std::function<void(size_t, unsigned)> *job = nullptr;
+    size_t job_n = 0, next = 0;
+    unsigned busy = 0;
+    uint64_t generation = 0;
+    bool stop = false;
+};
+
+struct Result {
+    int label;              // índice em Model::labels()
+    float confidence;       // 0..1
+    double latency_ms;
+};
+
+struct Stats {
+    uint64_t frames;
+    double last_ms, mean_ms, p50_ms, p99_ms;    // percentis das últimas STATS_WINDOW
+    double fps;                                 // quadros / tempo de relógio desde o início do primeiro
+};
+
+class Engine {
+public:
+    /* threads = 0: uma por CPU online; isa_mask restringe o despacho (testes) */
+    explicit Engine(unsigned threads = 0, uint32_t isa_mask = ~0U);
+
+    bool load(const std::string &path, std::string &err);
+    bool loadFromMemory(const uint8_t *data, size_t size, std::string &err);
+    const Model &model() const { return net; }
+
+    /*
+     * Quadro HWC de w x h pixels, stride bytes por linha, redimensionado
+     * (média de área) para a entrada do modelo. Serializado por um mutex:
+     * os rascunhos são do motor, não da chamada.
+     */
+    Result classify(const uint8_t *pixels, int w, int h, size_t stride, PixelFormat fmt);
+
+    Stats stats() const;
+    void resetStats();
+    enum lnp_isa isa() const { return gemm_isa; }
+    unsigned threads() const { return pool.size(); }
+
+private:
+    static const size_t STATS_WINDOW = 1024;
+
+    void prepare();
+    void resizeInput(const uint8_t *pixels, int w, int h, size_t stride, PixelFormat fmt);
+    void runConv(const Layer &l, const int8_t *in, int8_t *out);
+    void runDense(const Layer &l, const int8_t *in, int8_t *out, unsigned worker);
+    void record(double ms);
+
+    Model net;
+    ThreadPool pool;
+    GemmFn gemm;
+    enum lnp_isa gemm_isa;
+    std::mutex run_lock;
+    std::vector<int8_t> act[2];                 // ativações, alternando entre camadas
+    std::vector<std::vector<int8_t>> col;       // im2col por thread
+    std::vector<std::vector<int32_t>> acc;      // saída do GEMM por thread
+
+    mutable std::mutex stats_lock;
+    std::vector<double> window;
+    uint64_t frames = 0;
+    double total_ms = 0, last_ms = 0;
+    std::chrono::steady_clock::time_point first_start;   // início do primeiro quadro após resetStats
+};
+
+} // namespace lnp_eyes
+
+#endif // LNP_INFER_H
@@ -0,0 +1,297 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * lnp_infer_bench.cc — Linus Neural Project
+ *
+ * Confere e mede o motor de inferência fora da JVM:
+ *   ./lnp_infer_bench [-m MODELO.lnm] [-n QUADROS] [-t THREADS] [-s LxA] > run.ndjson
+ *   ./lnp_infer_bench -w eyes.lnm [-i LADO]
+ *
+ * Sem -m usa o modelo sintético que -w grava: a rede padrão (4 convoluções
+ * 3x3, dois maxpool, avgpool e densa para os 7 rótulos de ia.java) com
+ * pesos pseudoaleatórios e escalas que mantêm as ativações na faixa int8.
+ * Serve para medir e para testar o caminho JNI; os pesos treinados vêm do
+ * exportador do modelo, no mesmo formato (lnp_infer.h).
+ *
+ * Antes de medir: cada GEMM que a CPU executa é comparado com o escalar em
+ * tamanhos com sobras em m e n, e a rede inteira precisa dar o mesmo
+ * rótulo e a mesma confiança com o despacho escalar e com o melhor, com 1
+ * e com N threads. Falha sai com código 1. Resultados em NDJSON, no
+ * formato do `TestingSystem --bench`, e tabela em stderr.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lnp_infer.h"
+
+using namespace std;
+using namespace lnp_eyes;
+
+static const char *const default_labels[] = {
+    "humano", "cachorro", "computador", "árvore", "celular", "luz forte", "movimento rápido"
+};
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ULL;
+
+static uint32_t rng() {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (uint32_t)((rng_state * 0x2545f4914f6cdd1dULL) >> 32);
+}
+
+static void bench_record(const char *name, unsigned threads, double value, const char *unit,
+                         const char *better) {
+    printf("{\"bench\":\"%s\",\"threads\":%u,\"value\":%.3f,\"unit\":\"%s\",\"better\":\"%s\"}\n",
+           name, threads, value, unit, better);
+    fflush(stdout);
+    fprintf(stderr, "  %-24s x%-3u %12.3f %s\n", name, threads, value, unit);
+}
+
+#define CHECK(cond, msg) do { if (!(cond)) { fprintf(stderr, "check failed: %s\n", msg); return 1; } } while (0)
+
+/* ---------- modelo sintético ---------- */
+
+class Writer {
+public:
+    vector<uint8_t> out;
+
+    void u8(unsigned v) { out.push_back((uint8_t)v); }
+    void u16(unsigned v) { u8(v & 0xff); u8(v >> 8); }
+    void u32(uint32_t v) { u16(v & 0xffff); u16(v >> 16); }
+    void bytes(const void *p, size_t n) {
+        out.insert(out.end(), (const uint8_t *)p, (const uint8_t *)p + n);
+    }
+};
+
+/* Camada com pesos em [-64, 64]; escala de saída para desvio ~32 em int8 */
+static void write_layer(Writer &wr, LayerType type, bool relu, int k, int stride, int pad,
+                        int cin, int cout) {
+    wr.u8(type);
+    wr.u8(relu ? LNM_RELU : 0);
+    wr.u8(k);
+    wr.u8(stride);
+    wr.u8(pad);
+    wr.u8(0);
+    wr.u8(0);
+    wr.u8(0);
+    wr.u16(cin);
+    wr.u16(cout);
+    if (type != LNM_CONV && type != LNM_DENSE)
+        return;
+
+    size_t kk = (size_t)k * k * cin;
+    double scale = 32.0 / (sqrt((double)kk) * 37.0 * 40.0);
+    int e;
+    double frac = frexp(scale, &e);             /* scale = frac * 2^e, frac em [0.5, 1) */
+    uint32_t mult = (uint32_t)llround(frac * 2147483648.0);
+    int shift = -e;
+
+    if (mult == 0x80000000U) {
+        mult >>= 1;
+        shift--;
+    }
+    for (size_t i = 0; i < (size_t)cout * kk; i++)
+        wr.u8((uint8_t)(int8_t)((int)(rng() % 129) - 64));
+    for (int m = 0; m < cout; m++)
+        wr.u32((uint32_t)((int)(rng() % 4001) - 2000));
+    for (int m = 0; m < cout; m++)
+        wr.u32(mult);
+    for (int m = 0; m < cout; m++)
+        wr.u8(shift < 0 ? 0 : shift > 31 ? 31 : shift);
+}
+
+static vector<uint8_t> synth_model(int side) {
+    Writer wr;
+    float out_scale = 0.125f;
+    uint32_t bits;
+    size_t classes = sizeof(default_labels) / sizeof(default_labels[0]);
+
+    wr.bytes("LNM1", 4);
+    wr.u16(1);
+    wr.u16(8);
+    wr.u16(side);
+    wr.u16(side);
+    wr.u16(3);
+    wr.u16(classes);
+    memcpy(&bits, &out_scale, 4);
+    wr.u32(bits);
+    wr.u32(0);
+    for (size_t i = 0; i < classes; i++) {
+        wr.u8(strlen(default_labels[i]));
+        wr.bytes(default_labels[i], strlen(default_labels[i]));
+    }
+    write_layer(wr, LNM_CONV, true, 3, 2, 1, 3, 16);
+    write_layer(wr, LNM_CONV, true, 3, 1, 1, 16, 32);
+    write_layer(wr, LNM_MAXPOOL2, false, 0, 0, 0, 32, 32);
+    write_layer(wr, LNM_CONV, true, 3, 1, 1, 32, 64);
+    write_layer(wr, LNM_MAXPOOL2, false, 0, 0, 0, 64, 64);
+    write_layer(wr, LNM_CONV, true, 3, 1, 1, 64, 64);
+    write_layer(wr, LNM_AVGPOOL, false, 0, 0, 0, 64, 64);
+    write_layer(wr, LNM_DENSE, false, 1, 1, 0, 64, classes);
+    return wr.out;
+}
+
+/* Quadro RGB de câmera simulado: gradiente, um objeto claro e ruído */
+static vector<uint8_t> synth_frame(int w, int h, unsigned seed) {
+    vector<uint8_t> px((size_t)w * h * 3);
+    int cx = (int)(seed * 7919 % w), cy = (int)(seed * 104729 % h);
+
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++) {
+            uint8_t *p = &px[((size_t)y * w + x) * 3];
+            int d = abs(x - cx) + abs(y - cy), v = d < h / 6 ? 220 : (x + y) * 160 / (w + h);
+
+            p[0] = (uint8_t)min(255, v + (int)(rng() & 15));
+            p[1] = (uint8_t)min(255, v * 3 / 4 + (int)(rng() & 15));
+            p[2] = (uint8_t)min(255, v / 2 + (int)(rng() & 15));
+        }
+    return px;
+}
+
+/* ---------- conferência ---------- */
+
+static int check_gemm(uint32_t isa_mask) {
+    static const size_t ms[] = { 1, 2, 3, 7, 16, 64, 65, 130 };
+    static const size_t ns[] = { 1, 3, 4, 5, 9, 64 };
+    static const size_t ks[] = { 16, 32, 48, 576 };
+    GemmFn ref = lnp_gemm_select(0, nullptr);
+    enum lnp_isa isa;
+    GemmFn fn = lnp_gemm_select(isa_mask, &isa);
+
+    for (size_t k : ks)
+        for (size_t m : ms)
+            for (size_t n : ns) {
+                vector<int8_t> a(m * k), b(n * k);
+                vector<int32_t> c0(n * m), c1(n * m, -1);
+
+                for (auto &v : a)
+                    v = (int8_t)rng();
+                for (auto &v : b)
+                    v = (int8_t)rng();
+                ref(a.data(), k, b.data(), k, c0.data(), m, m, n, k);
+                fn(a.data(), k, b.data(), k, c1.data(), m, m, n, k);
+                CHECK(c0 == c1, "gemm matches scalar");
+            }
+    fprintf(stderr, "lnp_infer_bench: gemm %s ok\n", lnp_isa_name(isa));
+    return 0;
+}
+
+static int check_engine(const vector<uint8_t> &model, unsigned threads) {
+    Engine ref(1, LNP_ISA_BIT(LNP_ISA_SCALAR)), fast(threads);
+    string err;
+
+    CHECK(ref.loadFromMemory(model.data(), model.size(), err), err.c_str());
+    CHECK(fast.loadFromMemory(model.data(), model.size(), err), err.c_str());
+    for (unsigned f = 0; f < 8; f++) {
+        int w = 160 + 37 * f, h = 120 + 23 * f;
+        vector<uint8_t> px = synth_frame(w, h, f + 1);
+        Result a = ref.classify(px.data(), w, h, (size_t)w * 3, PIXEL_RGB888);
+        Result b = fast.classify(px.data(), w, h, (size_t)w * 3, PIXEL_RGB888);
+
+        CHECK(a.label >= 0 && a.label == b.label && a.confidence == b.confidence,
+              "scalar and dispatched engines agree");
+    }
+    vector<uint8_t> cut(model.begin(), model.end() - 1);
+    CHECK(!ref.loadFromMemory(cut.data(), cut.size(), err), "truncated model rejected");
+    return 0;
+}
+
+/* ---------- medição ---------- */
+
+static void bench_engine(const vector<uint8_t> &model, uint32_t isa_mask, unsigned threads,
+                         int frames, int w, int h) {
+    Engine eng(threads, isa_mask);
+    string err;
+    char name[48];
+    vector<uint8_t> px = synth_frame(w, h, 42);
+
+    eng.loadFromMemory(model.data(), model.size(), err);
+    for (int i = 0; i < 3; i++)             /* aquece caches e threads */
+        eng.classify(px.data(), w, h, (size_t)w * 3, PIXEL_RGB888);
+    eng.resetStats();
+    for (int i = 0; i < frames; i++)
+        eng.classify(px.data(), w, h, (size_t)w * 3, PIXEL_RGB888);
+
+    Stats st = eng.stats();
+    snprintf(name, sizeof(name), "eyes.infer.%s", lnp_isa_name(eng.isa()));
+    bench_record(name, eng.threads(), st.mean_ms, "ms", "lower");
+    snprintf(name, sizeof(name), "eyes.infer.%s.p99", lnp_isa_name(eng.isa()));
+    bench_record(name, eng.threads(), st.p99_ms, "ms", "lower");
+    snprintf(name, sizeof(name), "eyes.infer.%s.fps", lnp_isa_name(eng.isa()));
+    bench_record(name, eng.threads(), st.fps, "frames/s", "higher");
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-m MODEL.lnm] [-n FRAMES] [-t THREADS] [-s WxH]\n"
+                    "       %s -w OUT.lnm [-i SIDE]\n", prog, prog);
+}
+
+int main(int argc, char **argv) {
+    const char *model_path = nullptr, *write_path = nullptr;
+    int frames = 200, side = 64, w = 640, h = 480, opt;
+    unsigned threads = thread::hardware_concurrency();
+    struct lnp_cpu_info ci;
+    vector<uint8_t> model;
+
+    while ((opt = getopt(argc, argv, "m:w:i:n:t:s:h")) != -1) {
+        switch (opt) {
+        case 'm': model_path = optarg; break;
+        case 'w': write_path = optarg; break;
+        case 'i': side = atoi(optarg); break;
+        case 'n': frames = atoi(optarg); break;
+        case 't': threads = (unsigned)atoi(optarg); break;
+        case 's':
+            if (sscanf(optarg, "%dx%d", &w, &h) != 2)
+                w = 0;
+            break;
+        default: usage(argv[0]); return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (side < 8 || side > 1024 || frames < 1 || w < 1 || h < 1 || threads < 1 || threads > 256) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (write_path) {
+        model = synth_model(side);
+        ofstream f(write_path, ios::binary);
+        f.write((const char *)model.data(), model.size());
+        if (!f) {
+            fprintf(stderr, "%s: cannot write %s\n", argv[0], write_path);
+            return 1;
+        }
+        fprintf(stderr, "%s: %zu bytes, %dx%dx3 -> %zu classes\n", write_path, model.size(),
+                side, side, sizeof(default_labels) / sizeof(default_labels[0]));
+        return 0;
+    }
+    if (model_path) {
+        ifstream f(model_path, ios::binary);
+        model.assign(istreambuf_iterator<char>(f), istreambuf_iterator<char>());
+    } else {
+        model = synth_model(side);
+    }
+
+    lnp_cpu_detect(&ci);
+    if (check_gemm(ci.isa) || check_engine(model, threads))
+        return 1;
+
+    fprintf(stderr, "lnp_infer_bench: %d frames of %dx%d on %s (%uC/%uT)\n", frames, w, h,
+            ci.model[0] ? ci.model : ci.vendor, ci.cores, ci.threads);
+    bench_engine(model, LNP_ISA_BIT(LNP_ISA_SCALAR), 1, frames, w, h);
+    bench_engine(model, ~0U, 1, frames, w, h);
+    if (threads > 1)
+        bench_engine(model, ~0U, threads, frames, w, h);
+    return 0;
+}
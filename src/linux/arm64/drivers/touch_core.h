@@ -0,0 +1,265 @@
+// SPDX-License-Identifier: GPL-2.0 OR MIT
+/*
+ * touch_core.h — Simulação portátil de toques multitouch
+ *
+ * Usado pelo touchscreen.c e, via lnp_kshim.h (src/drivers), pela
+ * biblioteca user-space de benchmarks em src/drivers/user.
+ *
+ * Cada contato tem trajetória suave: posição em ponto fixo Q8, velocidade
+ * em px/s e aceleração constante em px/s², quicando nas bordas, com
+ * pressão em passeio aleatório e duração limitada. Novos toques surgem
+ * em média LN_TOUCH_SPAWN_HZ vezes por segundo, independente da taxa.
+ * Tudo em inteiros e sem alocação: roda no callback do hrtimer.
+ *
+ * Também define o formato dos traços gravados (.lntt) e o avanço quadro a
+ * quadro do replay, para que o driver e as ferramentas em src/drivers/user
+ * validem e reproduzam os traços com o mesmo código.
+ *
+ * Copyright (c) 2025 Linus Neural Project
+ */
+
+#ifndef LN_TOUCH_CORE_H
+#define LN_TOUCH_CORE_H
+
+#ifdef __KERNEL__
+#include <linux/types.h>
+#include <linux/random.h>
+#include <linux/string.h>
+#include <linux/math64.h>
+#include <linux/errno.h>
+#include <asm/byteorder.h>
+#else
+#include "lnp_kshim.h"
+#endif
+
+#define LN_TOUCH_MAX_X        1080
+#define LN_TOUCH_MAX_Y        2400
+#define LN_TOUCH_MAX_PRESSURE 255
+
+#define LN_TOUCH_MAX_CONTACTS 10
+#define LN_TOUCH_RATE_MIN     120       /* Hz */
+#define LN_TOUCH_RATE_MAX     480
+#define LN_TOUCH_SPAWN_HZ     3         /* toques novos por segundo, em média */
+
+struct ln_touch_contact {
+    bool active;
+    s32 x, y;           /* posição, Q8 px */
+    s32 vx, vy;         /* velocidade, px/s */
+    s32 ax, ay;         /* aceleração, px/s² */
+    s32 pressure;
+    u32 ttl_us;         /* tempo até soltar o dedo */
+};
+
+struct ln_touch_sim {
+    struct ln_touch_contact c[LN_TOUCH_MAX_CONTACTS];
+    u32 rng;            /* xorshift32: barato o bastante para cada quadro */
+};
+
+static inline u32 ln_touch_rand(struct ln_touch_sim *s)
+{
+    u32 x = s->rng;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s->rng = x;
+    return x;
+}
+
+/* Valor uniforme em [lo, hi] */
+static inline s32 ln_touch_range(struct ln_touch_sim *s, s32 lo, s32 hi)
+{
+    return lo + (s32)(ln_touch_rand(s) % (u32)(hi - lo + 1));
+}
+
+static inline void ln_touch_sim_init(struct ln_touch_sim *s)
+{
+    memset(s, 0, sizeof(*s));
+    get_random_bytes(&s->rng, sizeof(s->rng));
+    if (!s->rng)
+        s->rng = 0x2025;
+}
+
+/* Reflete a coordenada nas bordas [0, max] invertendo a velocidade */
+static inline void ln_touch_bounce(s32 *pos, s32 *vel, s32 max)
+{
+    if (*pos < 0) {
+        *pos = -*pos;
+        *vel = -*vel;
+    } else if (*pos > (max << 8)) {
+        *pos = 2 * (max << 8) - *pos;
+        *vel = -*vel;
+    }
+}
+
+static inline void ln_touch_spawn(struct ln_touch_sim *s, struct ln_touch_contact *c)
+{
+    c->active = true;
+    c->x = ln_touch_range(s, 0, LN_TOUCH_MAX_X) << 8;
+    c->y = ln_touch_range(s, 0, LN_TOUCH_MAX_Y) << 8;
+    c->vx = ln_touch_range(s, -800, 800);
+    c->vy = ln_touch_range(s, -800, 800);
+    c->ax = ln_touch_range(s, -2000, 2000);
+    c->ay = ln_touch_range(s, -2000, 2000);
+    c->pressure = ln_touch_range(s, 30, 80);
+    c->ttl_us = ln_touch_range(s, 200000, 1500000);
+}
+
+/*
+ * Avança um quadro de 1/rate_hz s: move, solta os contatos vencidos e
+ * talvez cria um novo, até max_contacts simultâneos. Retorna quantos
+ * contatos ficaram ativos.
+ */
+static inline unsigned int ln_touch_sim_step(struct ln_touch_sim *s, unsigned int rate_hz,
+                                             unsigned int max_contacts)
+{
+    u32 dt_us = 1000000 / rate_hz;
+    unsigned int i, active = 0;
+    int free_slot = -1;
+
+    for (i = 0; i < LN_TOUCH_MAX_CONTACTS; i++) {
+        struct ln_touch_contact *c = &s->c[i];
+
+        if (c->active && c->ttl_us <= dt_us)
+            c->active = false;
+        if (!c->active) {
+            if (free_slot < 0)
+                free_slot = i;
+            continue;
+        }
+
+        c->ttl_us -= dt_us;
+        c->vx += c->ax / (s32)rate_hz;
+        c->vy += c->ay / (s32)rate_hz;
+        c->x += div_s64((s64)c->vx << 8, rate_hz);
+        c->y += div_s64((s64)c->vy << 8, rate_hz);
+        ln_touch_bounce(&c->x, &c->vx, LN_TOUCH_MAX_X);
+        ln_touch_bounce(&c->y, &c->vy, LN_TOUCH_MAX_Y);
+
+        c->pressure += ln_touch_range(s, -2, 2);
+        if (c->pressure < 10)
+            c->pressure = 10;
+        else if (c->pressure > 100)
+            c->pressure = 100;
+        active++;
+    }
+
+    if (free_slot >= 0 && active < max_contacts &&
+        ln_touch_rand(s) < 0xffffffffU / rate_hz * LN_TOUCH_SPAWN_HZ) {
+        ln_touch_spawn(s, &s->c[free_slot]);
+        active++;
+    }
+    return active;
+}
+
+/*
+ * Traço gravado (.lntt, little-endian): cabeçalho e count registros, cada
+ * um com o estado completo de um slot num instante. Registros com o mesmo
+ * t_us formam um quadro (um SYN_REPORT). duration_us é o período de uma
+ * volta no modo loop e permite uma pausa após o último quadro.
+ */
+#define LN_TOUCH_TRACE_MAGIC   0x54544e4c      /* "LNTT" */
+#define LN_TOUCH_TRACE_VERSION 1
+#define LN_TOUCH_REC_DOWN      0x01            /* dedo no slot; sem ele, soltou */
+
+struct ln_touch_trace_hdr {
+    __le32 magic;
+    __le16 version;
+    __le16 rec_size;        /* sizeof(struct ln_touch_trace_rec) */
+    __le32 count;
+    __le32 duration_us;
+};
+
+struct ln_touch_trace_rec {
+    __le32 t_us;            /* desde o início do traço, não decrescente */
+    u8 slot;
+    u8 flags;
+    __le16 x, y;
+    __le16 pressure;
+};
+
+struct ln_touch_replay {
+    const struct ln_touch_trace_rec *rec;
+    u32 count;
+    u32 duration_us;
+    u32 pos;                /* primeiro registro do próximo quadro */
+    u32 loops;              /* voltas completas */
+};
+
+/* Valida o traço inteiro antes de usá-lo; 0 ou -EINVAL */
+static inline int ln_touch_trace_parse(const void *data, size_t size, struct ln_touch_replay *r)
+{
+    const struct ln_touch_trace_hdr *h = data;
+    const struct ln_touch_trace_rec *rec;
+    u32 count, duration, i, prev = 0;
+
+    if (size < sizeof(*h) || le32_to_cpu(h->magic) != LN_TOUCH_TRACE_MAGIC ||
+        le16_to_cpu(h->version) != LN_TOUCH_TRACE_VERSION ||
+        le16_to_cpu(h->rec_size) != sizeof(*rec))
+        return -EINVAL;
+
+    count = le32_to_cpu(h->count);
+    if (!count || size - sizeof(*h) != (size_t)count * sizeof(*rec))
+        return -EINVAL;
+
+    rec = (const struct ln_touch_trace_rec *)(h + 1);
+    for (i = 0; i < count; i++) {
+        u32 t = le32_to_cpu(rec[i].t_us);
+
+        if (t < prev || rec[i].slot >= LN_TOUCH_MAX_CONTACTS ||
+            (rec[i].flags & ~LN_TOUCH_REC_DOWN) ||
+            le16_to_cpu(rec[i].x) > LN_TOUCH_MAX_X || le16_to_cpu(rec[i].y) > LN_TOUCH_MAX_Y ||
+            le16_to_cpu(rec[i].pressure) > LN_TOUCH_MAX_PRESSURE)
+            return -EINVAL;
+        prev = t;
+    }
+
+    /* duration 0 faria o loop girar sem avançar o relógio */
+    duration = le32_to_cpu(h->duration_us);
+    if (!duration || duration < prev)
+        return -EINVAL;
+
+    memset(r, 0, sizeof(*r));
+    r->rec = rec;
+    r->count = count;
+    r->duration_us = duration;
+    return 0;
+}
+
+static inline bool ln_touch_replay_done(const struct ln_touch_replay *r)
+{
+    return r->pos >= r->count;
+}
+
+/* Instante do próximo quadro em µs de traço, somando as voltas */
+static inline u64 ln_touch_replay_next_us(const struct ln_touch_replay *r)
+{
+    return (u64)r->loops * r->duration_us + le32_to_cpu(r->rec[r->pos].t_us);
+}
+
+/*
+ * Aplica o próximo quadro aos contatos. No fim do traço volta ao início
+ * se loop, senão ln_touch_replay_done() passa a valer.
+ */
+static inline void ln_touch_replay_frame(struct ln_touch_replay *r, struct ln_touch_contact *c,
+                                         bool loop)
+{
+    u32 t = le32_to_cpu(r->rec[r->pos].t_us);
+
+    do {
+        const struct ln_touch_trace_rec *e = &r->rec[r->pos];
+        struct ln_touch_contact *k = &c[e->slot];
+
+        k->active = e->flags & LN_TOUCH_REC_DOWN;
+        k->x = le16_to_cpu(e->x) << 8;
+        k->y = le16_to_cpu(e->y) << 8;
+        k->pressure = le16_to_cpu(e->pressure);
+    } while (++r->pos < r->count && le32_to_cpu(r->rec[r->pos].t_us) == t);
+
+    if (ln_touch_replay_done(r) && loop) {
+        r->pos = 0;
+        r->loops++;
+    }
+}
+
+#endif /* LN_TOUCH_CORE_H */
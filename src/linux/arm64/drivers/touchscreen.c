@@ -1,10 +1,29 @@
-// SPDX-License-Identifier: Apache-2.0
+// SPDX-License-Identifier: GPL-2.0 OR MIT
 /*
  * touchscreen.c — ARM64 Touchscreen Driver (Simulated)
  *
  * Este módulo representa um driver de touchscreen para o Linus Neural Project.
  * Ele emula eventos de toque, arrasto e liberação, com suporte a multitouch.
  *
+ * Um hrtimer gera quadros a rate_hz (120–480 Hz, parâmetro do módulo
+ * ajustável em /sys/module/touchscreen/parameters/) no protocolo
+ * multitouch tipo B: até LN_TOUCH_MAX_CONTACTS slots, cada um com
+ * tracking ID próprio e trajetória suave (touch_core.h). Nenhum printk
+ * por evento: o caminho aguenta a taxa de um painel real.
+ *
+ * Replay de traços gravados (.lntt, formato em touch_core.h): o nome do
+ * arquivo em /lib/firmware é escrito no atributo sysfs "replay" do
+ * dispositivo de entrada (ou passado em trace= na carga) e carregado com
+ * request_firmware. O hrtimer passa a disparar em tempo absoluto em cada
+ * quadro do traço, com loop e velocidade ajustáveis; o atraso de cada
+ * quadro em relação ao instante previsto fica em "replay", para separar o
+ * erro do gerador da latência do pipeline de entrada. "stop" volta à
+ * simulação.
+ *
+ * Com timestamp=1 cada quadro leva MSC_TIMESTAMP com o instante em que foi
+ * gerado (µs de CLOCK_MONOTONIC, 32 bits), para que lnp_inputlat
+ * (src/drivers/user) meça a latência de geração até a leitura em evdev.
+ *
  * Copyright (c) 2025 Linus Neural Project
  */
 
@@ -12,49 +31,399 @@
 #include <linux/kernel.h>
 #include <linux/init.h>
 #include <linux/input.h>
-#include <linux/timer.h>
+#include <linux/input/mt.h>
+#include <linux/hrtimer.h>
+#include <linux/ktime.h>
+#include <linux/moduleparam.h>
+#include <linux/firmware.h>
+#include <linux/mutex.h>
+#include <linux/spinlock.h>
+#include <linux/string.h>
 #include <linux/random.h>
 #include <linux/slab.h>
+#include <linux/version.h>
+
+#include "touch_core.h"
 
 #define DRIVER_NAME "ln_touchscreen"
 #define PROJECT_TAG "Linus Neural Project"
 
+enum ln_touch_mode {
+    LN_TOUCH_MODE_SIM,      /* trajetórias aleatórias a rate_hz */
+    LN_TOUCH_MODE_REPLAY,   /* traço em andamento */
+    LN_TOUCH_MODE_DONE,     /* traço terminou sem loop; timer parado */
+};
+
+/* Atraso de cada quadro do replay; hist[i] conta atrasos < 2^i µs, o último é o resto */
+#define LN_TOUCH_JITTER_BUCKETS 16
+#define LN_TOUCH_CATCHUP_MAX    64
+
+struct ln_touch_jitter {
+    u64 count;
+    u64 sum_ns;
+    u64 min_ns, max_ns;
+    u32 hist[LN_TOUCH_JITTER_BUCKETS];
+};
+
 struct ln_touchscreen {
     struct input_dev *input;
-    struct timer_list event_timer;
-    bool active;
-    int x, y;
-    int pressure;
+    struct hrtimer event_timer;
+    struct ln_touch_sim sim;
+    u64 frames;
+    u64 missed;             /* quadros pulados por atraso do timer */
+
+    enum ln_touch_mode mode;
+    const struct firmware *fw;
+    struct ln_touch_replay replay;
+    char trace_name[64];
+    ktime_t next;           /* instante previsto do próximo quadro */
+    ktime_t base;           /* relógio correspondente a base_us no traço */
+    u64 base_us;
+    unsigned int speed;     /* replay_speed_pct em vigor desde base */
+    spinlock_t stats_lock;
+    struct ln_touch_jitter jitter;
+    bool stopping;          /* módulo saindo: sysfs não religa o timer */
 };
 
 static struct ln_touchscreen *ts_dev;
+static DEFINE_MUTEX(ln_touch_replay_lock);
 
-/* Simula geração de coordenadas aleatórias */
-static void ln_touch_event(struct timer_list *t)
+static unsigned int rate_hz = LN_TOUCH_RATE_MIN;
+static unsigned int max_contacts = LN_TOUCH_MAX_CONTACTS;
+
+/* Aceita só valores dentro de [min, max]; o timer lê o valor a cada quadro */
+static int ln_touch_param_set(const char *val, const struct kernel_param *kp,
+                              unsigned int min, unsigned int max)
 {
-    struct ln_touchscreen *ts = from_timer(ts, t, event_timer);
-    int new_x, new_y, new_pressure;
+    unsigned int v;
+    int ret = kstrtouint(val, 0, &v);
+
+    if (ret)
+        return ret;
+    if (v < min || v > max)
+        return -EINVAL;
+    return param_set_uint(val, kp);
+}
+
+static int ln_touch_rate_set(const char *val, const struct kernel_param *kp)
+{
+    return ln_touch_param_set(val, kp, LN_TOUCH_RATE_MIN, LN_TOUCH_RATE_MAX);
+}
+
+static int ln_touch_speed_set(const char *val, const struct kernel_param *kp)
+{
+    return ln_touch_param_set(val, kp, 10, 1000);
+}
+
+static int ln_touch_contacts_set(const char *val, const struct kernel_param *kp)
+{
+    return ln_touch_param_set(val, kp, 1, LN_TOUCH_MAX_CONTACTS);
+}
+
+static const struct kernel_param_ops ln_touch_rate_ops = {
+    .set = ln_touch_rate_set,
+    .get = param_get_uint,
+};
+
+static const struct kernel_param_ops ln_touch_contacts_ops = {
+    .set = ln_touch_contacts_set,
+    .get = param_get_uint,
+};
+
+static const struct kernel_param_ops ln_touch_speed_ops = {
+    .set = ln_touch_speed_set,
+    .get = param_get_uint,
+};
 
-    get_random_bytes(&new_x, sizeof(new_x));
-    get_random_bytes(&new_y, sizeof(new_y));
-    get_random_bytes(&new_pressure, sizeof(new_pressure));
+module_param_cb(rate_hz, &ln_touch_rate_ops, &rate_hz, 0644);
+MODULE_PARM_DESC(rate_hz, "Taxa de quadros em Hz (120-480, padrão 120)");
+module_param_cb(max_contacts, &ln_touch_contacts_ops, &max_contacts, 0644);
+MODULE_PARM_DESC(max_contacts, "Toques simultâneos (1-10, padrão 10)");
 
-    ts->x = abs(new_x % 1080);
-    ts->y = abs(new_y % 2400);
-    ts->pressure = abs(new_pressure % 100);
+static char *trace;
+module_param(trace, charp, 0444);
+MODULE_PARM_DESC(trace, "Traço .lntt em /lib/firmware reproduzido desde a carga");
 
-    input_report_abs(ts->input, ABS_MT_POSITION_X, ts->x);
-    input_report_abs(ts->input, ABS_MT_POSITION_Y, ts->y);
-    input_report_abs(ts->input, ABS_MT_PRESSURE, ts->pressure);
-    input_mt_sync(ts->input);
+static bool replay_loop;
+module_param(replay_loop, bool, 0644);
+MODULE_PARM_DESC(replay_loop, "Recomeça o traço ao terminar (padrão 0)");
+
+static unsigned int replay_speed_pct = 100;
+module_param_cb(replay_speed_pct, &ln_touch_speed_ops, &replay_speed_pct, 0644);
+MODULE_PARM_DESC(replay_speed_pct, "Velocidade do replay em % (10-1000, padrão 100)");
+
+static bool timestamp;
+module_param(timestamp, bool, 0644);
+MODULE_PARM_DESC(timestamp, "Envia MSC_TIMESTAMP com o instante de geração de cada quadro (padrão 0)");
+
+/* Reporta o quadro atual, gerado em gen: um slot por contato, tipo B */
+static void ln_touch_report(struct ln_touchscreen *ts, ktime_t gen)
+{
+    unsigned int i;
+
+    for (i = 0; i < LN_TOUCH_MAX_CONTACTS; i++) {
+        const struct ln_touch_contact *c = &ts->sim.c[i];
+
+        input_mt_slot(ts->input, i);
+        input_mt_report_slot_state(ts->input, MT_TOOL_FINGER, c->active);
+        if (!c->active)
+            continue;
+        input_report_abs(ts->input, ABS_MT_POSITION_X, c->x >> 8);
+        input_report_abs(ts->input, ABS_MT_POSITION_Y, c->y >> 8);
+        input_report_abs(ts->input, ABS_MT_PRESSURE, c->pressure);
+    }
+    input_mt_sync_frame(ts->input);
+    /* truncado a 32 bits como em painéis reais; quem lê compara módulo 2^32 */
+    if (READ_ONCE(timestamp))
+        input_event(ts->input, EV_MSC, MSC_TIMESTAMP,
+                    (u32)div_u64(ktime_to_ns(gen), NSEC_PER_USEC));
     input_sync(ts->input);
+}
+
+/* Um quadro por período; atrasos não são repostos, só contados */
+static enum hrtimer_restart ln_touch_event(struct ln_touchscreen *ts, struct hrtimer *t)
+{
+    unsigned int hz = READ_ONCE(rate_hz);
+    ktime_t now = ktime_get();
+    u64 periods;
+
+    ln_touch_sim_step(&ts->sim, hz, READ_ONCE(max_contacts));
+    ln_touch_report(ts, now);
+    ts->frames++;
+
+    periods = hrtimer_forward_now(t, ns_to_ktime(NSEC_PER_SEC / hz));
+    if (periods > 1)
+        ts->missed += periods - 1;
+    return HRTIMER_RESTART;
+}
+
+/* Solta todos os dedos num quadro próprio; chamado com o timer parado ou no callback */
+static void ln_touch_lift_all(struct ln_touchscreen *ts)
+{
+    unsigned int i;
+
+    for (i = 0; i < LN_TOUCH_MAX_CONTACTS; i++)
+        ts->sim.c[i].active = false;
+    ln_touch_report(ts, ktime_get());
+}
+
+static void ln_touch_jitter_add(struct ln_touch_jitter *j, s64 late_ns)
+{
+    u64 ns = late_ns > 0 ? late_ns : 0;
+    unsigned int b = 0;
+    u64 us = div_u64(ns, NSEC_PER_USEC);
+
+    while (b < LN_TOUCH_JITTER_BUCKETS - 1 && us >= (1ULL << b))
+        b++;
+    j->hist[b]++;
+    if (!j->count || ns < j->min_ns)
+        j->min_ns = ns;
+    if (ns > j->max_ns)
+        j->max_ns = ns;
+    j->sum_ns += ns;
+    j->count++;
+}
+
+/* Instante do relógio para um tempo de traço, na velocidade em vigor */
+static ktime_t ln_touch_replay_when(struct ln_touchscreen *ts, u64 trace_us)
+{
+    return ktime_add_ns(ts->base, div_u64((trace_us - ts->base_us) * NSEC_PER_USEC * 100,
+                                          ts->speed));
+}
+
+/*
+ * Emite todos os quadros cujo instante já passou (no máximo
+ * LN_TOUCH_CATCHUP_MAX por disparo) e agenda o seguinte em tempo
+ * absoluto. Mudanças de replay_speed_pct valem a partir do quadro atual.
+ */
+static enum hrtimer_restart ln_touch_replay_event(struct ln_touchscreen *ts, struct hrtimer *t)
+{
+    ktime_t now = ktime_get();
+    unsigned int n = 0, speed;
+    u64 at_us;
+
+    do {
+        at_us = ln_touch_replay_next_us(&ts->replay);
+        spin_lock(&ts->stats_lock);
+        ln_touch_jitter_add(&ts->jitter, ktime_to_ns(ktime_sub(now, ts->next)));
+        spin_unlock(&ts->stats_lock);
 
-    pr_info("[%s] Toque detectado em (%d, %d) pressão=%d\n",
-            PROJECT_TAG, ts->x, ts->y, ts->pressure);
+        ln_touch_replay_frame(&ts->replay, ts->sim.c, READ_ONCE(replay_loop));
+        ln_touch_report(ts, now);
+        ts->frames++;
 
-    /* Reagenda o próximo evento simulado */
-    mod_timer(&ts->event_timer, jiffies + msecs_to_jiffies(1000));
+        if (ln_touch_replay_done(&ts->replay)) {
+            ln_touch_lift_all(ts);
+            WRITE_ONCE(ts->mode, LN_TOUCH_MODE_DONE);
+            return HRTIMER_NORESTART;
+        }
+
+        speed = READ_ONCE(replay_speed_pct);
+        if (speed != ts->speed) {
+            ts->base = ts->next;
+            ts->base_us = at_us;
+            ts->speed = speed;
+        }
+        ts->next = ln_touch_replay_when(ts, ln_touch_replay_next_us(&ts->replay));
+    } while (ktime_compare(ts->next, now) <= 0 && ++n < LN_TOUCH_CATCHUP_MAX);
+
+    hrtimer_set_expires(t, ts->next);
+    return HRTIMER_RESTART;
+}
+
+static enum hrtimer_restart ln_touch_timer_fn(struct hrtimer *t)
+{
+    struct ln_touchscreen *ts = container_of(t, struct ln_touchscreen, event_timer);
+
+    if (ts->mode == LN_TOUCH_MODE_REPLAY)
+        return ln_touch_replay_event(ts, t);
+    return ln_touch_event(ts, t);
+}
+
+static void ln_touch_start_sim(struct ln_touchscreen *ts)
+{
+    ts->mode = LN_TOUCH_MODE_SIM;
+    hrtimer_start(&ts->event_timer, ns_to_ktime(NSEC_PER_SEC / READ_ONCE(rate_hz)),
+                  HRTIMER_MODE_REL);
+}
+
+/* Troca o traço em uso; o atual continua se o novo não carregar ou for inválido */
+static int ln_touch_replay_start(struct ln_touchscreen *ts, const char *name)
+{
+    const struct firmware *fw;
+    struct ln_touch_replay r;
+    int ret;
+
+    ret = request_firmware(&fw, name, &ts->input->dev);
+    if (ret)
+        return ret;
+
+    ret = ln_touch_trace_parse(fw->data, fw->size, &r);
+    if (ret) {
+        pr_warn("[%s] Traço %s inválido\n", PROJECT_TAG, name);
+        release_firmware(fw);
+        return ret;
+    }
+
+    hrtimer_cancel(&ts->event_timer);
+    ln_touch_lift_all(ts);
+    release_firmware(ts->fw);
+    ts->fw = fw;
+    ts->replay = r;
+    strscpy(ts->trace_name, name, sizeof(ts->trace_name));
+
+    spin_lock_irq(&ts->stats_lock);
+    memset(&ts->jitter, 0, sizeof(ts->jitter));
+    spin_unlock_irq(&ts->stats_lock);
+
+    ts->speed = READ_ONCE(replay_speed_pct);
+    ts->base = ktime_get();
+    ts->base_us = 0;
+    ts->next = ln_touch_replay_when(ts, ln_touch_replay_next_us(&ts->replay));
+    ts->mode = LN_TOUCH_MODE_REPLAY;
+    hrtimer_start(&ts->event_timer, ts->next, HRTIMER_MODE_ABS);
+
+    pr_info("[%s] Replay de %s: %u registros, %u µs por volta\n",
+            PROJECT_TAG, name, r.count, r.duration_us);
+    return 0;
+}
+
+static void ln_touch_replay_stop(struct ln_touchscreen *ts)
+{
+    if (ts->mode == LN_TOUCH_MODE_SIM)
+        return;
+    hrtimer_cancel(&ts->event_timer);
+    ln_touch_lift_all(ts);
+    release_firmware(ts->fw);
+    ts->fw = NULL;
+    ln_touch_start_sim(ts);
+}
+
+/* Percentil aproximado pelo limite superior do balde do histograma, em µs */
+static unsigned int ln_touch_jitter_pct_us(const struct ln_touch_jitter *j, unsigned int per_mille)
+{
+    u64 want = div_u64(j->count * per_mille + 999, 1000), seen = 0;
+    unsigned int b;
+
+    for (b = 0; b < LN_TOUCH_JITTER_BUCKETS; b++) {
+        seen += j->hist[b];
+        if (seen >= want)
+            return 1U << b;
+    }
+    return 1U << (LN_TOUCH_JITTER_BUCKETS - 1);
+}
+
+/* sysfs "replay": estado do replay e atraso dos quadros em relação ao previsto */
+static ssize_t replay_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    static const char * const state[] = { "off", "playing", "done" };
+    struct ln_touchscreen *ts = ts_dev;
+    struct ln_touch_jitter j;
+    unsigned int b;
+    int len;
+
+    spin_lock_irq(&ts->stats_lock);
+    j = ts->jitter;
+    spin_unlock_irq(&ts->stats_lock);
+
+    mutex_lock(&ln_touch_replay_lock);
+    len = scnprintf(buf, PAGE_SIZE,
+                    "state %s\ntrace %s\nloop %d\nspeed_pct %u\nloops %u\nframes %llu\n"
+                    "jitter_min_ns %llu\njitter_mean_ns %llu\njitter_max_ns %llu\n"
+                    "jitter_p50_us %u\njitter_p99_us %u\njitter_p999_us %u\njitter_hist_us",
+                    state[READ_ONCE(ts->mode)], ts->fw ? ts->trace_name : "-",
+                    READ_ONCE(replay_loop), READ_ONCE(replay_speed_pct), READ_ONCE(ts->replay.loops),
+                    j.count, j.min_ns, j.count ? div64_u64(j.sum_ns, j.count) : 0, j.max_ns,
+                    ln_touch_jitter_pct_us(&j, 500), ln_touch_jitter_pct_us(&j, 990),
+                    ln_touch_jitter_pct_us(&j, 999));
+    mutex_unlock(&ln_touch_replay_lock);
+
+    for (b = 0; b < LN_TOUCH_JITTER_BUCKETS; b++)
+        len += scnprintf(buf + len, PAGE_SIZE - len, " %u", j.hist[b]);
+    len += scnprintf(buf + len, PAGE_SIZE - len, "\n");
+    return len;
+}
+
+/* Escrever um nome de firmware inicia o replay; "stop" volta à simulação */
+static ssize_t replay_store(struct device *dev, struct device_attribute *attr,
+                            const char *buf, size_t len)
+{
+    char name[sizeof(ts_dev->trace_name)];
+    int ret = 0;
+
+    if (len >= sizeof(name))
+        return -ENAMETOOLONG;
+    strscpy(name, buf, sizeof(name));
+    strim(name);
+    if (!name[0])
+        return -EINVAL;
+
+    mutex_lock(&ln_touch_replay_lock);
+    if (ts_dev->stopping)
+        ret = -ENODEV;
+    else if (!strcmp(name, "stop"))
+        ln_touch_replay_stop(ts_dev);
+    else
+        ret = ln_touch_replay_start(ts_dev, name);
+    mutex_unlock(&ln_touch_replay_lock);
+
+    return ret ? ret : len;
 }
+static DEVICE_ATTR_RW(replay);
+
+static struct attribute *ln_touch_attrs[] = {
+    &dev_attr_replay.attr,
+    NULL,
+};
+
+static const struct attribute_group ln_touch_attr_group = {
+    .attrs = ln_touch_attrs,
+};
+
+static const struct attribute_group *ln_touch_attr_groups[] = {
+    &ln_touch_attr_group,
+    NULL,
+};
 
 static int __init ln_touch_init(void)
 {
@@ -66,6 +435,16 @@ static int __init ln_touch_init(void)
     if (!ts_dev)
         return -ENOMEM;
 
+    /* tudo que "replay" usa fica pronto antes de o atributo existir */
+    spin_lock_init(&ts_dev->stats_lock);
+    ln_touch_sim_init(&ts_dev->sim);
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 13, 0)
+    hrtimer_setup(&ts_dev->event_timer, ln_touch_timer_fn, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+#else
+    hrtimer_init(&ts_dev->event_timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+    ts_dev->event_timer.function = ln_touch_timer_fn;
+#endif
+
     ts_dev->input = input_allocate_device();
     if (!ts_dev->input) {
         kfree(ts_dev);
@@ -78,14 +457,22 @@ static int __init ln_touch_init(void)
     ts_dev->input->id.vendor  = 0x2025;
     ts_dev->input->id.product = 0x0001;
     ts_dev->input->id.version = 0x0001;
+    /* criado pelo device_add de input_register_device, sem janela sem atributo */
+    ts_dev->input->dev.groups = ln_touch_attr_groups;
 
-    input_set_capability(ts_dev->input, EV_ABS, ABS_MT_POSITION_X);
-    input_set_capability(ts_dev->input, EV_ABS, ABS_MT_POSITION_Y);
-    input_set_capability(ts_dev->input, EV_ABS, ABS_MT_PRESSURE);
+    input_set_abs_params(ts_dev->input, ABS_MT_POSITION_X, 0, LN_TOUCH_MAX_X, 0, 0);
+    input_set_abs_params(ts_dev->input, ABS_MT_POSITION_Y, 0, LN_TOUCH_MAX_Y, 0, 0);
+    input_set_abs_params(ts_dev->input, ABS_MT_PRESSURE, 0, LN_TOUCH_MAX_PRESSURE, 0, 0);
 
-    input_set_abs_params(ts_dev->input, ABS_MT_POSITION_X, 0, 1080, 0, 0);
-    input_set_abs_params(ts_dev->input, ABS_MT_POSITION_Y, 0, 2400, 0, 0);
-    input_set_abs_params(ts_dev->input, ABS_MT_PRESSURE, 0, 255, 0, 0);
+    input_set_capability(ts_dev->input, EV_MSC, MSC_TIMESTAMP);
+
+    /* slots tipo B; INPUT_MT_DIRECT também gera BTN_TOUCH e ABS_X/Y de compatibilidade */
+    ret = input_mt_init_slots(ts_dev->input, LN_TOUCH_MAX_CONTACTS, INPUT_MT_DIRECT);
+    if (ret) {
+        input_free_device(ts_dev->input);
+        kfree(ts_dev);
+        return ret;
+    }
 
     ret = input_register_device(ts_dev->input);
     if (ret) {
@@ -94,17 +481,31 @@ static int __init ln_touch_init(void)
         return ret;
     }
 
-    timer_setup(&ts_dev->event_timer, ln_touch_event, 0);
-    mod_timer(&ts_dev->event_timer, jiffies + msecs_to_jiffies(1000));
+    /* uma escrita em "replay" logo após o registro espera a simulação começar */
+    mutex_lock(&ln_touch_replay_lock);
+    ln_touch_start_sim(ts_dev);
+    if (trace && trace[0]) {
+        ret = ln_touch_replay_start(ts_dev, trace);
+        if (ret)
+            pr_warn("[%s] Traço %s não carregado (%d), mantendo simulação\n",
+                    PROJECT_TAG, trace, ret);
+    }
+    mutex_unlock(&ln_touch_replay_lock);
 
-    pr_info("[%s] Touchscreen driver inicializado com sucesso!\n", PROJECT_TAG);
+    pr_info("[%s] Touchscreen driver inicializado com sucesso! (%u Hz, até %u toques)\n",
+            PROJECT_TAG, rate_hz, max_contacts);
     return 0;
 }
 
 static void __exit ln_touch_exit(void)
 {
     pr_info("[%s] Finalizando driver touchscreen...\n", PROJECT_TAG);
-    del_timer_sync(&ts_dev->event_timer);
+    mutex_lock(&ln_touch_replay_lock);
+    ts_dev->stopping = true;
+    hrtimer_cancel(&ts_dev->event_timer);
+    mutex_unlock(&ln_touch_replay_lock);
+    release_firmware(ts_dev->fw);
+    pr_info("[%s] %llu quadros gerados, %llu perdidos\n", PROJECT_TAG, ts_dev->frames, ts_dev->missed);
     input_unregister_device(ts_dev->input);
     kfree(ts_dev);
     pr_info("[%s] Touchscreen finalizado.\n", PROJECT_TAG);
@@ -113,7 +514,8 @@ static void __exit ln_touch_exit(void)
 module_init(ln_touch_init);
 module_exit(ln_touch_exit);
 
-MODULE_LICENSE("Apache-2.0");
+/* hrtimer_setup/hrtimer_start_range_ns só são exportados para módulos GPL */
+MODULE_LICENSE("Dual MIT/GPL");
 MODULE_AUTHOR("Linus Neural Project");
 MODULE_DESCRIPTION("Driver de touchscreen ARM64 (simulado)");
-MODULE_VERSION("0.1");
+MODULE_VERSION("0.4");